@@ -0,0 +1,55 @@
+#include <cstddef>      // size_t
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+
+
+
+
+namespace
+{
+  // Applications per second through makeApplication() with the application log syncing every write, as it did before group
+  // commit, against group commit and deferred syncing, by the number of seekers applying at once
+  void applyThroughput( const std::vector<std::string> & arguments )
+  {
+    auto threadCounts = Benchmarks::counts( arguments, 0, { 1, 4, 16 } );
+
+    struct Quiet
+    {
+      std::streambuf * log = std::clog.rdbuf( nullptr );
+      ~Quiet() { std::clog.rdbuf( log ); }
+    } quiet;
+
+    std::cout << std::setw( 16 ) << "sync" << std::setw( 10 ) << "threads" << std::setw( 16 ) << "applies/s" << std::setw( 10 ) << "speedup" << '\n';
+    for( auto threads : threadCounts )
+    {
+      double everyWrite = 0;
+      for( const char * policy : { "Every Write", "Group Commit", "Deferred" } )
+      {
+        // A fresh log each time, so none is replayed and each policy starts from an empty file
+        Benchmarks::ScratchDirectory directory( "apply-benchmark" );
+        directory.writeAdaptationData( { { "Component.SearchIndex", "Trigram Index" }, { "Persistence.ApplicationLog", "applications.log" },
+                                         { "Persistence.ApplicationLogSync", policy } } );
+
+        double rate = 0;
+        {
+          TechnicalServices::Persistence::SimpleDB database;
+
+          std::vector<int> jobs( threads, 0 );    // each thread applies as its own seeker, for one job after another
+          rate = Benchmarks::callsPerSecond( threads, [&]( std::size_t thread ) { database.makeApplication( "seeker" + std::to_string( thread ), ++jobs[thread] ); } );
+        }
+        if( std::string( policy ) == "Every Write" ) everyWrite = rate;    // the first, what the others are measured against
+
+        std::cout << std::setw( 16 ) << policy << std::setw( 10 ) << threads << std::setw( 16 ) << std::fixed << std::setprecision( 0 ) << rate << std::setw( 10 )
+                  << std::setprecision( 2 ) << rate / everyWrite << '\n';
+      }
+    }
+  }
+
+  Benchmarks::Registration apply( "apply", "[threads ...]  makeApplication()s per second per application log sync policy, by concurrent applicants (default 1 4 16)", applyThroughput );
+}    // namespace
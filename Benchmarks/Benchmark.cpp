@@ -0,0 +1,209 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include <algorithm>    // sort()
+#include <chrono>
+#include <cstddef>      // size_t
+#include <atomic>
+#include <cstdint>      // uint64_t
+#include <filesystem>   // create_directories(), current_path(), remove_all(), temp_directory_path()
+#include <fstream>
+#include <functional>   // function
+#include <iterator>     // size()
+#include <stdexcept>    // invalid_argument
+#include <string>
+#include <system_error> // error_code
+#include <thread>       // jthread
+#include <utility>      // move(), pair
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace Benchmarks
+{
+  namespace
+  {
+    std::vector<Benchmark> & registry()
+    {
+      static std::vector<Benchmark> benchmarks;    // constructed on first use, so registrations in any translation unit may use it
+      return benchmarks;
+    }
+
+
+    // SplitMix64, a cheap well mixed hash of a position, so each job is made up the same way wherever it's asked for
+    std::uint64_t mix( std::uint64_t value )
+    {
+      value += 0x9E3779B97F4A7C15;
+      value  = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9;
+      value  = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EB;
+      return value ^ ( value >> 31 );
+    }
+
+
+    // The index-th word of a vocabulary of vocabularySize, letters only and all of the same length
+    std::string word( std::size_t index, std::size_t vocabularySize )
+    {
+      static const char * const syllables[] = { "ba", "ce", "di", "fo", "gu", "ha", "ke", "li", "mo", "nu",
+                                                "pa", "re", "si", "to", "vu", "wa", "xe", "yi", "zo", "lu" };
+      constexpr std::size_t base = std::size( syllables );
+
+      std::string text;
+      for( std::size_t remaining = vocabularySize; remaining != 0; remaining /= base, index /= base ) text.insert( 0, syllables[index % base] );
+      text.front() = static_cast<char>( text.front() - 'a' + 'A' );
+      return text;
+    }
+
+
+    thread_local volatile std::uint64_t kept = 0;    // per thread, so concurrent benchmarks neither race nor share a cache line
+  }    // namespace
+
+
+
+
+  Registration::Registration( std::string name, std::string usage, std::function<void( const std::vector<std::string> & )> run )
+  {
+    registry().push_back( { std::move( name ), std::move( usage ), std::move( run ) } );
+  }
+
+
+  const std::vector<Benchmark> & registered()
+  {
+    auto & benchmarks = registry();
+    std::sort( benchmarks.begin(), benchmarks.end(), []( const Benchmark & lhs, const Benchmark & rhs ) { return lhs.name < rhs.name; } );
+    return benchmarks;
+  }
+
+
+
+
+  std::size_t count( const std::vector<std::string> & arguments, std::size_t index, std::size_t otherwise )
+  {
+    if( index >= arguments.size() ) return otherwise;
+
+    std::size_t parsed = 0;
+    auto        value  = std::stoul( arguments[index], &parsed );
+    if( parsed != arguments[index].size() ) throw std::invalid_argument( "\"" + arguments[index] + "\" isn't a count" );
+    return value;
+  }
+
+
+  std::vector<std::size_t> counts( const std::vector<std::string> & arguments, std::size_t index, std::vector<std::size_t> otherwise )
+  {
+    if( index >= arguments.size() ) return otherwise;
+
+    std::vector<std::size_t> values;
+    for( ; index != arguments.size(); ++index ) values.push_back( count( arguments, index, 0 ) );
+    return values;
+  }
+
+
+
+
+  std::vector<TechnicalServices::Persistence::JobInfo> syntheticJobs( std::size_t first, std::size_t count, std::size_t catalogSize )
+  {
+    static const char * const kinds[]      = { "Cafe", "Grill", "Market", "Bakery", "Clinic", "Books", "Motors", "Studio" };
+    static const char * const locations[]  = { "Fullerton", "Anaheim", "Brea", "Placentia", "Buena Park", "Orange", "Santa Ana", "Irvine", "Long Beach", "Los Angeles" };
+    static const char * const categories[] = { "Server", "Barista", "Chef", "Cashier", "Driver", "Clerk", "Tutor", "Nurse" };
+    static const char * const types[]      = { "Full time", "Part time", "Seasonal" };
+
+    auto vocabularySize = catalogSize / 10 + 1;
+
+    std::vector<TechnicalServices::Persistence::JobInfo> jobs;
+    jobs.reserve( count );
+    for( auto position = first; position != first + count; ++position )
+    {
+      auto hash = mix( position );
+      auto pick = [&]( const auto & list ) { hash = mix( hash ); return list[hash % std::size( list )]; };
+
+      TechnicalServices::Persistence::JobInfo job;
+      job.id            = static_cast<int>( position + 1 );
+      job.name          = word( hash % vocabularySize, vocabularySize ) + ' ' + pick( kinds );
+      job.location      = pick( locations );
+      job.category      = pick( categories );
+      job.type          = pick( types );
+      job.description   = "Descrption about " + job.category + " at " + job.name;
+      job.qualification = "over " + std::to_string( 16 + hash % 10 );
+      job.salary        = std::to_string( 15 + hash % 40 ) + "$ / hour";
+      jobs.push_back( std::move( job ) );
+    }
+    return jobs;
+  }
+
+
+
+
+  std::chrono::duration<double, std::micro> timePerCall( const std::function<void()> & work, std::chrono::milliseconds atLeast )
+  {
+    auto        start = std::chrono::steady_clock::now();
+    auto        now   = start;
+    std::size_t calls = 0;
+    do
+    {
+      work();
+      ++calls;
+      now = std::chrono::steady_clock::now();
+    } while( now - start < atLeast );
+
+    return std::chrono::duration<double, std::micro>( now - start ) / static_cast<double>( calls );
+  }
+
+
+  double callsPerSecond( std::size_t threads, const std::function<void( std::size_t thread )> & work, std::chrono::milliseconds duration )
+  {
+    std::atomic<bool>          stop = false;
+    std::vector<std::size_t>   calls( threads, 0 );
+    auto                       start = std::chrono::steady_clock::now();
+    {
+      std::vector<std::jthread> workers;
+      for( std::size_t thread = 0; thread != threads; ++thread ) workers.emplace_back( [&, thread]
+      {
+        std::size_t made = 0;
+        for( ; !stop.load( std::memory_order_relaxed ); ++made ) work( thread );
+        calls[thread] = made;
+      } );
+
+      std::this_thread::sleep_for( duration );
+      stop = true;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::size_t total = 0;
+    for( auto made : calls ) total += made;
+    return static_cast<double>( total ) / elapsed.count();
+  }
+
+
+  void keep( std::uint64_t value )
+  {
+    kept = kept + value;
+  }
+
+
+
+
+  ScratchDirectory::ScratchDirectory( const std::string & name )
+    : _path( std::filesystem::temp_directory_path() / ( "eMatch-" + name ) ), _previous( std::filesystem::current_path() )
+  {
+    std::filesystem::remove_all( _path );    // left over from a run that didn't finish
+    std::filesystem::create_directories( _path );
+    std::filesystem::current_path( _path );
+  }
+
+
+  void ScratchDirectory::writeAdaptationData( const std::vector<std::pair<std::string, std::string>> & pairs ) const
+  {
+    std::ofstream file( _path / "Library_System_AdaptableData.dat" );
+    file << "\"Component.Logger\" = \"Simple Logger\"\n\"Component.UI\" = \"Simple UI\"\n";
+    for( const auto & [key, value] : pairs ) file << '"' << key << "\" = \"" << value << "\"\n";
+  }
+
+
+  ScratchDirectory::~ScratchDirectory() noexcept
+  {
+    std::error_code error;    // nothing to be done about a failure now, and the directory is only scratch
+    std::filesystem::current_path( _previous, error );
+    std::filesystem::remove_all( _path, error );
+  }
+}    // namespace Benchmarks
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <filesystem>   // path
+#include <functional>   // function
+#include <string>
+#include <utility>      // pair
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace Benchmarks
+{
+  /*****************************************************************************
+  ** Benchmarks
+  **   Each benchmark registers itself under a name by defining a Registration at namespace scope, and is run by the benchmarks
+  **   executable (see Build.sh) as
+  **
+  **       benchmarks name [argument ...]
+  **
+  **   or with no name at all to run every benchmark with its default arguments.  Results are printed as plain tables on
+  **   standard output, each benchmark measuring the code paths its request changed against what they replaced.
+  ******************************************************************************/
+  struct Benchmark
+  {
+    std::string                                                name;
+    std::string                                                usage;    // arguments and what's measured, one line
+    std::function<void( const std::vector<std::string> & )>    run;
+  };
+
+  struct Registration
+  {
+    Registration( std::string name, std::string usage, std::function<void( const std::vector<std::string> & )> run );
+  };
+
+  const std::vector<Benchmark> & registered();    // in name order
+
+
+
+
+  /*****************************************************************************
+  ** Helpers
+  ******************************************************************************/
+  // Returns arguments[index] as a count, or otherwise, if there are fewer arguments.  Throws std::invalid_argument if it isn't one.
+  std::size_t count( const std::vector<std::string> & arguments, std::size_t index, std::size_t otherwise );
+
+  // Returns arguments[index] onward as counts, or otherwise if there are no such arguments
+  std::vector<std::size_t> counts( const std::vector<std::string> & arguments, std::size_t index, std::vector<std::size_t> otherwise );
+
+  // Returns the jobs at catalog positions first through first + count - 1 of a made up catalog, the same for the same positions
+  // every time.  Names draw a word from a vocabulary of about a tenth as many words as the catalog has jobs, so a name word
+  // matches a handful of jobs however big the catalog, while locations, categories and types come from short fixed lists.
+  std::vector<TechnicalServices::Persistence::JobInfo> syntheticJobs( std::size_t first, std::size_t count, std::size_t catalogSize );
+
+  // Returns the mean time of a call to work, calling it repeatedly until at least atLeast has passed
+  std::chrono::duration<double, std::micro> timePerCall( const std::function<void()> & work,
+                                                         std::chrono::milliseconds atLeast = std::chrono::milliseconds( 200 ) );
+
+  // Returns the calls per second threads threads made between them, each calling work( thread ) over and over for duration
+  double callsPerSecond( std::size_t threads, const std::function<void( std::size_t thread )> & work,
+                         std::chrono::milliseconds duration = std::chrono::milliseconds( 500 ) );
+
+  // A value the optimizer can't prove unused, so the work producing it isn't optimized away
+  void keep( std::uint64_t value );
+
+
+
+
+  /*****************************************************************************
+  ** Scratch Directory
+  **   A fresh directory under the system's temporary directory for a benchmark's files, made the current directory while it
+  **   lives so a SimpleDB constructed meanwhile reads the adaptation data written there.  Removed, with everything in it, when
+  **   the benchmark is done with it.
+  ******************************************************************************/
+  class ScratchDirectory
+  {
+    public:
+      // Constructors
+      explicit ScratchDirectory( const std::string & name );
+      ScratchDirectory( const ScratchDirectory & ) = delete;
+      ScratchDirectory & operator=( const ScratchDirectory & ) = delete;
+
+
+      // Operations
+      const std::filesystem::path & path() const { return _path; }
+
+      // Writes Library_System_AdaptableData.dat holding the usual components and the given Key/Value pairs
+      void writeAdaptationData( const std::vector<std::pair<std::string, std::string>> & pairs ) const;
+
+
+      // Destructor
+      ~ScratchDirectory() noexcept;
+
+    private:
+      std::filesystem::path _path;
+      std::filesystem::path _previous;    // current directory before
+  };    // class ScratchDirectory
+}    // namespace Benchmarks
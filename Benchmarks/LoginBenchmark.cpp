@@ -0,0 +1,85 @@
+#include <algorithm>    // max()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <fstream>
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>       // hardware_concurrency()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+
+
+
+
+namespace
+{
+  std::string userName( std::size_t user ) { return "user" + std::to_string( user ); }
+
+
+  // Logins per second through findCredentialsByName(), against the linear scan of a copy of the user table it replaced, and
+  // with as many concurrent logins as there are cores
+  void loginThroughput( const std::vector<std::string> & arguments )
+  {
+    auto users = Benchmarks::count( arguments, 0, 1'000'000 );
+
+    // The users are loaded from a catalog just as they would be in production
+    Benchmarks::ScratchDirectory directory( "login-benchmark" );
+    {
+      std::ofstream catalog( directory.path() / "users.csv" );
+      for( std::size_t user = 0; user != users; ++user ) catalog << userName( user ) << ",secret" << user << ",JobSeeker\n";
+    }
+    directory.writeAdaptationData( { { "Component.SearchIndex", "Trigram Index" }, { "Persistence.UserCatalog", "users.csv" } } );
+
+    // Start up and shutdown logging isn't what's measured
+    struct Quiet
+    {
+      std::streambuf * log = std::clog.rdbuf( nullptr );
+      ~Quiet() { std::clog.rdbuf( log ); }
+    }                                        quiet;
+    TechnicalServices::Persistence::SimpleDB database;
+
+    // Logins are spread over every user, a different one each time, so the whole table is in play
+    auto login = [&]( std::size_t & next )
+    {
+      next = ( next + 7'919 ) % users;    // a prime stride visits every user
+      Benchmarks::keep( database.findCredentialsByName( userName( next ) ).roles.size() );
+    };
+
+    std::cout << std::setw( 10 ) << "users" << std::setw( 34 ) << "lookup" << std::setw( 10 ) << "threads" << std::setw( 16 ) << "logins/s" << '\n';
+    auto report = [&]( const char * lookup, std::size_t threads, double rate )
+    {
+      std::cout << std::setw( 10 ) << users << std::setw( 34 ) << lookup << std::setw( 10 ) << threads << std::setw( 16 ) << std::fixed << std::setprecision( 0 ) << rate << '\n';
+    };
+
+    // Before:  every login scanned a function-local static copy of the user table
+    {
+      std::vector<TechnicalServices::Persistence::UserCredentials> copy;
+      copy.reserve( users );
+      for( std::size_t user = 0; user != users; ++user ) copy.push_back( { userName( user ), "secret" + std::to_string( user ), { "JobSeeker" } } );
+
+      std::size_t next = 0;
+      auto        scan = Benchmarks::timePerCall( [&]
+      {
+        next = ( next + 7'919 ) % users;
+        auto name = userName( next );
+        for( const auto & user : copy ) if( user.userName == name ) { Benchmarks::keep( user.roles.size() ); break; }
+      } );
+      report( "linear scan of a copy (before)", 1, 1e6 / scan.count() );
+    }
+
+    std::vector<std::size_t> next( std::max( 1u, std::thread::hardware_concurrency() ), 0 );
+    for( std::size_t thread = 0; thread != next.size(); ++thread ) next[thread] = thread * ( users / next.size() );
+
+    for( std::size_t threads = 1; threads <= next.size(); threads *= 2 )
+      report( "findCredentialsByName", threads, Benchmarks::callsPerSecond( threads, [&]( std::size_t thread ) { login( next[thread] ); } ) );
+    if( ( next.size() & ( next.size() - 1 ) ) != 0 )
+      report( "findCredentialsByName", next.size(), Benchmarks::callsPerSecond( next.size(), [&]( std::size_t thread ) { login( next[thread] ); } ) );
+  }
+
+  Benchmarks::Registration login( "login", "[users]  findCredentialsByName logins per second against a linear scan, by thread count (default 1000000)", loginThroughput );
+}    // namespace
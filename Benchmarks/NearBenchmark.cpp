@@ -0,0 +1,82 @@
+#include <cstddef>      // size_t
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <stdexcept>    // runtime_error
+#include <string>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/SpatialIndex.hpp"
+
+
+
+
+namespace
+{
+  using TechnicalServices::Persistence::Gazetteer;
+  using TechnicalServices::Persistence::RowId;
+
+  // near:place~miles searches per second through the spatial index's geohash cells, against measuring the distance to every
+  // job in the table, as the catalog grows.  Jobs are spread over a grid of towns covering the continental United States, so
+  // a search's few cells hold a sliver of the catalog however big it gets.
+  void nearThroughput( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t rows    = 100;    // of towns, north to south
+    constexpr std::size_t columns = 200;    // of towns, west to east
+
+    Gazetteer gazetteer;
+    for( std::size_t row = 0; row != rows; ++row )
+      for( std::size_t column = 0; column != columns; ++column )
+        gazetteer.insert( { "Town " + std::to_string( row * columns + column ), 25.0 + 24.0 * static_cast<double>( row ) / rows,
+                            -124.0 + 57.0 * static_cast<double>( column ) / columns } );
+
+    auto centre = gazetteer.find( "Town " + std::to_string( rows / 2 * columns + columns / 2 ) ).value();    // Kansas, more or less
+
+    std::cout << std::setw( 10 ) << "jobs" << std::setw( 8 ) << "miles" << std::setw( 16 ) << "search" << std::setw( 10 ) << "matches" << std::setw( 14 )
+              << "queries/s" << std::setw( 10 ) << "speedup" << '\n';
+    for( auto size : Benchmarks::counts( arguments, 0, { 1'000'000, 4'000'000 } ) )
+    {
+      TechnicalServices::Persistence::SpatialIndex spatial( gazetteer );
+      TechnicalServices::Persistence::JobInfo      job;
+      for( std::size_t position = 0; position != size; ++position )
+      {
+        job.location = "Town " + std::to_string( position * 2'654'435'761u % ( rows * columns ) );    // a multiplicative hash visits every town
+        spatial.insert( static_cast<RowId>( position ), job );
+      }
+
+      // Before:  the distance to every job, as a query no index narrows filters them
+      auto scan = [&]( double miles )
+      {
+        TechnicalServices::Persistence::PostingList within;
+        for( RowId position = 0; position != spatial.size(); ++position )
+          if( auto at = spatial.coordinates( position ); at.known() && Gazetteer::miles( centre, at ) <= miles ) within.push_back( position );
+        return within;
+      };
+
+      for( double miles : { 5.0, 25.0, 100.0 } )
+      {
+        auto expected = scan( miles );
+        if( spatial.within( centre, miles ) != expected )
+          throw std::runtime_error( "the spatial index's jobs within " + std::to_string( miles ) + " miles aren't the full scan's" );
+
+        auto report = [&]( const char * search, double micros, double baseline )
+        {
+          std::cout << std::setw( 10 ) << size << std::setw( 8 ) << std::fixed << std::setprecision( 0 ) << miles << std::setw( 16 ) << search << std::setw( 10 )
+                    << expected.size() << std::setw( 14 ) << 1e6 / micros << std::setw( 10 ) << baseline / micros << '\n';
+        };
+
+        auto baseline = Benchmarks::timePerCall( [&] { Benchmarks::keep( scan( miles ).size() ); } ).count();
+        report( "full scan", baseline, baseline );
+
+        auto cells = Benchmarks::timePerCall( [&] { Benchmarks::keep( spatial.within( centre, miles ).size() ); } ).count();
+        report( "geohash cells", cells, baseline );
+      }
+    }
+  }
+
+  Benchmarks::Registration near( "near", "[jobs ...]  near:place~miles searches per second, geohash cells against a full scan, as the catalog grows (default 1000000 4000000)",
+                                 nearThroughput );
+}    // namespace
@@ -0,0 +1,104 @@
+#include <algorithm>    // max()
+#include <atomic>
+#include <chrono>
+#include <cstddef>      // size_t
+#include <functional>   // function
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <mutex>        // unique_lock
+#include <shared_mutex>
+#include <streambuf>
+#include <string>
+#include <thread>       // jthread, hardware_concurrency()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/ApplicationStore.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+
+
+
+
+namespace
+{
+  std::string seeker( std::size_t user ) { return "seeker" + std::to_string( user ); }
+
+
+  // Reads of a seeker's applications per second by thread count, from SimpleDB's versioned store and from the store behind a
+  // shared_mutex it replaced, each with no writer and with one writer applying all the while
+  void readThroughput( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t perSeeker = 10;
+    auto                  seekers   = Benchmarks::count( arguments, 0, 10'000 );
+
+    Benchmarks::ScratchDirectory directory( "read-benchmark" );
+    directory.writeAdaptationData( { { "Component.SearchIndex", "Trigram Index" } } );    // no application log, it's reads that are measured
+
+    struct Quiet
+    {
+      std::streambuf * log = std::clog.rdbuf( nullptr );
+      ~Quiet() { std::clog.rdbuf( log ); }
+    }                                          quiet;
+    TechnicalServices::Persistence::SimpleDB   database;
+
+    // Before:  the same store, readers sharing a lock the writer takes alone
+    TechnicalServices::Persistence::ApplicationStore locked;
+    std::shared_mutex                                lock;
+
+    for( std::size_t user = 0; user != seekers; ++user )
+      for( std::size_t job = 1; job <= perSeeker; ++job )
+      {
+        database.makeApplication( seeker( user ), static_cast<int>( job ) );
+        locked.insert( { seeker( user ), static_cast<int>( job ), "applied" } );
+      }
+
+    struct Store
+    {
+      const char *                                       name;
+      std::function<void( std::size_t user )>            read;
+      std::function<void( std::size_t application )>    write;
+    };
+    const Store stores[] = {
+      { "Versioned (MVCC)",
+        [&]( std::size_t user )        { Benchmarks::keep( database.getUserApplication( seeker( user ) ).size() ); },
+        [&]( std::size_t application ) { database.makeApplication( "late" + std::to_string( application ), 1 ); } },
+      { "shared_mutex (before)",
+        [&]( std::size_t user )        { std::shared_lock reading( lock ); Benchmarks::keep( locked.byUser( seeker( user ) ).size() ); },
+        [&]( std::size_t application ) { std::unique_lock writing( lock ); locked.insert( { "late" + std::to_string( application ), 1, "applied" } ); } } };
+
+    std::cout << std::setw( 10 ) << "seekers" << std::setw( 24 ) << "store" << std::setw( 10 ) << "writer" << std::setw( 10 ) << "threads" << std::setw( 16 )
+              << "reads/s" << std::setw( 16 ) << "writes/s" << '\n';
+
+    auto cores   = std::max( 1u, std::thread::hardware_concurrency() );
+    auto threads = std::vector<std::size_t>();
+    for( std::size_t count = 1; count <= cores; count *= 2 ) threads.push_back( count );
+    if( threads.back() != cores ) threads.push_back( cores );
+
+    std::size_t applications = 0;    // made by writers so far, so each applies as someone new
+    for( const auto & store : stores )
+      for( bool writing : { false, true } )
+        for( auto readers : threads )
+        {
+          // The writer runs alongside the readers for as long as they're measured
+          std::atomic<std::size_t> writes = 0;
+          double                   reads  = 0;
+          auto                     start  = std::chrono::steady_clock::now();
+          {
+            std::jthread writer;
+            if( writing ) writer = std::jthread( [&]( std::stop_token stop ) { while( !stop.stop_requested() ) { store.write( applications + writes ); ++writes; } } );
+
+            std::vector<std::size_t> next( readers );
+            for( std::size_t reader = 0; reader != readers; ++reader ) next[reader] = reader * ( seekers / readers );
+            reads = Benchmarks::callsPerSecond( readers, [&]( std::size_t reader ) { next[reader] = ( next[reader] + 7'919 ) % seekers; store.read( next[reader] ); } );
+          }
+          std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+          applications += writes;
+
+          std::cout << std::setw( 10 ) << seekers << std::setw( 24 ) << store.name << std::setw( 10 ) << ( writing ? "one" : "none" ) << std::setw( 10 ) << readers
+                    << std::setw( 16 ) << std::fixed << std::setprecision( 0 ) << reads << std::setw( 16 ) << static_cast<double>( writes ) / elapsed.count() << '\n';
+        }
+  }
+
+  Benchmarks::Registration reads( "reads", "[seekers]  reads of a seeker's applications per second, versioned against shared_mutex, by thread count, with and without a writer (default 10000)",
+                                  readThroughput );
+}    // namespace
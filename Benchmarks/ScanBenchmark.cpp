@@ -0,0 +1,89 @@
+#include <algorithm>    // min()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <stdexcept>    // runtime_error
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/JobTable.hpp"
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/SubstringScanner.hpp"
+
+
+
+
+namespace
+{
+  using TechnicalServices::Persistence::SubstringScanner;
+
+  // One unindexed scan of the normalized name column, as searchByCriteria() makes when no index can narrow a name criterion,
+  // with each of SubstringScanner's kernels against the find() per row loop it replaced.  Every kernel must find the loop's rows.
+  void scanThroughput( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t batch = 100'000;
+    auto                  jobs  = Benchmarks::count( arguments, 0, 1'000'000 );
+
+    TechnicalServices::Persistence::StringHeap names;
+    for( std::size_t first = 0; first < jobs; first += batch )
+      for( const auto & job : Benchmarks::syntheticJobs( first, std::min( batch, jobs - first ), jobs ) ) names.append( TechnicalServices::Persistence::normalize( job.name ) );
+
+    // A name word matches a handful of jobs, a kind thousands, and a needle found nowhere makes every kernel scan every byte
+    auto sample = Benchmarks::syntheticJobs( jobs / 2, 1, jobs ).front();
+    auto word   = TechnicalServices::Persistence::normalize( sample.name.substr( 0, sample.name.find( ' ' ) ) );
+
+    const std::vector<std::vector<std::string>> needleSets = { { word }, { "grill" }, { word, "grill" }, { "zqzqz" } };
+
+    // Before:  find() row by row
+    auto loop = [&]( const std::vector<std::string> & needles )
+    {
+      TechnicalServices::Persistence::PostingList rows;
+      for( TechnicalServices::Persistence::RowId row = 0; row != names.size(); ++row )
+      {
+        bool all = true;
+        for( const auto & needle : needles ) all = all && names[row].find( needle ) != std::string_view::npos;
+        if( all ) rows.push_back( row );
+      }
+      return rows;
+    };
+
+    auto megabytes = static_cast<double>( names.characters().size() ) / ( 1 << 20 );
+    std::cout << std::setw( 10 ) << "jobs" << std::setw( 22 ) << "needles" << std::setw( 18 ) << "scan" << std::setw( 10 ) << "matches" << std::setw( 12 )
+              << "us/scan" << std::setw( 10 ) << "MiB/s" << std::setw( 10 ) << "speedup" << '\n';
+    for( const auto & needles : needleSets )
+    {
+      std::string described;
+      for( const auto & needle : needles ) described += ( described.empty() ? "" : "+" ) + needle;
+
+      auto report = [&]( const char * scan, std::size_t matches, double micros, double baseline )
+      {
+        std::cout << std::setw( 10 ) << jobs << std::setw( 22 ) << described << std::setw( 18 ) << scan << std::setw( 10 ) << matches << std::setw( 12 )
+                  << std::fixed << std::setprecision( 0 ) << micros << std::setw( 10 ) << megabytes / micros * 1e6 << std::setw( 10 )
+                  << std::setprecision( 2 ) << baseline / micros << '\n';
+      };
+
+      auto expected = loop( needles );
+      auto baseline = Benchmarks::timePerCall( [&] { Benchmarks::keep( loop( needles ).size() ); } ).count();
+      report( "find() loop", expected.size(), baseline, baseline );
+
+      // A kernel the processor lacks falls back to the fastest it has, which is then already measured
+      for( auto kernel : { SubstringScanner::Kernel::Scalar, SubstringScanner::Kernel::SSE2, SubstringScanner::Kernel::AVX2 } )
+      {
+        SubstringScanner scanner( kernel );
+        if( scanner.kernel() != kernel ) continue;
+
+        if( scanner.rowsContainingAll( names, needles ) != expected )
+          throw std::runtime_error( std::string( SubstringScanner::name( kernel ) ) + " kernel's rows for " + described + " aren't the find() loop's" );
+
+        auto micros = Benchmarks::timePerCall( [&] { Benchmarks::keep( scanner.rowsContainingAll( names, needles ).size() ); } ).count();
+        report( SubstringScanner::name( kernel ), expected.size(), micros, baseline );
+      }
+    }
+  }
+
+  Benchmarks::Registration scan( "scan", "[jobs]  unindexed name scan per SubstringScanner kernel against a find() per row loop (default 1000000)", scanThroughput );
+}    // namespace
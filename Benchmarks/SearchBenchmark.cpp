@@ -0,0 +1,79 @@
+#include <algorithm>    // min()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <iomanip>      // setw()
+#include <iostream>
+#include <limits>       // numeric_limits
+#include <memory>       // unique_ptr, make_unique()
+#include <string>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/InvertedIndex.hpp"
+#include "TechnicalServices/Persistence/JobPartition.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/TrigramIndex.hpp"
+
+
+
+
+namespace
+{
+  using TechnicalServices::Persistence::JobPartition;
+  using TechnicalServices::Persistence::SearchIndex;
+
+  // searchByCriteria()'s latency as the catalog grows, for each Component.SearchIndex choice.  A query looks up one partition
+  // just as SimpleDB does, planning against the indexes, collecting the matching rows and fetching their jobs.
+  void searchLatency( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t batch = 100'000;    // jobs appended at a time, so the made up catalog is never held twice over
+
+    struct Index
+    {
+      const char *                                    name;
+      std::unique_ptr<SearchIndex>                 ( * make )();
+    };
+    const Index indexes[] = { { "Trigram Index", [] () -> std::unique_ptr<SearchIndex> { return std::make_unique<TechnicalServices::Persistence::TrigramIndex>(); } },
+                              { "Token Index",   [] () -> std::unique_ptr<SearchIndex> { return std::make_unique<TechnicalServices::Persistence::InvertedIndex>(); } },
+                              { "Full Scan",     [] () -> std::unique_ptr<SearchIndex> { return nullptr; } } };
+
+    std::cout << std::setw( 10 ) << "jobs" << std::setw( 16 ) << "index" << std::setw( 22 ) << "query" << std::setw( 10 ) << "matches" << std::setw( 14 ) << "us/query" << '\n';
+    for( auto size : Benchmarks::counts( arguments, 0, { 10'000, 100'000, 1'000'000 } ) )
+    {
+      // A name word matches a handful of jobs however big the catalog, so an index keeps its latency flat where a scan can't
+      auto sample = Benchmarks::syntheticJobs( size / 2, 1, size ).front();
+      auto word   = sample.name.substr( 0, sample.name.find( ' ' ) );
+
+      const std::vector<std::vector<std::string>> queries = { { word,    "0",         "0"       },
+                                                              { word,    "Fullerton", "0"       },
+                                                              { "0",     "Fullerton", "Barista" },
+                                                              { "Grill", "0",         "0"       } };
+
+      for( const auto & index : indexes )
+      {
+        TechnicalServices::Persistence::Gazetteer gazetteer;
+        JobPartition                              jobs( index.make(), gazetteer );
+        for( std::size_t first = 0; first < size; first += batch ) jobs.append( Benchmarks::syntheticJobs( first, std::min( batch, size - first ), size ), first );
+
+        for( const auto & query : queries )
+        {
+          std::size_t matches = 0;
+          auto        latency = Benchmarks::timePerCall( [&]
+          {
+            auto rows = jobs.search( jobs.plan( query ), 0, std::numeric_limits<std::size_t>::max() );
+            for( auto row : rows ) Benchmarks::keep( static_cast<std::uint64_t>( jobs.job( row ).id ) );
+            matches = rows.size();
+          } );
+
+          std::string criteria;
+          for( const auto & criterion : query ) criteria += ( criteria.empty() ? "" : "/" ) + criterion;
+          std::cout << std::setw( 10 ) << size << std::setw( 16 ) << index.name << std::setw( 22 ) << criteria << std::setw( 10 ) << matches
+                    << std::setw( 14 ) << std::fixed << std::setprecision( 1 ) << latency.count() << '\n';
+        }
+      }
+    }
+  }
+
+  Benchmarks::Registration search( "search", "[jobs ...]  searchByCriteria latency per index as the catalog grows (default 10000 100000 1000000)", searchLatency );
+}    // namespace
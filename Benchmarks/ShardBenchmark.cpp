@@ -0,0 +1,80 @@
+#include <algorithm>    // max(), min()
+#include <cstddef>      // size_t
+#include <fstream>
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <memory>       // make_unique(), unique_ptr
+#include <streambuf>
+#include <string>
+#include <thread>       // hardware_concurrency()
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/ShardedDB.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+
+
+
+
+namespace
+{
+  // Searches per second through SimpleDB, every search on its caller's thread, against ShardedDB, every search scattered over
+  // its shards on a thread pool, by the number of sessions searching at once
+  void shardThroughput( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t batch  = 100'000;
+    auto                  cores  = std::max( 1u, std::thread::hardware_concurrency() );
+    auto                  jobs   = Benchmarks::count( arguments, 0, 1'000'000 );
+    auto                  shards = Benchmarks::count( arguments, 1, cores );
+
+    Benchmarks::ScratchDirectory directory( "shard-benchmark" );
+    {
+      std::ofstream catalog( directory.path() / "jobs.csv" );
+      for( std::size_t first = 0; first < jobs; first += batch )
+        for( const auto & job : Benchmarks::syntheticJobs( first, std::min( batch, jobs - first ), jobs ) )
+          catalog << job.id << ',' << job.name << ',' << job.location << ',' << job.category << ',' << job.type << ',' << job.description << ','
+                  << job.qualification << ',' << job.salary << '\n';
+    }
+    directory.writeAdaptationData( { { "Component.SearchIndex", "Trigram Index" }, { "Persistence.JobCatalog", "jobs.csv" },
+                                   { "Persistence.QueryCacheCapacity", "0" } } );    // every search is searched
+
+    struct Quiet
+    {
+      std::streambuf * log = std::clog.rdbuf( nullptr );
+      ~Quiet() { std::clog.rdbuf( log ); }
+    } quiet;
+
+    // A common word scanning a sizeable share of every partition, a facet pair, and a name word matching a handful of jobs
+    auto sample = Benchmarks::syntheticJobs( jobs / 2, 1, jobs ).front();
+    const std::vector<std::vector<std::string>> queries = { { "Grill", "0", "0" }, { "0", "Fullerton", "Barista" }, { sample.name.substr( 0, sample.name.find( ' ' ) ), "0", "0" } };
+
+    std::vector<std::size_t> threads;
+    for( std::size_t count = 1; count <= cores; count *= 2 ) threads.push_back( count );
+    if( threads.back() != cores ) threads.push_back( cores );
+
+    std::cout << std::setw( 10 ) << "jobs" << std::setw( 24 ) << "database" << std::setw( 10 ) << "threads" << std::setw( 16 ) << "searches/s" << '\n';
+    for( bool sharded : { false, true } )
+    {
+      std::unique_ptr<TechnicalServices::Persistence::PersistenceHandler> database;
+      if( sharded ) database = std::make_unique<TechnicalServices::Persistence::ShardedDB>( shards );
+      else          database = std::make_unique<TechnicalServices::Persistence::SimpleDB>();
+      auto name = sharded ? "Sharded DB, " + std::to_string( shards ) + " shards" : std::string( "Simple DB" );
+
+      for( auto count : threads )
+      {
+        std::vector<std::size_t> next( count, 0 );
+        auto rate = Benchmarks::callsPerSecond( count, [&]( std::size_t thread )
+        {
+          next[thread] = ( next[thread] + 1 ) % queries.size();
+          Benchmarks::keep( database->searchByCriteria( queries[next[thread]] ).size() );
+        }, std::chrono::milliseconds( 1'000 ) );
+
+        std::cout << std::setw( 10 ) << jobs << std::setw( 24 ) << name << std::setw( 10 ) << count << std::setw( 16 ) << std::fixed << std::setprecision( 1 ) << rate << '\n';
+      }
+    }
+  }
+
+  Benchmarks::Registration shards( "shards", "[jobs [shards]]  searches per second, Simple DB against Sharded DB, by concurrent searches (default 1000000, a shard per core)",
+                                   shardThroughput );
+}    // namespace
@@ -0,0 +1,66 @@
+#include <algorithm>    // min()
+#include <chrono>
+#include <cstddef>      // size_t
+#include <filesystem>   // file_size()
+#include <fstream>
+#include <iomanip>      // setw(), setprecision()
+#include <iostream>
+#include <memory>       // make_unique()
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+
+
+
+
+namespace
+{
+  // Start up time from the catalogs, which parses them and builds every index, against start up from the snapshot image saved
+  // then, and what the first searches cost afterwards, since a mapped image is paged in as it's touched
+  void startupTime( const std::vector<std::string> & arguments )
+  {
+    constexpr std::size_t batch = 100'000;
+    auto                  jobs  = Benchmarks::count( arguments, 0, 1'000'000 );
+
+    Benchmarks::ScratchDirectory directory( "startup-benchmark" );
+    {
+      std::ofstream catalog( directory.path() / "jobs.csv" );
+      for( std::size_t first = 0; first < jobs; first += batch )
+        for( const auto & job : Benchmarks::syntheticJobs( first, std::min( batch, jobs - first ), jobs ) )
+          catalog << job.id << ',' << job.name << ',' << job.location << ',' << job.category << ',' << job.type << ',' << job.description << ','
+                  << job.qualification << ',' << job.salary << '\n';
+    }
+    directory.writeAdaptationData( { { "Component.SearchIndex", "Trigram Index" }, { "Persistence.JobCatalog", "jobs.csv" }, { "Persistence.Snapshot", "eMatch.snapshot" },
+                                   { "Persistence.QueryCacheCapacity", "0" } } );    // every search is searched
+
+    struct Quiet
+    {
+      std::streambuf * log = std::clog.rdbuf( nullptr );
+      ~Quiet() { std::clog.rdbuf( log ); }
+    } quiet;
+
+    std::cout << std::setw( 10 ) << "jobs" << std::setw( 28 ) << "start up from" << std::setw( 14 ) << "start up ms" << std::setw( 18 ) << "first search us"
+              << std::setw( 18 ) << "later search us" << '\n';
+    for( const char * source : { "catalogs", "snapshot image" } )
+    {
+      auto start    = std::chrono::steady_clock::now();
+      auto database = std::make_unique<TechnicalServices::Persistence::SimpleDB>();
+      auto startup  = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start );
+
+      // The first search after a restore pages in what it touches, later ones find it resident
+      auto search = [&] { return Benchmarks::timePerCall( [&] { Benchmarks::keep( database->searchByCriteria( { "Grill", "Fullerton", "Barista" } ).size() ); },
+                                                          std::chrono::milliseconds( 0 ) ); };
+      auto first = search();
+      auto later = search();
+
+      std::cout << std::setw( 10 ) << jobs << std::setw( 28 ) << source << std::setw( 14 ) << std::fixed << std::setprecision( 0 ) << startup.count()
+                << std::setw( 18 ) << first.count() << std::setw( 18 ) << later.count() << '\n';
+    }
+    std::cout << "snapshot image " << ( std::filesystem::file_size( directory.path() / "eMatch.snapshot" ) >> 20 ) << " MiB\n";
+  }
+
+  Benchmarks::Registration startup( "startup", "[jobs]  SimpleDB start up from the catalogs against start up from a snapshot image (default 1000000)", startupTime );
+}    // namespace
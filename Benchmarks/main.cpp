@@ -0,0 +1,38 @@
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmarks/Benchmark.hpp"
+
+
+
+
+// Runs the benchmark named by the first argument with the rest as its arguments, or every benchmark with its defaults
+int main( int argc, char * argv[] )
+{
+  std::vector<std::string> arguments( argv + 1, argv + argc );
+
+  try
+  {
+    for( const auto & benchmark : Benchmarks::registered() )
+    {
+      if( !arguments.empty() && arguments.front() != benchmark.name ) continue;
+
+      std::cout << "== " << benchmark.name << " ==\n";
+      benchmark.run( arguments.empty() ? arguments : std::vector<std::string>( arguments.begin() + 1, arguments.end() ) );
+      std::cout << '\n';
+      if( !arguments.empty() ) return 0;
+    }
+    if( arguments.empty() ) return 0;
+  }
+  catch( const std::exception & error )
+  {
+    std::cerr << "Benchmark failed: " << error.what() << '\n';
+    return 1;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " [benchmark [argument ...]]\n";
+  for( const auto & benchmark : Benchmarks::registered() ) std::cerr << "  " << benchmark.name << ' ' << benchmark.usage << '\n';
+  return 1;
+}
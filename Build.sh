@@ -254,7 +254,9 @@ fi
 # temporarily ignore spaces when globing words into file names
 temp=$IFS
   IFS=$'\n'
-  sourceFiles=( $(find ./ -path ./.\* -prune -o -name "*.cpp" -print) )              # create array of source files skipping hidden folders (folders that start with a dot)
+  sourceFiles=( $(find ./ \( -path ./.\* -o -path ./Benchmarks -o -path ./StressTests \) -prune -o -name "*.cpp" -print) )   # create array of source files skipping hidden folders (folders that start with a dot) and the other executables' entry points
+  benchmarkSources=( $(find ./TechnicalServices ./Benchmarks -name "*.cpp" -print) )                                      # the persistence layer and the benchmarks driving it
+  stressSources=( $(find ./TechnicalServices ./StressTests -name "*.cpp" -print) )                                        # the persistence layer and the stress tests hammering it
 IFS=$temp
 
 echo "compiling in \"$PWD\" ..."
@@ -313,21 +315,37 @@ CommonOptions="-g0 -O3 -DNDEBUG -pthread -std=c++20 -I./ -DUSING_TOMS_SUGGESTION
 
 
 ClangCommand="clang++ $CommonOptions $ClangOptions"
-echo $ClangCommand -include \"${complianceHelperFile_path}\"
-clang++ --version
-if $ClangCommand -include "${complianceHelperFile_path}" -o "${executableFileName}_clang++"  "${sourceFiles[@]}"; then
-  echo -e "\nSuccessfully created  \"${executableFileName}_clang++\""
-else
-  exit 1
-fi
+GccCommand="g++ $CommonOptions $GccOptions"
 
-echo ""
 
-GccCommand="g++ $CommonOptions $GccOptions"
-echo $GccCommand -include \"${complianceHelperFile_path}\"
-g++ --version
-if $GccCommand -include "${complianceHelperFile_path}" -o "${executableFileName}_g++"  "${sourceFiles[@]}"; then
-   echo -e "\nSuccessfully created  \"${executableFileName}_g++\""
-else
-   exit 1
-fi
+# Compiles and links the sources that follow into executable, once with each compiler
+BuildExecutable()
+{
+  local executable="$1"
+  shift
+
+  echo $ClangCommand -include \"${complianceHelperFile_path}\"
+  clang++ --version
+  if $ClangCommand -include "${complianceHelperFile_path}" -o "${executable}_clang++"  "$@"; then
+    echo -e "\nSuccessfully created  \"${executable}_clang++\""
+  else
+    exit 1
+  fi
+
+  echo ""
+
+  echo $GccCommand -include \"${complianceHelperFile_path}\"
+  g++ --version
+  if $GccCommand -include "${complianceHelperFile_path}" -o "${executable}_g++"  "$@"; then
+     echo -e "\nSuccessfully created  \"${executable}_g++\""
+  else
+     exit 1
+  fi
+
+  echo ""
+}
+
+
+BuildExecutable "${executableFileName}"  "${sourceFiles[@]}"
+BuildExecutable "benchmarks"             "${benchmarkSources[@]}"    # run as:  benchmarks_g++ [benchmark [argument ...]]
+BuildExecutable "stress"                 "${stressSources[@]}"       # run as:  stress_g++ [scenario [seconds [readers]]]
@@ -1,8 +1,14 @@
 #include "Domain/Session/Session.hpp"
 #include "TechnicalServices/Persistence/PersistenceHandler.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <string>
 #include <any>
+#include <exception>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace  // anonymous (private) working area
@@ -29,21 +35,72 @@ namespace  // anonymous (private) working area
     return {results};
   }
 
+  // Search results are fetched a page at a time, so a session holds one page of jobs however many match
+  constexpr std::size_t searchPageSize = 20;
+
   std::any searchJob(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
   {
       // TO-DO  Search job by criteria
-      if (args.size() == 3) {
+      // An optional fourth argument asks for only that many of the jobs most relevant to the keyword, best first; blank or 0 for all
+      std::size_t best = 0;
+      if (args.size() >= 4 && !args[3].empty() && args[3] != "0") {
+          try { best = std::stoul(args[3]); }
+          catch (const std::exception&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+      }
+
+      // An optional fifth argument asks for jobs within that many miles of the location, rather than at it; blank or 0 for at it
+      std::string miles;
+      if (args.size() >= 5 && !args[4].empty() && args[4] != "0") {
+          // Plain decimals only, stod() would also take "inf", "nan", hex and exponents
+          if (args[4].find_first_not_of("0123456789.") != std::string::npos) return { std::string("[ERROR] ARGS NOT VALID") };
+          double distance = 0;
+          try { distance = std::stod(args[4]); }
+          catch (const std::exception&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+          if (!std::isfinite(distance) || distance <= 0) return { std::string("[ERROR] ARGS NOT VALID") };
+          miles = std::to_string(distance);
+      }
+
+      // An optional sixth argument tolerates up to that many typos (1 or 2) in each word of the criteria; blank or 0 for exact
+      std::string typos;
+      if (args.size() == 6 && !args[5].empty() && args[5] != "0") {
+          if (args[5] != "1" && args[5] != "2") return { std::string("[ERROR] ARGS NOT VALID") };
+          typos = "~" + args[5];
+      }
+
+      if (args.size() >= 3 && args.size() <= 6) {
           std::string keyword = args[0] == "0" ? "" : args[0];
           std::string location = args[1] == "0" ? "" : args[1];
           std::string category = args[2] == "0" ? "" : args[2];
           std::string results = "Job \"" + keyword + "/" + location + "/" + category + "/\" searched by \"" + session._credentials.userName + '"';
+          if (best != 0) results += " for the best " + std::to_string(best);
+          if (!miles.empty()) results += " within " + args[4] + " miles";
+          if (!typos.empty()) results += " allowing " + args[5] + " typo(s) a word";
           session._logger << "searchJob:  " + results;
           
           auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
-          std::vector<TechnicalServices::Persistence::JobInfo> searchResult = persistentData.searchByCriteria(args);
+          TechnicalServices::Persistence::SearchPage searchResult;
+          if (!miles.empty() || !typos.empty()) {
+              // Distance and typos are query criteria, so the criteria are asked as a query; ranking and quotes in criteria don't carry over
+              if ((!miles.empty() && location.empty()) || best != 0 || (keyword + location + category).find('"') != std::string::npos) return { std::string("[ERROR] ARGS NOT VALID") };
+
+              TechnicalServices::Persistence::SearchCursor cursor;
+              if (!miles.empty())         cursor.query += " near:\"" + location + "\"~" + miles;
+              else if (!location.empty()) cursor.query += " location:\"" + location + '"' + typos;
+              if (!keyword.empty())       cursor.query += " name:\"" + keyword + '"' + typos;
+              if (!category.empty())      cursor.query += " category:\"" + category + '"' + typos;
+              if (cursor.query.empty())   cursor.query = "\"\"";    // no criteria, so every job
+
+              try { searchResult = persistentData.searchPage(cursor, searchPageSize); }
+              catch (const TechnicalServices::Persistence::PersistenceHandler::BadQuery& error) { return { "[ERROR] " + std::string(error.what()) }; }
+          }
+          else if (best == 0) searchResult = persistentData.searchPage({ args }, searchPageSize);
+          else {
+              searchResult.jobs           = persistentData.searchTopK(args, best);
+              searchResult.next.exhausted = true;    // ranked results come all at once
+          }
           
-          if (!searchResult.empty()) {
-              session.setSearchResult(searchResult);
+          if (!searchResult.jobs.empty()) {
+              session.setSearchResult(std::move(searchResult), 0);
               session.display();
               return { results };
           }
@@ -59,16 +116,187 @@ namespace  // anonymous (private) working area
   }
 
 
+  std::any queryJobs(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  a boolean query, e.g.  category:Barista AND (location:Fullerton OR location:Irvine) AND NOT type:"Part time"
+      if (args.size() != 1) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      std::string results = "Jobs queried for \"" + args[0] + "\" by \"" + session._credentials.userName + '"';
+      session._logger << "queryJobs:  " + results;
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      TechnicalServices::Persistence::SearchCursor cursor;
+      cursor.query = args[0];
+
+      TechnicalServices::Persistence::SearchPage searchResult;
+      try { searchResult = persistentData.searchPage(cursor, searchPageSize); }
+      catch (const TechnicalServices::Persistence::PersistenceHandler::BadQuery& error) { return { "[ERROR] " + std::string(error.what()) }; }
+
+      if (searchResult.jobs.empty()) return { std::string("[Warning] No search results") };
+
+      session.setSearchResult(std::move(searchResult), 0);
+      session.display();
+      return { results };
+  }
+
+
+  std::any explainQuery(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  a boolean query, as for queryJobs
+      if (args.size() != 1) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      std::string plan;
+      try { plan = persistentData.explainQuery(args[0]); }
+      catch (const TechnicalServices::Persistence::PersistenceHandler::BadQuery& error) { return { "[ERROR] " + std::string(error.what()) }; }
+
+      std::string results = "Query \"" + args[0] + "\" explained to \"" + session._credentials.userName + '"';
+      session._logger << "explainQuery:  " + results;
+      return { plan };
+  }
+
+
+  // Values are suggested a handful at a time, as the start of a criterion is typed
+  constexpr std::size_t suggestionCount = 10;
+
+  std::any suggestValues(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  which criterion ("keyword", "location" or "category"), and the start of a word of the values wanted
+      static const std::vector<std::string> criteria = { "keyword", "location", "category" };
+      if (args.size() != 2) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      auto criterion = std::find(criteria.cbegin(), criteria.cend(), args[0]);
+      if (criterion == criteria.cend()) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      auto suggestions = persistentData.suggest(static_cast<std::size_t>(criterion - criteria.cbegin()), args[1], suggestionCount);
+      if (suggestions.empty()) return { "[Warning] No " + args[0] + " starts with \"" + args[1] + '"' };
+
+      std::string results;
+      for (const auto& suggestion : suggestions) results += "  " + suggestion.value + "  (" + std::to_string(suggestion.jobs) + " jobs)\n";
+
+      session._logger << "suggestValues:  " + args[0] + " values starting with \"" + args[1] + "\" suggested to \"" + session._credentials.userName + '"';
+      return { results };
+  }
+
+
+  // Recommendations come a handful at a time, like suggestions
+  constexpr std::size_t recommendationCount = 10;
+
+  std::any recommendJobs(Domain::Session::SessionBase& session, const std::vector<std::string>& /*args*/)
+  {
+      // Jobs most like those the seeker has applied for, best first
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      TechnicalServices::Persistence::SearchPage searchResult;
+      searchResult.jobs           = persistentData.recommendJobs(session._credentials.userName, recommendationCount);
+      searchResult.next.exhausted = true;    // recommendations come all at once
+      if (searchResult.jobs.empty()) return { std::string("[Warning] No recommendations, apply for a job first") };
+
+      std::string results = std::to_string(searchResult.jobs.size()) + " jobs recommended to \"" + session._credentials.userName + '"';
+      session._logger << "recommendJobs:  " + results;
+
+      session.setSearchResult(std::move(searchResult), 0);
+      session.display();
+      return { results };
+  }
+
+
+  std::any saveSearch(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  a boolean query, as for queryJobs, to be alerted to new jobs matching
+      if (args.size() != 1) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      std::size_t id;
+      try { id = persistentData.saveSearch(session._credentials.userName, args[0]); }
+      catch (const TechnicalServices::Persistence::PersistenceHandler::BadQuery& error) { return { "[ERROR] " + std::string(error.what()) }; }
+
+      std::string results = "Search " + std::to_string(id) + " \"" + args[0] + "\" saved by \"" + session._credentials.userName + '"';
+      session._logger << "saveSearch:  " + results;
+      return { results };
+  }
+
+
+  std::any viewSavedSearches(Domain::Session::SessionBase& session, const std::vector<std::string>& /*args*/)
+  {
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      auto searches = persistentData.savedSearches(session._credentials.userName);
+      if (searches.empty()) return { std::string("[Warning] No saved searches") };
+
+      std::string results;
+      for (const auto& search : searches) results += "  " + std::to_string(search.id) + ") " + search.query + '\n';
+
+      session._logger << "viewSavedSearches:  " + std::to_string(searches.size()) + " saved searches viewed by \"" + session._credentials.userName + '"';
+      return { results };
+  }
+
+
+  std::any forgetSearch(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  the saved search's id
+      if (args.size() != 1) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      std::size_t id;
+      try { id = std::stoul(args[0]); }
+      catch (const std::exception&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      if (!persistentData.forgetSearch(session._credentials.userName, id)) return { "[Warning] No saved search " + args[0] };
+
+      std::string results = "Search " + args[0] + " forgotten by \"" + session._credentials.userName + '"';
+      session._logger << "forgetSearch:  " + results;
+      return { results };
+  }
+
+
+  std::any jobAlerts(Domain::Session::SessionBase& session, const std::vector<std::string>& /*args*/)
+  {
+      // Jobs posted since last asked that match the seeker's saved searches, oldest first
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      auto alerts = persistentData.takeAlerts(session._credentials.userName);
+      if (alerts.empty()) return { std::string("[Warning] No new jobs match your saved searches") };
+
+      TechnicalServices::Persistence::SearchPage searchResult;
+      for (auto& alert : alerts) searchResult.jobs.push_back(std::move(alert.job));
+      searchResult.next.exhausted = true;    // alerts come all at once
+
+      std::string results = std::to_string(alerts.size()) + " job alerts taken by \"" + session._credentials.userName + '"';
+      session._logger << "jobAlerts:  " + results;
+
+      session.setSearchResult(std::move(searchResult), 0);
+      session.display();
+      return { results };
+  }
+
+
+  std::any nextSearchPage(Domain::Session::SessionBase& session, const std::vector<std::string>& /*args*/)
+  {
+      if (session._searchCursor.exhausted) return { std::string("[Warning] No more search results") };
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      TechnicalServices::Persistence::SearchPage searchResult = persistentData.searchPage(session._searchCursor, searchPageSize);
+      if (searchResult.jobs.empty()) return { std::string("[Warning] No more search results") };
+
+      std::string results = "Search results from " + std::to_string(session._searchPageStart + session._searchResult.size() + 1) + " viewed by \"" + session._credentials.userName + '"';
+      session._logger << "nextSearchPage:  " + results;
+
+      session.setSearchResult(std::move(searchResult), session._searchPageStart + session._searchResult.size());
+      session.display();
+      return { results };
+  }
+
+
   std::any getJobInfo(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
   {
       // TO-DO  get job info
-      int selectedNum = std::stoi(args[0]) - 1;
-      std::vector<TechnicalServices::Persistence::JobInfo> searchResult = session._searchResult;
+      // Jobs are numbered across pages, but only the current page is held
+      int selectedNum = std::stoi(args[0]) - 1 - static_cast<int>(session._searchPageStart);
+      const std::vector<TechnicalServices::Persistence::JobInfo>& searchResult = session._searchResult;
       
       
       if (selectedNum >= 0 && selectedNum < searchResult.size()) {
           
-          TechnicalServices::Persistence::JobInfo selectedJob = searchResult.at(selectedNum);
+          const TechnicalServices::Persistence::JobInfo& selectedJob = searchResult.at(selectedNum);
           std::string results = "Job Info \"" + selectedJob.name + "\" viewed by \"" + session._credentials.userName + '"';
           session._logger << "jobInfo:  " + results;
           
@@ -114,6 +342,72 @@ namespace  // anonymous (private) working area
 
       return { results };
   }
+
+  std::any viewApplicants(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  job id, status ("0" for any), page number (1 based)
+      constexpr std::size_t pageSize = 20;
+
+      if (args.size() != 3) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      int         jobId;
+      std::size_t page;
+      try { jobId = std::stoi(args[0]);  page = std::stoul(args[2]); }
+      catch (const std::exception&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+      std::size_t offset = (page > 0 ? page - 1 : 0) * pageSize;
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      std::vector<TechnicalServices::Persistence::Application> applicants = persistentData.getJobApplicants(jobId, args[1], offset, pageSize);
+
+      std::string results = "Applicants for job \"" + args[0] + "\" page " + std::to_string(page) + " viewed by \"" + session._credentials.userName + '"';
+      session._logger << "viewApplicants:  " + results;
+      session.displayApplicants(applicants, offset);
+
+      return { results };
+  }
+
+  std::any findDuplicates(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  job id
+      if (args.size() != 1) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      std::vector<TechnicalServices::Persistence::JobInfo> duplicates;
+      try {
+          duplicates = persistentData.findDuplicates(std::stoi(args[0]));
+      }
+      catch (const TechnicalServices::Persistence::PersistenceHandler::NoSuchJob&) {
+          return { "[Warning] No job \"" + args[0] + '"' };
+      }
+      catch (const std::invalid_argument&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+      catch (const std::out_of_range&)     { return { std::string("[ERROR] ARGS NOT VALID") }; }
+      if (duplicates.empty()) return { "[Warning] No postings nearly duplicate job \"" + args[0] + '"' };
+
+      std::string results;
+      for (const auto& job : duplicates) results += "  " + std::to_string(job.id) + "  " + job.name + ", " + job.location + " (" + job.category + ")\n";
+
+      session._logger << "findDuplicates:  " + std::to_string(duplicates.size()) + " near duplicates of job \"" + args[0] + "\" found by \"" + session._credentials.userName + '"';
+      return { results };
+  }
+
+  std::any updateApplicationStatus(Domain::Session::SessionBase& session, const std::vector<std::string>& args)
+  {
+      // args:  job id, applicant's user name, new status
+      if (args.size() != 3) return { std::string("[ERROR] ARGS NOT VALID") };
+
+      int jobId;
+      try { jobId = std::stoi(args[0]); }
+      catch (const std::exception&) { return { std::string("[ERROR] ARGS NOT VALID") }; }
+
+      auto& persistentData = TechnicalServices::Persistence::PersistenceHandler::instance();
+      bool success = persistentData.updateApplicationStatus(args[1], jobId, args[2]);
+
+      std::string results = "Application of \"" + args[1] + "\" for job \"" + args[0] + "\" set to \"" + args[2] + "\" by \"" + session._credentials.userName + '"';
+      if (!success) results = "[Warning] no such application!";
+
+      session._logger << "Update Application Status:  " + results;
+      return { results };
+  }
 }    // anonymous (private) working area
 
 
@@ -157,16 +451,38 @@ namespace Domain::Session
       }
   }
 
+  void SessionBase::displayApplicants(const std::vector<TechnicalServices::Persistence::Application>& applicants, std::size_t offset) {
+      std::cout << "\n----------------------------------------------------------------------------------------------\n";
+      std::cout << "Applicants: " << applicants.size() << "\n";
+      std::size_t i = offset + 1;
+      for (const auto& app : applicants) {
+          std::cout << i << ") applicant: " + app.userName + " | status: " + app.status + "\n";
+          i++;
+      }
+      std::cout << "----------------------------------------------------------------------------------------------\n";
+  }
+
   TechnicalServices::Persistence::JobInfo SessionBase::getJob(int jobId) {
       for (const auto& job : _searchResult) if (job.id == jobId) return job;
+
+      // Jobs applied for from an earlier page, or an earlier session, are looked up.  One since removed still shows its id.
+      try {
+          return TechnicalServices::Persistence::PersistenceHandler::instance().findJob(jobId);
+      }
+      catch (const TechnicalServices::Persistence::PersistenceHandler::NoSuchJob&) {
+          TechnicalServices::Persistence::JobInfo removed;
+          removed.id   = jobId;
+          removed.name = "(job " + std::to_string(jobId) + " no longer posted)";
+          return removed;
+      }
   }
 
   void SessionBase::display() {
-      std::vector<TechnicalServices::Persistence::JobInfo> searchResult = _searchResult;
       std::cout << "\n----------------------------------------------------------------------------------------------\n";
-      std::cout << "searchResult size: " << searchResult.size() << "\n";
-      int i = 1;
-      for (const auto& job : searchResult) {
+      std::cout << "searchResults " << _searchPageStart + 1 << " to " << _searchPageStart + _searchResult.size()
+                << (_searchCursor.exhausted ? " (end of results)" : " (enter + for more)") << "\n";
+      std::size_t i = _searchPageStart + 1;
+      for (const auto& job : _searchResult) {
           //std::cout << i << ") " + job.name + " | " + job.location + " | " + job.category + " | " + job.description + " | " + job.qualification + " | " + job.salary + "\n";
           std::cout << i << ") " + job.name + " | " + job.location + " | " + job.category + "\n";
           i++;
@@ -194,8 +510,10 @@ namespace Domain::Session
   }
 
   
-  void SessionBase::setSearchResult(std::vector<TechnicalServices::Persistence::JobInfo> searchResult) {
-      _searchResult = searchResult;
+  void SessionBase::setSearchResult(TechnicalServices::Persistence::SearchPage searchResult, std::size_t pageStart) {
+      _searchResult    = std::move(searchResult.jobs);
+      _searchCursor    = std::move(searchResult.next);
+      _searchPageStart = pageStart;
   }
 
   std::vector<std::string> SessionBase::getCommands()
@@ -247,6 +565,7 @@ namespace Domain::Session
   AdministratorSession::AdministratorSession( const UserCredentials & credentials ) : SessionBase( "Administrator", credentials )
   {
     _commandDispatch = { {"View Logs",            help        },
+                         {"Explain Query",   explainQuery},
                          {"Security",   resetAccount},
                          {"Shutdown System", shutdown    } };
   }
@@ -271,7 +590,15 @@ namespace Domain::Session
     _commandDispatch = { {"Search Job",  searchJob},
                          {"Get Job Info", getJobInfo},
                          {"Apply for Job",   applyForJob},
-                         {"View Applications", viewApplications} };
+                         {"View Applications", viewApplications},
+                         {"Query Jobs", queryJobs},
+                         {"Suggest", suggestValues},
+                         {"Recommended Jobs", recommendJobs},
+                         {"Save Search", saveSearch},
+                         {"Saved Searches", viewSavedSearches},
+                         {"Forget Search", forgetSearch},
+                         {"Job Alerts", jobAlerts},
+                         {"Next Page", nextSearchPage} };
   }
 
 
@@ -279,7 +606,10 @@ namespace Domain::Session
 
   ManagementSession::ManagementSession( const UserCredentials & credentials ) : SessionBase( "Management", credentials )
   {
-    _commandDispatch = { {"Bug People", bugPeople},
-                         {"Help",       help} };
+    _commandDispatch = { {"Bug People",      bugPeople},
+                         {"Help",            help},
+                         {"View Applicants", viewApplicants},
+                         {"Find Duplicates", findDuplicates},
+                         {"Update Application Status", updateApplicationStatus} };
   }
 }    // namespace Domain::Session
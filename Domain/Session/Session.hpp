@@ -1,6 +1,7 @@
 #pragma once
 
 #include <any>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,10 +20,11 @@ namespace Domain::Session
       // Operations
       std::vector<std::string> getCommands   ()                                                                     override;    // retrieves the list of actions (commands)
       std::any                 executeCommand( const std::string & command, const std::vector<std::string> & args ) override;    // executes one of the actions retrieved
-      void setSearchResult(std::vector<TechnicalServices::Persistence::JobInfo> searchResult);
+      void setSearchResult(TechnicalServices::Persistence::SearchPage searchResult, std::size_t pageStart);
       void display() override;
       void display(std::vector<TechnicalServices::Persistence::Application> appliedJobs);
       void display(int num);
+      void displayApplicants(const std::vector<TechnicalServices::Persistence::Application>& applicants, std::size_t offset);
       TechnicalServices::Persistence::JobInfo getJob(int jobId);
 
       // Destructor
@@ -40,7 +42,9 @@ namespace Domain::Session
     TechnicalServices::Logging::LoggerHandler &                _logger    = *_loggerPtr;
 
     UserCredentials const                                      _credentials;
-    std::vector<TechnicalServices::Persistence::JobInfo>       _searchResult;
+    std::vector<TechnicalServices::Persistence::JobInfo>       _searchResult;       // the current page of results only
+    TechnicalServices::Persistence::SearchCursor               _searchCursor;       // where the next page starts
+    std::size_t                                                _searchPageStart = 0;  // results before the current page
     int                                                        _selectedJobId;
     std::string     const                                      _name      = "Undefined";
     DispatchTable                                              _commandDispatch;
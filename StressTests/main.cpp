@@ -0,0 +1,278 @@
+#include <algorithm>    // max()
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <exception>
+#include <filesystem>   // create_directories(), current_path(), remove_all(), temp_directory_path()
+#include <fstream>
+#include <functional>   // function
+#include <iostream>
+#include <memory>       // make_unique()
+#include <stdexcept>    // invalid_argument
+#include <streambuf>
+#include <string>
+#include <thread>       // jthread, hardware_concurrency()
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+#include "TechnicalServices/Persistence/Versioned.hpp"
+
+
+
+
+/*******************************************************************************
+** Stress Tests
+**   Concurrent readers and writers hammering the lock-free user and application read paths for a while, each reader checking
+**   that every snapshot it sees is consistent and no older than the one before, then the writers' end result checked against
+**   what they did.  Job searches aren't among them; they share a lock with job changes.  Run by the stress executable (see
+**   Build.sh) as
+**
+**       stress [scenario [seconds [readers]]]
+**
+**   or with no scenario at all to run every scenario with its defaults.  Prints one line per scenario and exits with 1 if any
+**   check failed.
+*******************************************************************************/
+namespace
+{
+  struct Settings
+  {
+    std::chrono::seconds duration;
+    std::size_t          readers;
+    std::size_t          writers;
+  };
+
+
+  // Counts what a scenario checked and what failed, safe to add to from every thread
+  struct Tally
+  {
+    std::atomic<std::uint64_t> reads      = 0;
+    std::atomic<std::uint64_t> writes     = 0;
+    std::atomic<std::uint64_t> violations = 0;
+
+    void check( bool holds, const std::string & what )
+    {
+      if( holds ) return;
+      if( violations++ < 10 ) std::cerr << "  violated:  " << what << '\n';    // the first few say what went wrong, the rest only count
+    }
+  };
+
+
+  // Runs writers and readers threads until duration has passed, each calling its work over and over with its thread number
+  void hammer( const Settings & settings, const std::function<void( std::size_t writer )> & write, const std::function<void( std::size_t reader )> & read )
+  {
+    std::atomic<bool> stop = false;
+    {
+      std::vector<std::jthread> threads;
+      for( std::size_t writer = 0; writer != settings.writers; ++writer ) threads.emplace_back( [&, writer] { while( !stop.load( std::memory_order_relaxed ) ) write( writer ); } );
+      for( std::size_t reader = 0; reader != settings.readers; ++reader ) threads.emplace_back( [&, reader] { while( !stop.load( std::memory_order_relaxed ) ) read( reader ); } );
+
+      std::this_thread::sleep_for( settings.duration );
+      stop = true;
+    }
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Versioned
+  **   Writers publish generations of a value whose words must always agree, readers check every snapshot they take has them
+  **   agree and is no older than their last.  More readers than Versioned has slots by default, so some wait for a slot.
+  **   Every superseded generation must be reclaimed once no reader holds it.
+  ******************************************************************************/
+  struct Generation
+  {
+    inline static std::atomic<long> live = 0;    // generations not yet deleted
+
+    Generation() { ++live; }
+    Generation( const Generation & other ) : words( other.words ) { ++live; }
+    Generation & operator=( const Generation & ) = delete;
+   ~Generation() noexcept { --live; }
+
+    std::array<std::uint64_t, 16> words = {};    // two cache lines, so a torn copy would show
+  };
+
+
+  void versioned( const Settings & settings, Tally & tally )
+  {
+    {
+      TechnicalServices::Persistence::Versioned<Generation> value;
+      std::vector<std::uint64_t>                            lastSeen( settings.readers, 0 );
+
+      hammer( settings,
+        [&]( std::size_t )
+        {
+          value.update( []( Generation & next ) { for( auto & word : next.words ) ++word; return true; } );
+          ++tally.writes;
+        },
+        [&]( std::size_t reader )
+        {
+          auto snapshot = value.read();
+          auto seen     = snapshot->words.front();
+          for( auto word : snapshot->words ) tally.check( word == seen, "a snapshot's words disagree" );
+          tally.check( seen >= lastSeen[reader], "a snapshot older than the reader's last" );
+          lastSeen[reader] = seen;
+          ++tally.reads;
+        } );
+
+      // No reader is left, so the next publication reclaims every superseded generation
+      value.update( []( Generation & ) { return true; } );
+      tally.check( Generation::live == 1, std::to_string( Generation::live ) + " generations live with no reader left, not 1" );
+      tally.check( value.read()->words.front() == tally.writes, "the last generation isn't the writers' count of writes" );
+    }
+    tally.check( Generation::live == 0, std::to_string( Generation::live ) + " generations left over once the value is gone" );
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Applications
+  **   Writers apply for job after job, each as its own job seeker, and move every other application on to "interviewed".
+  **   Readers check each seeker's applications only ever grow, with no job twice, and each job's applicants are for that job.
+  **   The database is then reopened from its application log, which must hold exactly what the writers did.
+  ******************************************************************************/
+  std::string seeker( std::size_t writer ) { return "seeker" + std::to_string( writer ); }
+
+
+  void applications( const Settings & settings, Tally & tally )
+  {
+    auto directory = std::filesystem::temp_directory_path() / "eMatch-stress";
+    std::filesystem::remove_all( directory );    // left over from a run that didn't finish
+    std::filesystem::create_directories( directory );
+    auto previous = std::filesystem::current_path();
+    std::filesystem::current_path( directory );
+    {
+      std::ofstream file( "Library_System_AdaptableData.dat" );
+      file << "\"Component.Logger\" = \"Simple Logger\"\n\"Component.UI\" = \"Simple UI\"\n\"Persistence.ApplicationLog\" = \"applications.log\"\n";
+    }
+
+    std::vector<int> applied( settings.writers, 0 );    // each writer's last job applied for
+    {
+      TechnicalServices::Persistence::SimpleDB database;
+      std::vector<std::size_t>                 lastSeen( settings.readers, 0 );
+
+      hammer( settings,
+        [&]( std::size_t writer )
+        {
+          auto job = ++applied[writer];
+          tally.check( database.makeApplication( seeker( writer ), job ), "an application for a job not yet applied for was refused" );
+          if( job % 2 == 0 ) tally.check( database.updateApplicationStatus( seeker( writer ), job - 1, "interviewed" ), "a status change of an application made was refused" );
+          ++tally.writes;
+        },
+        [&]( std::size_t reader )
+        {
+          auto writer       = reader % settings.writers;
+          auto applications = database.getUserApplication( seeker( writer ) );
+          tally.check( applications.size() >= lastSeen[reader], "a seeker's applications shrank" );
+          lastSeen[reader] = applications.size();
+
+          std::vector<bool> jobs( applications.size() + 1, false );
+          for( const auto & application : applications )
+          {
+            auto job   = static_cast<std::size_t>( application.jobId );
+            bool fresh = job >= 1 && job < jobs.size() && !jobs[job];
+            tally.check( fresh, "a seeker's applications skip or repeat a job" );
+            if( fresh ) jobs[job] = true;
+            tally.check( application.status == "applied" || application.status == "interviewed", "an application has status \"" + application.status + '"' );
+          }
+
+          if( !applications.empty() )
+            for( const auto & applicant : database.getJobApplicants( applications.back().jobId, "0", 0, settings.writers ) )
+              tally.check( applicant.jobId == applications.back().jobId, "a job's applicants include another job's" );
+          ++tally.reads;
+        } );
+    }
+
+    // Everything logged survives a restart, every status change with it
+    {
+      TechnicalServices::Persistence::SimpleDB database;
+      for( std::size_t writer = 0; writer != settings.writers; ++writer )
+      {
+        auto applications = database.getUserApplication( seeker( writer ) );
+        tally.check( applications.size() == static_cast<std::size_t>( applied[writer] ), seeker( writer ) + " has " + std::to_string( applications.size() )
+                                                                                           + " applications after a restart, not " + std::to_string( applied[writer] ) );
+        for( const auto & application : applications )
+          tally.check( application.status == ( application.jobId % 2 == 1 && application.jobId < applied[writer] ? "interviewed" : "applied" ),
+                       "an application's status after a restart isn't the last one given it" );
+      }
+    }
+
+    std::filesystem::current_path( previous );
+    std::filesystem::remove_all( directory );
+  }
+
+
+
+
+  struct Scenario
+  {
+    const char * name;
+    std::size_t  readers;    // by default
+    void      ( *run )( const Settings &, Tally & );
+  };
+
+  const Scenario scenarios[] = { { "applications", 2 * std::max( 1u, std::thread::hardware_concurrency() ), applications },
+                                 { "versioned",    192,                                                     versioned    } };    // more readers than Versioned's slots
+
+
+  std::size_t count( const std::vector<std::string> & arguments, std::size_t index, std::size_t otherwise )
+  {
+    if( index >= arguments.size() ) return otherwise;
+
+    std::size_t parsed = 0;
+    auto        value  = std::stoul( arguments[index], &parsed );
+    if( parsed != arguments[index].size() ) throw std::invalid_argument( "\"" + arguments[index] + "\" isn't a count" );
+    return value;
+  }
+}    // namespace
+
+
+
+
+// Runs the scenario named by the first argument for the seconds and readers that follow, or every scenario with its defaults
+int main( int argc, char * argv[] )
+{
+  std::vector<std::string> arguments( argv + 1, argv + argc );
+
+  // Start up and shutdown logging isn't what's checked
+  struct Quiet
+  {
+    std::streambuf * log = std::clog.rdbuf( nullptr );
+    ~Quiet() { std::clog.rdbuf( log ); }
+  } quiet;
+
+  try
+  {
+    bool ran    = false;
+    bool passed = true;
+    for( const auto & scenario : scenarios )
+    {
+      if( !arguments.empty() && arguments.front() != scenario.name ) continue;
+
+      Settings settings = { std::chrono::seconds( count( arguments, 1, 5 ) ), count( arguments, 2, scenario.readers ), 2 };
+      if( settings.readers == 0 ) throw std::invalid_argument( "a scenario needs a reader" );
+
+      Tally tally;
+      scenario.run( settings, tally );
+      std::cout << scenario.name << ":  " << settings.readers << " readers made " << tally.reads << " reads, " << settings.writers << " writers made "
+                << tally.writes << " writes, " << tally.violations << " violations\n";
+      ran    = true;
+      passed = passed && tally.violations == 0;
+    }
+    if( ran ) return passed ? 0 : 1;
+  }
+  catch( const std::exception & error )
+  {
+    std::cerr << "Stress test failed: " << error.what() << '\n';
+    return 1;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " [scenario [seconds [readers]]]\n  scenarios:";
+  for( const auto & scenario : scenarios ) std::cerr << ' ' << scenario.name;
+  std::cerr << '\n';
+  return 1;
+}
@@ -0,0 +1,302 @@
+#include "TechnicalServices/Persistence/ApplicationLog.hpp"
+
+#include <chrono>
+#include <cstddef>       // size_t
+#include <cstdint>       // uint8_t, uint32_t, uint64_t
+#include <cstring>       // memcpy()
+#include <filesystem>    // exists(), resize_file()
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>       // move()
+#include <vector>
+
+#if __has_include( <unistd.h> )
+  #include <cerrno>        // errno, EINTR
+  #include <fcntl.h>       // open()
+  #include <unistd.h>      // write(), fsync(), fdatasync(), close()
+  #define APPLICATION_LOG_USES_POSIX
+#endif
+
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace
+{
+  // Record layout, in native byte order:
+  //   uint32 payload size, uint64 payload checksum, then the payload:  uint8 kind, int32 job id, uint32 size + user name,
+  //   uint32 size + status
+  constexpr std::size_t FrameSize = sizeof( std::uint32_t ) + sizeof( std::uint64_t );
+
+  template<typename T>
+  void put( std::string & buffer, T value )
+  {
+    buffer.append( reinterpret_cast<const char *>( &value ), sizeof value );
+  }
+
+  void put( std::string & buffer, const std::string & text )
+  {
+    put( buffer, static_cast<std::uint32_t>( text.size() ) );
+    buffer += text;
+  }
+
+
+
+  // Reads successive fields of one payload, failing (rather than throwing) if the payload is too short for them
+  class PayloadReader
+  {
+    public:
+      explicit PayloadReader( std::string_view payload ) : _payload( payload ) {}
+
+      template<typename T>
+      bool get( T & value )
+      {
+        if( _payload.size() < sizeof value ) return false;
+        std::memcpy( &value, _payload.data(), sizeof value );
+        _payload.remove_prefix( sizeof value );
+        return true;
+      }
+
+      bool get( std::string & text )
+      {
+        std::uint32_t size;
+        if( !get( size ) || _payload.size() < size ) return false;
+        text.assign( _payload.substr( 0, size ) );
+        _payload.remove_prefix( size );
+        return true;
+      }
+
+      bool exhausted() const { return _payload.empty(); }
+
+    private:
+      std::string_view _payload;
+  };
+
+
+
+  std::uint64_t checksumOf( std::string_view payload )
+  {
+    TechnicalServices::Persistence::SnapshotChecksum checksum;
+    checksum.update( payload.data(), payload.size() );
+    return checksum.value();
+  }
+}    // namespace
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  ApplicationLog::ApplicationLog( const std::string & path, Durability durability, std::chrono::milliseconds flushInterval )
+    : _path( path ), _durability( durability )
+  {
+    #if defined( APPLICATION_LOG_USES_POSIX )
+      _descriptor = ::open( path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644 );
+      if( _descriptor < 0 ) throw PersistenceHandler::PersistenceException( "Unable to open application log \"" + path + '"' );
+    #else
+      _file.open( path, std::ios::binary | std::ios::app );
+      if( !_file.is_open() ) throw PersistenceHandler::PersistenceException( "Unable to open application log \"" + path + '"' );
+    #endif
+
+    if( _durability == Durability::Deferred )
+    {
+      _flusher = std::jthread( [this, flushInterval]( std::stop_token stop )
+      {
+        std::unique_lock lock( _mutex );
+        while( !stop.stop_requested() )
+        {
+          _flushed.wait_for( lock, stop, flushInterval, [] { return false; } );    // only the interval or shutdown ends the wait
+          if( _flushing || _durable == _appended ) continue;
+
+          try { flush( lock ); }
+          catch( const PersistenceHandler::PersistenceException & ) {}    // _failure says why, committers report it
+        }
+      } );
+    }
+  }
+
+
+
+
+  ApplicationLog::~ApplicationLog() noexcept
+  {
+    if( _flusher.joinable() ) { _flusher.request_stop(); _flusher.join(); }
+
+    // Whatever is still buffered (Deferred durability) is written now rather than lost
+    {
+      std::unique_lock lock( _mutex );
+      while( _flushing ) _flushed.wait( lock );
+      try { if( _durable != _appended ) flush( lock ); }
+      catch( const PersistenceHandler::PersistenceException & ) {}    // nowhere left to report it
+    }
+
+    #if defined( APPLICATION_LOG_USES_POSIX )
+      ::close( _descriptor );
+    #endif
+  }
+
+
+
+
+  std::vector<ApplicationLog::Record> ApplicationLog::recover( const std::string & path )
+  {
+    std::vector<Record> records;
+    if( !std::filesystem::exists( path ) ) return records;    // nothing logged yet
+
+    std::size_t intact = 0;    // length of the log up to the end of the last intact record
+    {
+      MappedFile       file( path );
+      std::string_view log = file.contents();
+
+      while( log.size() - intact >= FrameSize )
+      {
+        std::uint32_t size;
+        std::uint64_t checksum;
+        std::memcpy( &size,     log.data() + intact,                          sizeof size     );
+        std::memcpy( &checksum, log.data() + intact + sizeof( std::uint32_t ), sizeof checksum );
+        if( log.size() - intact - FrameSize < size ) break;    // torn, the crash came before the whole record was written
+
+        auto payload = log.substr( intact + FrameSize, size );
+        if( checksumOf( payload ) != checksum ) break;
+
+        Record        record{};
+        std::uint8_t  kind;
+        std::int32_t  jobId;
+        PayloadReader reader( payload );
+        if( !reader.get( kind ) || !reader.get( jobId ) || !reader.get( record.application.userName )
+                                || !reader.get( record.application.status ) || !reader.exhausted() ) break;
+        if( kind != static_cast<std::uint8_t>( Record::Kind::Apply ) && kind != static_cast<std::uint8_t>( Record::Kind::StatusChange ) ) break;
+
+        record.kind                 = static_cast<Record::Kind>( kind );
+        record.application.jobId    = jobId;
+        records.push_back( std::move( record ) );
+        intact += FrameSize + size;
+      }
+
+      if( intact == log.size() ) return records;
+    }
+
+    // Cut the torn tail off so new records follow the last intact one instead of being hidden behind the damage
+    std::filesystem::resize_file( path, intact );
+    return records;
+  }
+
+
+
+
+  std::uint64_t ApplicationLog::append( Record::Kind kind, const Application & application )
+  {
+    std::string payload;
+    put( payload, static_cast<std::uint8_t>( kind ) );
+    put( payload, static_cast<std::int32_t>( application.jobId ) );
+    put( payload, application.userName );
+    put( payload, application.status );
+
+    std::lock_guard lock( _mutex );
+    if( !_failure.empty() ) throw PersistenceHandler::PersistenceException( _failure );
+
+    put( _buffer, static_cast<std::uint32_t>( payload.size() ) );
+    put( _buffer, checksumOf( payload ) );
+    _buffer += payload;
+    return ++_appended;
+  }
+
+
+
+
+  void ApplicationLog::commit( std::uint64_t sequence )
+  {
+    std::unique_lock lock( _mutex );
+
+    if( _durability == Durability::EveryWrite && _failure.empty() )
+    {
+      // Sync while holding the lock, so no other committer can share it
+      try
+      {
+        writeAndSync( _buffer );
+        _buffer.clear();
+        _durable = _appended;
+      }
+      catch( const PersistenceHandler::PersistenceException & error ) { _failure = error.what(); }
+    }
+
+    else if( _durability == Durability::GroupCommit )
+    {
+      while( _durable < sequence && _failure.empty() )
+      {
+        if( _flushing ) _flushed.wait( lock );    // someone else's sync may well cover this record too
+        else            flush( lock );            // lead the next group
+      }
+    }
+
+    // Deferred durability doesn't wait, the flusher will get to it
+
+    if( !_failure.empty() ) throw PersistenceHandler::PersistenceException( _failure );
+  }
+
+
+
+
+  void ApplicationLog::flush( std::unique_lock<std::mutex> & lock )
+  {
+    if( !_failure.empty() ) throw PersistenceHandler::PersistenceException( _failure );
+
+    std::string   batch    = std::move( _buffer );
+    std::uint64_t batchEnd = _appended;
+    _buffer.clear();
+    _flushing = true;
+
+    // Committers arriving during the sync append to the now empty buffer and wait for the next group
+    lock.unlock();
+    try
+    {
+      writeAndSync( batch );
+    }
+    catch( const PersistenceHandler::PersistenceException & error )
+    {
+      lock.lock();
+      _failure  = error.what();
+      _flushing = false;
+      _flushed.notify_all();
+      throw;
+    }
+    lock.lock();
+
+    _durable  = batchEnd;
+    _flushing = false;
+    _flushed.notify_all();
+  }
+
+
+
+
+  void ApplicationLog::writeAndSync( const std::string & records )
+  {
+    #if defined( APPLICATION_LOG_USES_POSIX )
+      for( std::string_view remaining = records; !remaining.empty(); )
+      {
+        auto written = ::write( _descriptor, remaining.data(), remaining.size() );
+        if( written < 0 && errno == EINTR ) continue;
+        if( written < 0 ) throw PersistenceHandler::PersistenceException( "Unable to write application log \"" + _path + '"' );
+        remaining.remove_prefix( static_cast<std::size_t>( written ) );
+      }
+
+      #if defined( __linux__ )
+        auto synced = ::fdatasync( _descriptor );    // the file's data and size, skipping timestamps
+      #else
+        auto synced = ::fsync( _descriptor );
+      #endif
+      if( synced != 0 ) throw PersistenceHandler::PersistenceException( "Unable to sync application log \"" + _path + '"' );
+
+    #else
+      _file.write( records.data(), static_cast<std::streamsize>( records.size() ) );
+      _file.flush();
+      if( !_file ) throw PersistenceHandler::PersistenceException( "Unable to write application log \"" + _path + '"' );
+    #endif
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>    // condition_variable_any
+#include <cstdint>               // uint8_t, uint64_t
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>                // jthread
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Application Log
+  **   Append only write-ahead log of changes to the job applications, replayed at start up so applications survive a restart.
+  **   Each record is framed by its length and a checksum, so a record torn by a crash part way through an append is detected
+  **   and dropped on recovery rather than misread.
+  **
+  **   Appending only buffers the record, commit() then waits until the record is as durable as the configured policy asks:
+  **     EveryWrite   each commit writes and syncs the log itself, one sync per change
+  **     GroupCommit  the first committer writes and syncs everything buffered so far while later committers wait and share
+  **                  that sync, or the next one, so concurrent changes cost one sync per batch rather than one each (default)
+  **     Deferred     commit returns at once and a background thread writes and syncs every flush interval, so a crash may
+  **                  lose up to an interval's worth of changes
+  **
+  **   A log that fails to write or sync stays failed:  the changes buffered at the time may not be durable, commit() throws for
+  **   them, and append() refuses every later change.
+  ******************************************************************************/
+  class ApplicationLog
+  {
+    public:
+      enum class Durability { EveryWrite, GroupCommit, Deferred };
+
+      struct Record
+      {
+        enum class Kind : std::uint8_t { Apply = 1, StatusChange = 2 };
+
+        Kind        kind;
+        Application application;
+      };
+
+
+      // Constructors
+      ApplicationLog( const std::string & path, Durability durability, std::chrono::milliseconds flushInterval );    // throws PersistenceException if path can't be opened
+      ApplicationLog( const ApplicationLog & ) = delete;
+      ApplicationLog & operator=( const ApplicationLog & ) = delete;
+
+
+      // Operations
+      static std::vector<Record> recover( const std::string & path );    // every intact record in order, a torn tail is truncated away
+
+      std::uint64_t append( Record::Kind kind, const Application & application );    // returns the record's sequence number, throws PersistenceException if the log has failed
+      void          commit( std::uint64_t sequence );                                // throws PersistenceException if the log can't be written
+
+
+      // Destructor
+      ~ApplicationLog() noexcept;
+
+    private:
+      void flush( std::unique_lock<std::mutex> & lock );    // writes and syncs everything buffered, releasing lock meanwhile
+      void writeAndSync( const std::string & records );
+
+      const std::string               _path;
+      const Durability                _durability;
+
+      std::mutex                      _mutex;
+      std::condition_variable_any     _flushed;              // notified whenever _durable advances
+      std::string                     _buffer;               // encoded records appended but not yet written
+      std::uint64_t                   _appended    = 0;      // sequence number of the last record appended
+      std::uint64_t                   _durable     = 0;      // sequence number of the last record synced
+      bool                            _flushing    = false;  // a committer is writing and syncing on everyone's behalf
+      std::string                     _failure;              // why the log can no longer be written, empty while healthy
+
+      int                             _descriptor  = -1;     // POSIX systems
+      std::ofstream                   _file;                 // elsewhere, flushed but not synced, the best standard C++ can do
+
+      std::jthread                    _flusher;              // Deferred durability only, declared last so it stops first
+  };    // class ApplicationLog
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,139 @@
+#include "TechnicalServices/Persistence/ApplicationStore.hpp"
+
+#include <algorithm>  // min()
+#include <cstddef>    // size_t
+#include <string>
+#include <utility>    // move()
+#include <vector>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  bool ApplicationStore::insert( Application application )
+  {
+    auto position = _applications.size();
+    if( contains( application.userName, application.jobId ) ) return false;
+    _byUserAndJob.modify( { application.userName, application.jobId } ) = position;
+
+    _byUser.modify( application.userName ).push_back( position );
+    _byJob .modify( application.jobId    ).push_back( position );
+    _byJobAndStatus.modify( { application.jobId, application.status } ).push_back( position );
+    _applications.push_back( std::move( application ) );
+    return true;
+  }
+
+
+
+
+  bool ApplicationStore::updateStatus( const std::string & userName, int jobId, const std::string & status )
+  {
+    auto entry = _byUserAndJob.find( { userName, jobId } );
+    if( entry == nullptr ) return false;
+
+    auto position    = *entry;
+    auto application = _applications[position];
+    if( application.status == status ) return true;
+
+    // Move the application between the job's status lists, keeping each in the order applied.  Status changes are far rarer
+    // than applications, so the lists are simply rebuilt around it, O(k) in the job's applications with those statuses.
+    {
+      auto &    from = _byJobAndStatus.modify( { jobId, application.status } );
+      Positions remaining;
+      for( std::size_t index = 0; index != from.size(); ++index ) if( from[index] != position ) remaining.push_back( from[index] );
+      from = std::move( remaining );
+    }
+    {
+      auto & to = _byJobAndStatus.modify( { jobId, status } );
+      if( to.empty() || to[to.size() - 1] < position ) to.push_back( position );
+      else
+      {
+        Positions merged;
+        for( std::size_t index = 0; index != to.size(); ++index )
+        {
+          if( to[index] > position && ( index == 0 || to[index - 1] < position ) ) merged.push_back( position );
+          merged.push_back( to[index] );
+        }
+        to = std::move( merged );
+      }
+    }
+
+    application.status = status;
+    _applications.set( position, std::move( application ) );
+    return true;
+  }
+
+
+
+
+  bool ApplicationStore::contains( const std::string & userName, int jobId ) const
+  {
+    return _byUserAndJob.find( { userName, jobId } ) != nullptr;
+  }
+
+
+
+
+  std::vector<Application> ApplicationStore::byUser( const std::string & userName ) const
+  {
+    std::vector<Application> results;
+
+    auto positions = _byUser.find( userName );
+    if( positions == nullptr ) return results;
+
+    results.reserve( positions->size() );
+    for( std::size_t index = 0; index != positions->size(); ++index ) results.push_back( _applications[( *positions )[index]] );
+    return results;
+  }
+
+
+
+
+  std::vector<Application> ApplicationStore::byJob( int jobId ) const
+  {
+    std::vector<Application> results;
+
+    auto positions = _byJob.find( jobId );
+    if( positions == nullptr ) return results;
+
+    results.reserve( positions->size() );
+    for( std::size_t index = 0; index != positions->size(); ++index ) results.push_back( _applications[( *positions )[index]] );
+    return results;
+  }
+
+
+
+
+  std::vector<Application> ApplicationStore::byJob( int jobId, const std::string & status, std::size_t offset, std::size_t pageSize ) const
+  {
+    std::vector<Application> results;
+
+    const Positions * positions = status.empty() ? _byJob.find( jobId ) : _byJobAndStatus.find( { jobId, status } );
+    if( positions == nullptr || offset >= positions->size() ) return results;
+
+    auto last = offset + std::min( pageSize, positions->size() - offset );
+    results.reserve( last - offset );
+    for( auto index = offset; index != last; ++index ) results.push_back( _applications[( *positions )[index]] );
+    return results;
+  }
+
+
+
+
+  std::size_t ApplicationStore::size() const
+  {
+    return _applications.size();
+  }
+
+
+
+
+  std::vector<Application> ApplicationStore::all() const
+  {
+    std::vector<Application> results;
+    results.reserve( _applications.size() );
+    for( std::size_t position = 0; position != _applications.size(); ++position ) results.push_back( _applications[position] );
+    return results;
+  }
+}    // namespace TechnicalServices::Persistence
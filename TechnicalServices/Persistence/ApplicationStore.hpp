@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>      // size_t
+#include <functional>   // hash
+#include <string>
+#include <vector>
+
+#include "TechnicalServices/Persistence/CopyOnWrite.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Application Store
+  **   Holds every job application once, in the order applied, indexed by (user, job) for duplicate detection, by user for "my
+  **   applications", and by job (and status) for the hiring side.  Each index holds positions into the store rather than copies, so applying
+  **   is O(1) and listing a user's or a job's applications is O(k) in the number listed.
+  **
+  **   Everything is held in copy on write containers, so copying a store is O(1) and the copy can be changed without disturbing
+  **   readers of the original.  Applying and listing each pick up a log32 n factor for it.
+  ******************************************************************************/
+  class ApplicationStore
+  {
+    public:
+      // Operations
+      bool                     insert  ( Application application );                                // false if the user already applied for the job
+      bool                     updateStatus( const std::string & userName, int jobId, const std::string & status );   // false if the user hasn't applied for the job
+      bool                     contains( const std::string & userName, int jobId ) const;
+      std::vector<Application> byUser  ( const std::string & userName )            const;   // in the order applied
+      std::vector<Application> byJob   ( int jobId )                               const;   // in the order applied
+
+      // Returns one page of a job's applications, optionally only those with the given status (empty means any), in the order
+      // applied.  Only the requested page is touched, however many applications the job has.
+      std::vector<Application> byJob   ( int jobId, const std::string & status, std::size_t offset, std::size_t pageSize ) const;
+      std::size_t              size    ()                                          const;
+      std::vector<Application> all     ()                                          const;   // in the order applied
+
+    private:
+      struct Key
+      {
+        std::string userName;
+        int         jobId;
+
+        bool operator==( const Key & ) const = default;
+      };
+
+      struct StatusKey
+      {
+        int         jobId;
+        std::string status;
+
+        bool operator==( const StatusKey & ) const = default;
+      };
+
+      struct KeyHash
+      {
+        std::size_t operator()( const Key & key ) const noexcept
+        {
+          return std::hash<std::string>{}( key.userName ) ^ ( std::hash<int>{}( key.jobId ) * 0x9E3779B97F4A7C15ULL );
+        }
+
+        std::size_t operator()( const StatusKey & key ) const noexcept
+        {
+          return std::hash<std::string>{}( key.status ) ^ ( std::hash<int>{}( key.jobId ) * 0x9E3779B97F4A7C15ULL );
+        }
+      };
+
+      using Positions = CopyOnWriteVector<std::size_t>;    // into _applications, ascending
+
+      CopyOnWriteVector<Application>                    _applications;     // the applications themselves
+      CopyOnWriteMap<Key,         std::size_t, KeyHash> _byUserAndJob;     // positions into _applications
+      CopyOnWriteMap<std::string, Positions>            _byUser;
+      CopyOnWriteMap<int,         Positions>            _byJob;
+      CopyOnWriteMap<StatusKey,   Positions, KeyHash>   _byJobAndStatus;
+  };    // class ApplicationStore
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,299 @@
+#include "TechnicalServices/Persistence/Autocompleter.hpp"
+
+#include <algorithm>    // find(), lower_bound(), max(), min(), mismatch(), partial_sort(), sort(), unique()
+#include <cctype>       // isalnum()
+#include <cstddef>      // ptrdiff_t, size_t
+#include <cstdint>      // uint64_t
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>      // exchange(), move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    bool wordCharacter( char character ) { return std::isalnum( static_cast<unsigned char>( character ) ) != 0; }
+  }    // namespace
+
+
+
+
+  std::vector<std::string> Autocompleter::Trie::keys( const std::string & normalized )
+  {
+    std::vector<std::string> keys;
+    for( std::size_t start = 0; start != normalized.size(); ++start )
+      if( wordCharacter( normalized[start] ) && ( start == 0 || !wordCharacter( normalized[start - 1] ) ) ) keys.push_back( normalized.substr( start ) );
+    return keys;
+  }
+
+
+
+
+  Autocompleter::ValueId Autocompleter::Trie::count( const std::string & value, std::ptrdiff_t change )
+  {
+    if( _ids.size() != _values.size() ) for( ValueId id = 0; id != _values.size(); ++id ) _ids.try_emplace( normalize( _values[id].text ), id );
+
+    // Spellings normalizing alike are one value, suggested as first spelled
+    auto [entry, added] = _ids.try_emplace( normalize( value ), static_cast<ValueId>( _values.size() ) );
+    if( added )
+    {
+      _values.push_back( { value, 0 } );
+      for( const auto & key : keys( entry->first ) ) add( key, entry->second );
+    }
+
+    // A value no job has any more keeps its keys, but drops out of every top list
+    auto & jobs = _values[entry->second].jobs;
+    jobs = static_cast<std::size_t>( std::max<std::ptrdiff_t>( static_cast<std::ptrdiff_t>( jobs ) + change, 0 ) );
+    return entry->second;
+  }
+
+
+
+
+  void Autocompleter::Trie::add( const std::string & key, ValueId value )
+  {
+    NodeId           node = 0;
+    std::string_view rest = key;
+
+    // Nodes are referred to by id throughout, as adding one may move them all
+    while( !rest.empty() )
+    {
+      auto & children = _nodes[node].children;
+      auto   child    = std::lower_bound( children.begin(), children.end(), rest.front(),
+                                          [&]( NodeId lhs, char rhs ) { return _nodes[lhs].label.front() < rhs; } );
+
+      // No key shares the next character, so the rest of this one becomes a new leaf
+      if( child == children.end() || _nodes[*child].label.front() != rest.front() )
+      {
+        auto leaf = static_cast<NodeId>( _nodes.size() );
+        children.insert( child, leaf );
+        _nodes.push_back( Node{ std::string( rest ), {}, { value }, {} } );
+        return;
+      }
+
+      // The key leaves the child's label part way along, so split the label there
+      NodeId next   = *child;
+      auto & label  = _nodes[next].label;
+      auto   common = static_cast<std::size_t>( std::mismatch( label.begin(), label.end(), rest.begin(), rest.end() ).first - label.begin() );
+      if( common != label.size() )
+      {
+        Node lower{ label.substr( common ), std::move( _nodes[next].children ), std::move( _nodes[next].ends ), _nodes[next].top };
+        _nodes[next].label.resize( common );
+        _nodes[next].children = { static_cast<NodeId>( _nodes.size() ) };
+        _nodes[next].ends.clear();
+        _nodes.push_back( std::move( lower ) );
+      }
+
+      node = next;
+      rest.remove_prefix( common );
+    }
+
+    auto & ends = _nodes[node].ends;
+    if( std::find( ends.cbegin(), ends.cend(), value ) == ends.cend() ) ends.push_back( value );
+  }
+
+
+
+
+  std::vector<Autocompleter::NodeId> Autocompleter::Trie::path( const std::string & key ) const
+  {
+    std::vector<NodeId> path = { 0 };
+    std::string_view    rest = key;
+    while( !rest.empty() )
+    {
+      const auto & children = _nodes[path.back()].children;
+      auto         child    = std::lower_bound( children.cbegin(), children.cend(), rest.front(),
+                                                [&]( NodeId lhs, char rhs ) { return _nodes[lhs].label.front() < rhs; } );
+      if( child == children.cend() || !rest.starts_with( _nodes[*child].label ) ) break;    // every key added is there
+
+      rest.remove_prefix( _nodes[*child].label.size() );
+      path.push_back( *child );
+    }
+    return path;
+  }
+
+
+
+
+  // The node's own values and its children's top lists hold every candidate for its top list
+  void Autocompleter::Trie::rank( NodeId node )
+  {
+    std::vector<ValueId> candidates;
+    for( auto value : _nodes[node].ends ) if( _values[value].jobs != 0 ) candidates.push_back( value );
+    for( auto child : _nodes[node].children ) candidates.insert( candidates.end(), _nodes[child].top.cbegin(), _nodes[child].top.cend() );
+
+    // A value may come from several children, one for each of its keys beneath the node
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    auto popular = [&]( ValueId lhs, ValueId rhs )
+    {
+      return _values[lhs].jobs > _values[rhs].jobs || ( _values[lhs].jobs == _values[rhs].jobs && _values[lhs].text < _values[rhs].text );
+    };
+    auto kept = std::min( candidates.size(), MostSuggestions );
+    std::partial_sort( candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>( kept ), candidates.end(), popular );
+    candidates.resize( kept );
+
+    _nodes[node].top = std::move( candidates );
+  }
+
+
+
+
+  void Autocompleter::Trie::refresh( std::vector<ValueId> values )
+  {
+    std::vector<char> seen( _values.size() );
+    std::erase_if( values, [&]( ValueId value ) noexcept { return std::exchange( seen[value], char{ 1 } ) != 0; } );
+
+    // A value's keys' paths are a few nodes each, so beyond a few values for every few dozen nodes it's cheaper to rank them all
+    if( values.size() * 32 < _nodes.size() )
+    {
+      for( auto value : values )
+        for( const auto & key : keys( normalize( _values[value].text ) ) )
+        {
+          auto nodes = path( key );
+          for( auto node = nodes.crbegin(); node != nodes.crend(); ++node ) rank( *node );
+        }
+      return;
+    }
+
+    // Every node in breadth first order, then ranked in reverse so children are ranked before their parents
+    std::vector<NodeId> order = { 0 };
+    for( std::size_t next = 0; next != order.size(); ++next )
+      order.insert( order.end(), _nodes[order[next]].children.cbegin(), _nodes[order[next]].children.cend() );
+    for( auto node = order.crbegin(); node != order.crend(); ++node ) rank( *node );
+  }
+
+
+
+
+  const std::vector<Autocompleter::ValueId> & Autocompleter::Trie::top( std::string_view prefix ) const
+  {
+    static const std::vector<ValueId> none;
+
+    auto             normalized = normalize( prefix );
+    std::string_view rest       = normalized;
+    NodeId           node       = 0;
+    while( !rest.empty() )
+    {
+      const auto & children = _nodes[node].children;
+      auto         child    = std::lower_bound( children.cbegin(), children.cend(), rest.front(),
+                                                [&]( NodeId lhs, char rhs ) { return _nodes[lhs].label.front() < rhs; } );
+      if( child == children.cend() ) return none;
+
+      // The prefix may end part way along a label, every key beneath it still starting with the prefix
+      std::string_view label  = _nodes[*child].label;
+      auto             length = std::min( label.size(), rest.size() );
+      if( label.substr( 0, length ) != rest.substr( 0, length ) ) return none;
+
+      rest.remove_prefix( length );
+      node = *child;
+    }
+    return _nodes[node].top;
+  }
+
+
+
+
+  void Autocompleter::insert( std::span<const JobInfo> jobs )
+  {
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+    {
+      std::vector<ValueId> counted;
+      counted.reserve( jobs.size() );
+      for( const auto & job : jobs ) counted.push_back( _tries[field].count( fieldValue( job, static_cast<JobField>( field ) ), 1 ) );
+      _tries[field].refresh( std::move( counted ) );
+    }
+  }
+
+
+
+
+  void Autocompleter::erase( const JobInfo & job )
+  {
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+      _tries[field].refresh( { _tries[field].count( fieldValue( job, static_cast<JobField>( field ) ), -1 ) } );
+  }
+
+
+
+
+  std::vector<Suggestion> Autocompleter::suggest( JobField field, std::string_view prefix, std::size_t limit ) const
+  {
+    std::vector<Suggestion> suggestions;
+    if( static_cast<std::size_t>( field ) >= JobFieldCount ) return suggestions;
+
+    const auto & trie = _tries[static_cast<std::size_t>( field )];
+    const auto & top  = trie.top( prefix );
+    for( std::size_t rank = 0; rank != top.size() && rank != limit; ++rank ) suggestions.push_back( { trie.value( top[rank] ).text, trie.value( top[rank] ).jobs } );
+    return suggestions;
+  }
+
+
+
+
+  void Autocompleter::Trie::save( SnapshotWriter & image ) const
+  {
+    image.write( std::uint64_t{ _values.size() } );
+    for( const auto & value : _values ) { image.write( value.text ); image.write( std::uint64_t{ value.jobs } ); }
+
+    image.write( std::uint64_t{ _nodes.size() } );
+    for( const auto & node : _nodes ) { image.write( node.label ); image.write( node.children ); image.write( node.ends ); image.write( node.top ); }
+  }
+
+
+
+
+  void Autocompleter::Trie::load( SnapshotReader & image )
+  {
+    *this = Trie{};
+
+    _values.resize( image.readInteger() );
+    for( auto & value : _values ) { value.text = image.readString(); value.jobs = image.readInteger(); }
+
+    _nodes.resize( image.readInteger() );
+    for( auto & node : _nodes )
+    {
+      node.label    = image.readString();
+      node.children = image.readArray<NodeId>();
+      node.ends     = image.readArray<ValueId>();
+      node.top      = image.readArray<ValueId>();
+    }
+
+    // Nodes and values are looked up by id, so make sure none refer outside them.  Only the root has no label.
+    if( _nodes.empty() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, autocompleter has no root" );
+    for( std::size_t node = 0; node != _nodes.size(); ++node )
+    {
+      bool valid = ( node == 0 ) == _nodes[node].label.empty();
+      for( auto child : _nodes[node].children ) valid = valid && child != 0 && child < _nodes.size();
+      for( const auto * values : { &_nodes[node].ends, &_nodes[node].top } )
+        for( auto value : *values ) valid = valid && value < _values.size();
+      if( !valid ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, autocompleter node out of range" );
+    }
+  }
+
+
+
+
+  void Autocompleter::save( SnapshotWriter & image ) const
+  {
+    for( const auto & trie : _tries ) trie.save( image );
+  }
+
+
+
+
+  void Autocompleter::load( SnapshotReader & image )
+  {
+    for( auto & trie : _tries ) trie.load( image );
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>        // ptrdiff_t, size_t
+#include <cstdint>        // uint32_t
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Autocompleter
+  **   Suggests the names, locations and categories of the catalog's jobs as their first few letters are typed, most common
+  **   first, so a search is for a value known to be there rather than a guess.  A value is suggested for the start of any of its
+  **   words, ignoring case, accents and spacing (see Normalization), so "bar" suggests both "Barista" and "Head Barista".
+  **
+  **   Each field's values are kept in a compressed trie (a radix tree) keyed by every word start of every value.  Each node
+  **   holds the most common values of every key beneath it, so a suggestion walks the prefix's few nodes and reads the answer
+  **   off the last, however many values the prefix leads to.  Jobs added or removed change their values' counts and refresh the
+  **   lists on just those values' paths.
+  ******************************************************************************/
+  class Autocompleter
+  {
+    public:
+      static constexpr std::size_t MostSuggestions = 10;    // kept per node
+
+
+      // Operations
+      void insert( std::span<const JobInfo> jobs );
+      void erase ( const JobInfo & job );
+
+      // Returns up to limit (at most MostSuggestions) of field's values with a word starting with prefix, most jobs first
+      std::vector<Suggestion> suggest( JobField field, std::string_view prefix, std::size_t limit ) const;
+
+      // Snapshot image support, load() replaces the autocompleter's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      using NodeId  = std::uint32_t;
+      using ValueId = std::uint32_t;
+
+      struct Value
+      {
+        std::string text;
+        std::size_t jobs = 0;
+      };
+
+      struct Node
+      {
+        std::string          label;       // the key characters leading here from the parent
+        std::vector<NodeId>  children;    // ordered by their labels' first characters
+        std::vector<ValueId> ends;        // values with a key ending here
+        std::vector<ValueId> top;         // the most common values with a key here or beneath, most jobs first
+      };
+
+      class Trie
+      {
+        public:
+          // Changes value's count of jobs by change, returning its id.  A new value's keys are added, but no top list is
+          // refreshed until refresh() is called.
+          ValueId count( const std::string & value, std::ptrdiff_t change );
+
+          // Refreshes the top lists on the paths to values' keys, or every top list if that's less work
+          void refresh( std::vector<ValueId> values );
+
+          const std::vector<ValueId> & top  ( std::string_view prefix ) const;    // empty if no key starts with prefix
+          const Value                & value( ValueId id )              const { return _values[id]; }
+
+          // Snapshot image support, the nodes are saved as they are so a restore doesn't add every key again
+          void save( SnapshotWriter & image ) const;
+          void load( SnapshotReader & image );
+
+        private:
+          static std::vector<std::string> keys( const std::string & normalized );    // one per word start
+
+          void                add ( const std::string & key, ValueId value );
+          std::vector<NodeId> path( const std::string & key ) const;    // from the root to key's node
+          void                rank( NodeId node );
+
+          std::vector<Node>                        _nodes = { Node{} };    // the root first
+          std::vector<Value>                       _values;
+          std::unordered_map<std::string, ValueId> _ids;    // by normalized value, rebuilt on the first count() after a load()
+      };
+
+      std::array<Trie, JobFieldCount> _tries;
+  };    // class Autocompleter
+}    // namespace TechnicalServices::Persistence
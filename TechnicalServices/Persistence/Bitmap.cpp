@@ -0,0 +1,334 @@
+#include "TechnicalServices/Persistence/Bitmap.hpp"
+
+#include <algorithm>    // lower_bound(), set_intersection(), set_union()
+#include <bit>          // popcount(), countr_zero()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint16_t, uint32_t, uint64_t
+#include <initializer_list>
+#include <iterator>     // back_inserter()
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Chunk level operations
+  ******************************************************************************/
+  void Bitmap::Chunk::add( std::uint16_t low )
+  {
+    if( dense() )
+    {
+      auto & word = bits.writable()[low / 64];
+      auto   mask = std::uint64_t{ 1 } << ( low % 64 );
+      if( ( word & mask ) == 0 ) { word |= mask; ++cardinality; }
+      return;
+    }
+
+    // Rows are normally added in ascending order, so appending is the common case
+    if( array.empty() || array.back() < low ) array.push_back( low );
+    else
+    {
+      auto & sorted   = array.writable();
+      auto   position = std::lower_bound( sorted.begin(), sorted.end(), low );
+      if( *position == low ) return;
+      sorted.insert( position, low );
+    }
+
+    ++cardinality;
+    if( array.size() > MaxArraySize ) densify();
+  }
+
+
+
+
+  bool Bitmap::Chunk::contains( std::uint16_t low ) const
+  {
+    if( dense() ) return ( bits[low / 64] >> ( low % 64 ) ) & 1;
+    return std::binary_search( array.cbegin(), array.cend(), low );
+  }
+
+
+
+
+  void Bitmap::Chunk::densify()
+  {
+    std::vector<std::uint64_t> set( Words, 0 );
+    for( auto low : array ) set[low / 64] |= std::uint64_t{ 1 } << ( low % 64 );
+
+    bits  = std::move( set );
+    array = {};
+  }
+
+
+
+
+  void Bitmap::Chunk::compact()
+  {
+    if( !dense() || cardinality > MaxArraySize ) return;
+
+    std::vector<std::uint16_t> sorted;
+    sorted.reserve( cardinality );
+    for( std::size_t word = 0; word != Words; ++word )
+      for( auto remaining = bits[word]; remaining != 0; remaining &= remaining - 1 )
+        sorted.push_back( static_cast<std::uint16_t>( word * 64 + static_cast<std::size_t>( std::countr_zero( remaining ) ) ) );
+
+    array = std::move( sorted );
+    bits  = {};
+  }
+
+
+
+
+  Bitmap::Chunk Bitmap::intersect( const Chunk & lhs, const Chunk & rhs )
+  {
+    Chunk result;
+    result.key = lhs.key;
+
+    if( lhs.dense() && rhs.dense() )
+    {
+      auto & bits = result.bits.writable();
+      bits.resize( Chunk::Words );
+      for( std::size_t word = 0; word != Chunk::Words; ++word )
+      {
+        bits[word]          = lhs.bits[word] & rhs.bits[word];
+        result.cardinality += static_cast<std::size_t>( std::popcount( bits[word] ) );
+      }
+      result.compact();
+    }
+    else if( lhs.dense() || rhs.dense() )
+    {
+      const auto & sparse = lhs.dense() ? rhs : lhs;
+      const auto & dense  = lhs.dense() ? lhs : rhs;
+      for( auto low : sparse.array ) if( dense.contains( low ) ) result.array.push_back( low );
+      result.cardinality = result.array.size();
+    }
+    else
+    {
+      std::set_intersection( lhs.array.cbegin(), lhs.array.cend(), rhs.array.cbegin(), rhs.array.cend(), std::back_inserter( result.array.writable() ) );
+      result.cardinality = result.array.size();
+    }
+
+    return result;
+  }
+
+
+
+
+  Bitmap::Chunk Bitmap::unite( const Chunk & lhs, const Chunk & rhs )
+  {
+    Chunk result;
+    result.key = lhs.key;
+
+    if( !lhs.dense() && !rhs.dense() && lhs.cardinality + rhs.cardinality <= Chunk::MaxArraySize )
+    {
+      std::set_union( lhs.array.cbegin(), lhs.array.cend(), rhs.array.cbegin(), rhs.array.cend(), std::back_inserter( result.array.writable() ) );
+      result.cardinality = result.array.size();
+      return result;
+    }
+
+    auto & bits = result.bits.writable();
+    bits.assign( Chunk::Words, 0 );
+    for( const auto * chunk : { &lhs, &rhs } )
+    {
+      if( chunk->dense() ) for( std::size_t word = 0; word != Chunk::Words; ++word ) bits[word] |= chunk->bits[word];
+      else                 for( auto low : chunk->array ) bits[low / 64] |= std::uint64_t{ 1 } << ( low % 64 );
+    }
+    for( auto word : bits ) result.cardinality += static_cast<std::size_t>( std::popcount( word ) );
+
+    result.compact();
+    return result;
+  }
+
+
+
+
+  std::size_t Bitmap::intersectionCardinality( const Chunk & lhs, const Chunk & rhs )
+  {
+    std::size_t count = 0;
+
+    if( lhs.dense() && rhs.dense() )
+    {
+      for( std::size_t word = 0; word != Chunk::Words; ++word ) count += static_cast<std::size_t>( std::popcount( lhs.bits[word] & rhs.bits[word] ) );
+    }
+    else if( lhs.dense() || rhs.dense() )
+    {
+      const auto & sparse = lhs.dense() ? rhs : lhs;
+      const auto & dense  = lhs.dense() ? lhs : rhs;
+      for( auto low : sparse.array ) count += dense.contains( low ) ? 1 : 0;
+    }
+    else
+    {
+      for( auto l = lhs.array.cbegin(), r = rhs.array.cbegin(); l != lhs.array.cend() && r != rhs.array.cend(); )
+      {
+        if     ( *l < *r ) ++l;
+        else if( *r < *l ) ++r;
+        else             { ++count; ++l; ++r; }
+      }
+    }
+
+    return count;
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Bitmap level operations
+  ******************************************************************************/
+  void Bitmap::add( RowId row )
+  {
+    auto key = static_cast<std::uint16_t>( row >> 16 );
+
+    if( _chunks.empty() || _chunks.back().key < key )
+    {
+      _chunks.emplace_back();
+      _chunks.back().key = key;
+      _chunks.back().add( static_cast<std::uint16_t>( row ) );
+      return;
+    }
+
+    auto chunk = std::lower_bound( _chunks.begin(), _chunks.end(), key, []( const Chunk & c, std::uint16_t k ) { return c.key < k; } );
+    if( chunk == _chunks.end() || chunk->key != key )
+    {
+      chunk = _chunks.emplace( chunk );
+      chunk->key = key;
+    }
+    chunk->add( static_cast<std::uint16_t>( row ) );
+  }
+
+
+
+
+  bool Bitmap::contains( RowId row ) const
+  {
+    auto key   = static_cast<std::uint16_t>( row >> 16 );
+    auto chunk = std::lower_bound( _chunks.cbegin(), _chunks.cend(), key, []( const Chunk & c, std::uint16_t k ) { return c.key < k; } );
+    return chunk != _chunks.cend() && chunk->key == key && chunk->contains( static_cast<std::uint16_t>( row ) );
+  }
+
+
+
+
+  std::size_t Bitmap::cardinality() const
+  {
+    std::size_t count = 0;
+    for( const auto & chunk : _chunks ) count += chunk.cardinality;
+    return count;
+  }
+
+
+
+
+  PostingList Bitmap::rows() const
+  {
+    PostingList result;
+    result.reserve( cardinality() );
+
+    for( const auto & chunk : _chunks )
+    {
+      RowId high = RowId{ chunk.key } << 16;
+
+      if( !chunk.dense() ) for( auto low : chunk.array ) result.push_back( high | low );
+      else
+      {
+        for( std::size_t word = 0; word != Chunk::Words; ++word )
+          for( auto remaining = chunk.bits[word]; remaining != 0; remaining &= remaining - 1 )
+            result.push_back( high | static_cast<RowId>( word * 64 + static_cast<std::size_t>( std::countr_zero( remaining ) ) ) );
+      }
+    }
+
+    return result;
+  }
+
+
+
+
+  void Bitmap::save( SnapshotWriter & image ) const
+  {
+    image.write( std::uint64_t{ _chunks.size() } );
+    for( const auto & chunk : _chunks )
+    {
+      image.write( std::uint64_t{ chunk.key } );
+      image.write( std::uint64_t{ chunk.cardinality } );
+      if( chunk.dense() ) image.write( chunk.bits  );
+      else                image.write( chunk.array );
+    }
+  }
+
+
+
+
+  void Bitmap::load( SnapshotReader & image )
+  {
+    _chunks.clear();
+    _chunks.resize( image.readInteger() );
+    for( auto & chunk : _chunks )
+    {
+      chunk.key         = static_cast<std::uint16_t>( image.readInteger() );
+      chunk.cardinality = image.readInteger();
+      if( chunk.cardinality > Chunk::MaxArraySize ) chunk.bits  = image.viewArray<std::uint64_t>();
+      else                                          chunk.array = image.viewArray<std::uint16_t>();
+
+      if( ( chunk.dense() && chunk.bits.size() != Chunk::Words ) || ( !chunk.dense() && chunk.array.size() != chunk.cardinality ) )
+        throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, malformed bitmap" );
+    }
+  }
+
+
+
+
+  Bitmap operator&( const Bitmap & lhs, const Bitmap & rhs )
+  {
+    Bitmap result;
+    for( auto l = lhs._chunks.cbegin(), r = rhs._chunks.cbegin(); l != lhs._chunks.cend() && r != rhs._chunks.cend(); )
+    {
+      if     ( l->key < r->key ) ++l;
+      else if( r->key < l->key ) ++r;
+      else
+      {
+        auto chunk = Bitmap::intersect( *l++, *r++ );
+        if( chunk.cardinality != 0 ) result._chunks.push_back( std::move( chunk ) );
+      }
+    }
+    return result;
+  }
+
+
+
+
+  Bitmap operator|( const Bitmap & lhs, const Bitmap & rhs )
+  {
+    Bitmap result;
+    auto l = lhs._chunks.cbegin();
+    auto r = rhs._chunks.cbegin();
+
+    while( l != lhs._chunks.cend() || r != rhs._chunks.cend() )
+    {
+      if     ( r == rhs._chunks.cend() || ( l != lhs._chunks.cend() && l->key < r->key ) ) result._chunks.push_back( *l++ );
+      else if( l == lhs._chunks.cend() || r->key < l->key                                ) result._chunks.push_back( *r++ );
+      else                                                                                  result._chunks.push_back( Bitmap::unite( *l++, *r++ ) );
+    }
+    return result;
+  }
+
+
+
+
+  std::size_t intersectionCardinality( const Bitmap & lhs, const Bitmap & rhs )
+  {
+    std::size_t count = 0;
+    for( auto l = lhs._chunks.cbegin(), r = rhs._chunks.cbegin(); l != lhs._chunks.cend() && r != rhs._chunks.cend(); )
+    {
+      if     ( l->key < r->key ) ++l;
+      else if( r->key < l->key ) ++r;
+      else                       count += Bitmap::intersectionCardinality( *l++, *r++ );
+    }
+    return count;
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>    // size_t
+#include <cstdint>    // uint16_t, uint32_t, uint64_t
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  class SnapshotReader;
+  class SnapshotWriter;
+
+
+  /*****************************************************************************
+  ** Bitmap
+  **   Compressed set of rows in the style of a Roaring bitmap.  The 32 bit row space is split into chunks of 65536 rows keyed by
+  **   the high 16 bits.  Each chunk holds the low 16 bits of its rows either as a sorted array (sparse chunks) or as a plain
+  **   65536 bit set (dense chunks), whichever is smaller, so memory stays proportional to the number of rows set while
+  **   intersections of dense facets run a word at a time.  A bitmap restored from a snapshot image reads its chunks in place
+  **   (see MappedArray) until a row is added to them.
+  ******************************************************************************/
+  class Bitmap
+  {
+    public:
+      // Operations
+      void        add        ( RowId row );
+      bool        contains   ( RowId row ) const;
+      std::size_t cardinality()            const;
+      PostingList rows       ()            const;    // ascending
+
+      friend Bitmap      operator&( const Bitmap & lhs, const Bitmap & rhs );
+      friend Bitmap      operator|( const Bitmap & lhs, const Bitmap & rhs );
+      friend std::size_t intersectionCardinality( const Bitmap & lhs, const Bitmap & rhs );    // |lhs & rhs| without building it
+
+      // Snapshot image support
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      struct Chunk
+      {
+        static constexpr std::size_t MaxArraySize = 4096;                   // beyond this a 8 KiB bit set is smaller than the array
+        static constexpr std::size_t Words        = 65536 / 64;
+
+        std::uint16_t              key         = 0;                        // high 16 bits of the rows in this chunk
+        std::size_t                cardinality = 0;
+        MappedArray<std::uint16_t> array;                                  // sparse representation, sorted
+        MappedArray<std::uint64_t> bits;                                   // dense representation, empty unless dense
+
+        bool dense   () const { return !bits.empty(); }
+        void add     ( std::uint16_t low );
+        bool contains( std::uint16_t low ) const;
+        void densify ();
+        void compact ();                                                   // back to an array if cardinality allows
+      };
+
+      static Chunk       intersect              ( const Chunk & lhs, const Chunk & rhs );
+      static Chunk       unite                  ( const Chunk & lhs, const Chunk & rhs );
+      static std::size_t intersectionCardinality( const Chunk & lhs, const Chunk & rhs );
+
+      std::vector<Chunk> _chunks;                                          // sorted by key
+  };    // class Bitmap
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,581 @@
+#include "TechnicalServices/Persistence/BulkImporter.hpp"
+
+#include <algorithm>     // max(), min(), all_of(), move()
+#include <charconv>      // from_chars()
+#include <chrono>
+#include <cmath>         // abs()
+#include <cstddef>       // size_t
+#include <cstdint>       // uint32_t
+#include <iomanip>       // setprecision()
+#include <iterator>      // back_inserter()
+#include <sstream>       // ostringstream
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>       // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace    // anonymous (private) working area
+{
+  using TechnicalServices::Persistence::Application;
+  using TechnicalServices::Persistence::JobInfo;
+  using TechnicalServices::Persistence::Place;
+  using TechnicalServices::Persistence::UserCredentials;
+
+  enum class Format { CSV, JSONLines };
+
+
+  bool parseInteger( std::string_view text, int & destination )
+  {
+    auto [end, error] = std::from_chars( text.data(), text.data() + text.size(), destination );
+    return error == std::errc() && end == text.data() + text.size();
+  }
+
+
+  bool parseNumber( std::string_view text, double & destination )
+  {
+    auto [end, error] = std::from_chars( text.data(), text.data() + text.size(), destination );
+    return error == std::errc() && end == text.data() + text.size();
+  }
+
+
+
+
+  /*****************************************************************************
+  ** CSV Fields
+  **   Walks the comma separated fields of one line, decoding each directly into its destination
+  ******************************************************************************/
+  class CsvFields
+  {
+    public:
+      explicit CsvFields( std::string_view line ) : _rest( line ) {}
+
+      bool next( std::string & destination )
+      {
+        std::string_view raw;
+        bool             quoted;
+        if( !nextRaw( raw, quoted ) ) return false;
+
+        if( !quoted ) destination.assign( raw );
+        else          unquote( raw, destination );
+        return true;
+      }
+
+      bool next( int & destination )
+      {
+        std::string_view raw;
+        bool             quoted;
+        return nextRaw( raw, quoted ) && parseInteger( raw, destination );
+      }
+
+      bool next( double & destination )
+      {
+        std::string_view raw;
+        bool             quoted;
+        return nextRaw( raw, quoted ) && parseNumber( raw, destination );
+      }
+
+      bool next( std::vector<std::string> & destination, char separator )
+      {
+        std::string_view raw;
+        bool             quoted;
+        if( !nextRaw( raw, quoted ) ) return false;
+
+        destination.clear();
+        while( !raw.empty() )
+        {
+          auto piece = raw.substr( 0, raw.find( separator ) );
+          raw.remove_prefix( std::min( raw.size(), piece.size() + 1 ) );
+
+          if( piece.empty() ) continue;
+          if( !quoted ) destination.emplace_back( piece );
+          else          unquote( piece, destination.emplace_back() );
+        }
+        return true;
+      }
+
+      bool atEnd() const { return _done; }
+
+    private:
+      static void unquote( std::string_view raw, std::string & destination )
+      {
+        destination.clear();
+        destination.reserve( raw.size() );
+        for( std::size_t i = 0; i != raw.size(); ++i )
+        {
+          destination += raw[i];
+          if( raw[i] == '"' ) ++i;    // "" encodes one quote
+        }
+      }
+
+      bool nextRaw( std::string_view & raw, bool & quoted )
+      {
+        if( _done ) return false;
+
+        std::size_t end;    // one past the field, where the comma or end of line is expected
+        quoted = !_rest.empty() && _rest.front() == '"';
+        if( quoted )
+        {
+          std::size_t close = 1;
+          while( close < _rest.size() && ( _rest[close] != '"' || ( close + 1 < _rest.size() && _rest[close + 1] == '"' ) ) )
+            close += _rest[close] == '"' ? 2 : 1;
+          if( close >= _rest.size() ) return false;    // unterminated quote
+
+          raw = _rest.substr( 1, close - 1 );
+          end = close + 1;
+          if( end != _rest.size() && _rest[end] != ',' ) return false;    // text after the closing quote
+        }
+        else
+        {
+          end = std::min( _rest.find( ',' ), _rest.size() );
+          raw = _rest.substr( 0, end );
+        }
+
+        if( end == _rest.size() ) _done = true;
+        else                      _rest.remove_prefix( end + 1 );
+        return true;
+      }
+
+      std::string_view _rest;
+      bool             _done = false;
+  };
+
+
+
+
+  /*****************************************************************************
+  ** JSON Members
+  **   Walks the members of one flat JSON object, decoding values directly into their destinations.  Nested values of members
+  **   that aren't wanted are skipped.
+  ******************************************************************************/
+  class JsonMembers
+  {
+    public:
+      explicit JsonMembers( std::string_view line ) : _text( line ) { _open = consume( '{' ); }
+
+      // Positions at the next member's value and returns its key, false once the object is closed or is malformed
+      bool nextKey( std::string_view & key )
+      {
+        if( !_open ) return false;
+        if( consume( '}' ) ) { _open = false; _closed = true; return false; }
+        if( !_first && !consume( ',' ) ) { _open = false; return false; }
+        _first = false;
+
+        skipWhitespace();
+        if( !peek( '"' ) ) { _open = false; return false; }
+        auto end = _text.find( '"', _position + 1 );
+        if( end == std::string_view::npos ) { _open = false; return false; }
+
+        key       = _text.substr( _position + 1, end - _position - 1 );
+        _position = end + 1;
+        if( !consume( ':' ) ) { _open = false; return false; }
+        return true;
+      }
+
+      bool value( std::string & destination )
+      {
+        destination.clear();
+        return string( destination );
+      }
+
+      bool value( int & destination )
+      {
+        skipWhitespace();
+        auto begin = _position;
+        while( _position < _text.size() && ( _text[_position] == '-' || ( _text[_position] >= '0' && _text[_position] <= '9' ) ) ) ++_position;
+        return parseInteger( _text.substr( begin, _position - begin ), destination );
+      }
+
+      bool value( double & destination )
+      {
+        skipWhitespace();
+        auto begin = _position;
+        while( _position < _text.size() && std::string_view( "+-.0123456789eE" ).find( _text[_position] ) != std::string_view::npos ) ++_position;
+        return parseNumber( _text.substr( begin, _position - begin ), destination );
+      }
+
+      bool value( std::vector<std::string> & destination )
+      {
+        destination.clear();
+        if( !consume( '[' ) ) return false;
+        if( consume( ']' ) )  return true;
+        do
+        {
+          if( !string( destination.emplace_back() ) ) return false;
+        } while( consume( ',' ) );
+        return consume( ']' );
+      }
+
+      bool skipValue()
+      {
+        skipWhitespace();
+        int depth = 0;
+        while( _position < _text.size() )
+        {
+          char c = _text[_position];
+          if( c == '"' ) { std::string ignored; if( !string( ignored ) ) return false; }
+          else
+          {
+            if( depth == 0 && ( c == ',' || c == '}' || c == ']' ) ) return true;
+            if( c == '{' || c == '[' ) ++depth;
+            if( c == '}' || c == ']' ) --depth;
+            ++_position;
+          }
+        }
+        return false;
+      }
+
+      // True if the object was closed properly and nothing but whitespace follows it
+      bool finished()
+      {
+        skipWhitespace();
+        return _closed && _position == _text.size();
+      }
+
+    private:
+      void skipWhitespace()
+      {
+        while( _position < _text.size() && ( _text[_position] == ' ' || _text[_position] == '\t' || _text[_position] == '\r' ) ) ++_position;
+      }
+
+      bool peek( char c ) const { return _position < _text.size() && _text[_position] == c; }
+
+      bool consume( char c )
+      {
+        skipWhitespace();
+        if( !peek( c ) ) return false;
+        ++_position;
+        return true;
+      }
+
+      static void appendUtf8( std::uint32_t codePoint, std::string & destination )
+      {
+        if( codePoint < 0x80 )    destination += static_cast<char>( codePoint );
+        else if( codePoint < 0x800 )
+        {
+          destination += static_cast<char>( 0xC0 | ( codePoint >> 6 ) );
+          destination += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+        }
+        else if( codePoint < 0x10000 )
+        {
+          destination += static_cast<char>( 0xE0 | ( codePoint >> 12 ) );
+          destination += static_cast<char>( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+          destination += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+        }
+        else
+        {
+          destination += static_cast<char>( 0xF0 | ( codePoint >> 18 ) );
+          destination += static_cast<char>( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+          destination += static_cast<char>( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+          destination += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+        }
+      }
+
+      bool hex4( std::uint32_t & codePoint )
+      {
+        if( _position + 4 > _text.size() ) return false;
+        auto [end, error] = std::from_chars( _text.data() + _position, _text.data() + _position + 4, codePoint, 16 );
+        if( error != std::errc() || end != _text.data() + _position + 4 ) return false;
+        _position += 4;
+        return true;
+      }
+
+      // Appends the decoded string value at the current position to destination
+      bool string( std::string & destination )
+      {
+        if( !consume( '"' ) ) return false;
+
+        while( _position < _text.size() )
+        {
+          // Copy runs of plain characters at once
+          auto run = _text.find_first_of( "\"\\", _position );
+          if( run == std::string_view::npos ) return false;
+          destination.append( _text.substr( _position, run - _position ) );
+          _position = run + 1;
+
+          if( _text[run] == '"' ) return true;
+          if( _position == _text.size() ) return false;
+
+          switch( _text[_position++] )
+          {
+            case '"':  destination += '"';  break;
+            case '\\': destination += '\\'; break;
+            case '/':  destination += '/';  break;
+            case 'b':  destination += '\b'; break;
+            case 'f':  destination += '\f'; break;
+            case 'n':  destination += '\n'; break;
+            case 'r':  destination += '\r'; break;
+            case 't':  destination += '\t'; break;
+            case 'u':
+            {
+              std::uint32_t codePoint;
+              if( !hex4( codePoint ) ) return false;
+              if( codePoint >= 0xD800 && codePoint < 0xDC00 && _text.substr( _position, 2 ) == "\\u" )    // surrogate pair
+              {
+                std::uint32_t low;
+                _position += 2;
+                if( !hex4( low ) ) return false;
+                codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+              }
+              appendUtf8( codePoint, destination );
+              break;
+            }
+            default:   return false;
+          }
+        }
+        return false;
+      }
+
+      std::string_view _text;
+      std::size_t      _position = 0;
+      bool             _open     = false;
+      bool             _closed   = false;
+      bool             _first    = true;
+  };
+
+
+
+
+  /*****************************************************************************
+  ** Record parsers, one per record type and format.  Each returns false if the line isn't a valid record.
+  ******************************************************************************/
+  bool parse( Format format, std::string_view line, JobInfo & job )
+  {
+    if( format == Format::CSV )
+    {
+      CsvFields fields( line );
+      return fields.next( job.id )       && fields.next( job.name )        && fields.next( job.location ) && fields.next( job.category )
+          && fields.next( job.type )     && fields.next( job.description ) && fields.next( job.qualification )
+          && fields.next( job.salary )   && fields.atEnd();
+    }
+
+    JsonMembers members( line );
+    bool        haveId = false;
+    for( std::string_view key; members.nextKey( key ); )
+    {
+      bool parsed = key == "id"            ? ( haveId = members.value( job.id ) )
+                  : key == "name"          ? members.value( job.name          )
+                  : key == "location"      ? members.value( job.location      )
+                  : key == "category"      ? members.value( job.category      )
+                  : key == "type"          ? members.value( job.type          )
+                  : key == "description"   ? members.value( job.description   )
+                  : key == "qualification" ? members.value( job.qualification )
+                  : key == "salary"        ? members.value( job.salary        )
+                  :                          members.skipValue();
+      if( !parsed ) return false;
+    }
+    return haveId && members.finished();
+  }
+
+
+  bool parse( Format format, std::string_view line, UserCredentials & user )
+  {
+    if( format == Format::CSV )
+    {
+      CsvFields fields( line );
+      return fields.next( user.userName ) && fields.next( user.passPhrase ) && fields.next( user.roles, ';' ) && fields.atEnd();
+    }
+
+    JsonMembers members( line );
+    for( std::string_view key; members.nextKey( key ); )
+    {
+      bool parsed = key == "userName"   ? members.value( user.userName   )
+                  : key == "passPhrase" ? members.value( user.passPhrase )
+                  : key == "roles"      ? members.value( user.roles      )
+                  :                       members.skipValue();
+      if( !parsed ) return false;
+    }
+    return !user.userName.empty() && members.finished();
+  }
+
+
+  bool parse( Format format, std::string_view line, Application & application )
+  {
+    if( format == Format::CSV )
+    {
+      CsvFields fields( line );
+      return fields.next( application.userName ) && fields.next( application.jobId ) && fields.next( application.status ) && fields.atEnd();
+    }
+
+    JsonMembers members( line );
+    bool        haveJobId = false;
+    for( std::string_view key; members.nextKey( key ); )
+    {
+      bool parsed = key == "userName" ? members.value( application.userName )
+                  : key == "jobId"    ? ( haveJobId = members.value( application.jobId ) )
+                  : key == "status"   ? members.value( application.status )
+                  :                     members.skipValue();
+      if( !parsed ) return false;
+    }
+    return !application.userName.empty() && haveJobId && members.finished();
+  }
+
+
+  bool parse( Format format, std::string_view line, Place & place )
+  {
+    if( format == Format::CSV )
+    {
+      CsvFields fields( line );
+      return fields.next( place.name ) && fields.next( place.latitude ) && fields.next( place.longitude ) && fields.atEnd()
+          && !place.name.empty() && std::abs( place.latitude ) <= 90 && std::abs( place.longitude ) <= 180;
+    }
+
+    JsonMembers members( line );
+    bool        haveLatitude = false, haveLongitude = false;
+    for( std::string_view key; members.nextKey( key ); )
+    {
+      bool parsed = key == "name"      ? members.value( place.name )
+                  : key == "latitude"  ? ( haveLatitude  = members.value( place.latitude  ) )
+                  : key == "longitude" ? ( haveLongitude = members.value( place.longitude ) )
+                  :                      members.skipValue();
+      if( !parsed ) return false;
+    }
+    return !place.name.empty() && haveLatitude && haveLongitude && std::abs( place.latitude ) <= 90 && std::abs( place.longitude ) <= 180
+        && members.finished();
+  }
+
+
+
+
+  Format formatOf( const std::string & path )
+  {
+    for( std::string_view extension : { ".jsonl", ".ndjson", ".json" } )
+      if( std::string_view( path ).ends_with( extension ) ) return Format::JSONLines;
+    return Format::CSV;
+  }
+}    // anonymous (private) working area
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  BulkImporter::BulkImporter( unsigned threads ) : _threads( std::max( threads, 1U ) )
+  {}
+
+
+
+
+  template<typename Record>
+  std::vector<Record> BulkImporter::import( const std::string & path )
+  {
+    constexpr std::size_t minimumChunkSize = 1 << 20;    // smaller chunks cost more to start a thread for than to parse
+
+    auto       start  = std::chrono::steady_clock::now();
+    auto       format = formatOf( path );
+    MappedFile file( path );
+    auto       text   = file.contents();
+
+
+    // Split the text into one chunk per thread, each ending just after a line break so no line straddles two chunks
+    auto chunkCount = static_cast<std::size_t>( std::min<std::size_t>( _threads, std::max<std::size_t>( text.size() / minimumChunkSize, 1 ) ) );
+    std::vector<std::string_view> chunks;
+    for( std::size_t begin = 0, i = 1; begin < text.size(); ++i )
+    {
+      auto end = i == chunkCount ? text.size() : std::max( begin, text.size() * i / chunkCount );
+      end      = std::min( text.find( '\n', end ), text.size() );
+      end      = std::min( end + 1, text.size() );
+      chunks.push_back( text.substr( begin, end - begin ) );
+      begin = end;
+    }
+
+
+    // Parse the chunks in parallel, each into its own list of records
+    std::vector<std::vector<Record>> parsed  ( chunks.size() );
+    std::vector<std::size_t>         rejected( chunks.size(), 0 );
+    {
+      auto parseChunk = [&]( std::size_t chunk )
+      {
+        auto    rest = chunks[chunk];
+        Record  record;
+        while( !rest.empty() )
+        {
+          auto line = rest.substr( 0, rest.find( '\n' ) );
+          rest.remove_prefix( std::min( rest.size(), line.size() + 1 ) );
+          if( line.ends_with( '\r' ) ) line.remove_suffix( 1 );
+          if( std::all_of( line.cbegin(), line.cend(), []( char c ) { return c == ' ' || c == '\t'; } ) ) continue;
+
+          record = Record{};
+          if( parse( format, line, record ) ) parsed[chunk].push_back( std::move( record ) );
+          else                                ++rejected[chunk];
+        }
+      };
+
+      std::vector<std::jthread> workers;
+      for( std::size_t chunk = 1; chunk < chunks.size(); ++chunk ) workers.emplace_back( parseChunk, chunk );
+      if( !chunks.empty() ) parseChunk( 0 );
+    }    // workers join here
+
+
+    // Stitch the chunks back together in file order
+    std::size_t total = 0;
+    for( const auto & records : parsed ) total += records.size();
+
+    std::vector<Record> results;
+    results.reserve( total );
+    for( auto & records : parsed ) std::move( records.begin(), records.end(), std::back_inserter( results ) );
+
+    _statistics          = {};
+    _statistics.bytes    = text.size();
+    _statistics.records  = results.size();
+    for( auto count : rejected ) _statistics.rejected += count;
+    _statistics.elapsed  = std::chrono::steady_clock::now() - start;
+
+    return results;
+  }
+
+
+
+
+  std::vector<JobInfo> BulkImporter::importJobs( const std::string & path )
+  {
+    return import<JobInfo>( path );
+  }
+
+
+
+
+  std::vector<UserCredentials> BulkImporter::importUsers( const std::string & path )
+  {
+    return import<UserCredentials>( path );
+  }
+
+
+
+
+  std::vector<Application> BulkImporter::importApplications( const std::string & path )
+  {
+    return import<Application>( path );
+  }
+
+
+
+
+  std::vector<Place> BulkImporter::importPlaces( const std::string & path )
+  {
+    return import<Place>( path );
+  }
+
+
+
+
+  std::string BulkImporter::summary( const std::string & path, const Statistics & statistics )
+  {
+    using Seconds = std::chrono::duration<double>;
+    auto seconds  = std::chrono::duration_cast<Seconds>( statistics.elapsed ).count();
+    auto mebibytes = static_cast<double>( statistics.bytes ) / ( 1024.0 * 1024.0 );
+
+    std::ostringstream message;
+    message << std::fixed << std::setprecision( 1 )
+            << "Imported " << statistics.records << " records (" << statistics.rejected << " rejected) from \"" << path << "\", "
+            << mebibytes << " MiB in " << seconds * 1000.0 << " ms";
+    if( seconds > 0.0 ) message << " (" << mebibytes / seconds << " MiB/s)";
+    return message.str();
+  }
+}    // namespace TechnicalServices::Persistence
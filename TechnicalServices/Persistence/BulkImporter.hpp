@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>    // size_t
+#include <string>
+#include <thread>     // hardware_concurrency()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Bulk Importer
+  **   Loads job, user and application catalogs, and gazetteers, exported as CSV or JSON Lines (chosen by a ".jsonl", ".ndjson" or ".json" file
+  **   extension, CSV otherwise).  The file is mapped into memory and split at line boundaries into one chunk per thread, each
+  **   chunk is parsed in parallel straight from the mapped bytes into its records, and the chunks are concatenated in file order.
+  **   Fields are decoded directly into the records' strings, so no temporary string is made per field.
+  **
+  **   Expected layouts, one record per line:
+  **     Jobs          CSV:   id,name,location,category,type,description,qualification,salary
+  **                   JSON:  {"id":1,"name":"...","location":"...","category":"...","type":"...","description":"...", ...}
+  **     Users         CSV:   userName,passPhrase,role;role;...
+  **                   JSON:  {"userName":"...","passPhrase":"...","roles":["...", ...]}
+  **     Applications  CSV:   userName,jobId,status
+  **                   JSON:  {"userName":"...","jobId":1,"status":"..."}
+  **     Places        CSV:   name,latitude,longitude
+  **                   JSON:  {"name":"...","latitude":33.87,"longitude":-117.92}
+  **   CSV fields may be double quoted (with "" for a quote) but may not span lines.  A CSV header line, blank lines, and lines that
+  **   can't be parsed are skipped and counted as rejected.
+  **
+  **   Throws PersistenceHandler::PersistenceException if the file can't be read.
+  ******************************************************************************/
+  class BulkImporter
+  {
+    public:
+      struct Statistics
+      {
+        std::size_t                         bytes    = 0;
+        std::size_t                         records  = 0;
+        std::size_t                         rejected = 0;
+        std::chrono::steady_clock::duration elapsed  = {};
+      };
+
+
+      // Constructors
+      explicit BulkImporter( unsigned threads = std::thread::hardware_concurrency() );
+
+
+      // Operations
+      std::vector<JobInfo>         importJobs        ( const std::string & path );
+      std::vector<UserCredentials> importUsers       ( const std::string & path );
+      std::vector<Application>     importApplications( const std::string & path );
+      std::vector<Place>           importPlaces      ( const std::string & path );
+
+      const Statistics & statistics() const { return _statistics; }    // of the most recent import
+
+      static std::string summary( const std::string & path, const Statistics & statistics );      // for logging
+
+    private:
+      template<typename Record>
+      std::vector<Record> import( const std::string & path );
+
+      unsigned   _threads;
+      Statistics _statistics;
+  };    // class BulkImporter
+}    // namespace TechnicalServices::Persistence
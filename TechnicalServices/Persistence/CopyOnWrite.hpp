@@ -0,0 +1,269 @@
+#pragma once
+
+#include <atomic>       // atomic_thread_fence()
+#include <bit>          // popcount()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t
+#include <functional>   // hash
+#include <limits>       // numeric_limits
+#include <memory>       // shared_ptr, make_shared()
+#include <utility>      // move(), pair
+#include <vector>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Copy On Write Vector and Map
+  **   Containers whose copies share structure.  Elements live in small segments at the leaves of a shallow 32 way tree, and a
+  **   change copies only the segment it touches and that segment's ancestors, leaving everything else shared with the other
+  **   copies.  So copying a container is O(1), a change to a copy is O(log32 n), and no change to one copy is ever seen by
+  **   another, which is what lets readers keep using an old version while a writer builds the next (see Versioned).
+  **
+  **   A node held by only one container is changed in place rather than copied, so a run of changes to a fresh copy (a bulk load,
+  **   say) copies each node at most once.  Like the standard containers, any number of threads may read a container no thread
+  **   is changing.
+  ******************************************************************************/
+  namespace CopyOnWrite
+  {
+    // Returns node ready to change, first copying it if other containers share it
+    template<typename Node>
+    Node & writable( std::shared_ptr<Node> & node )
+    {
+      if     ( node == nullptr       ) node = std::make_shared<Node>();
+      else if( node.use_count() != 1 ) node = std::make_shared<Node>( *node );
+      else std::atomic_thread_fence( std::memory_order_acquire );    // whoever shared it last has finished reading it
+
+      return *node;
+    }
+
+    constexpr unsigned    Bits  = 5;
+    constexpr std::size_t Width = std::size_t{ 1 } << Bits;    // children per branch, elements per leaf
+    constexpr std::size_t Mask  = Width - 1;
+  }    // namespace CopyOnWrite
+
+
+
+
+  template<typename T>
+  class CopyOnWriteVector
+  {
+    public:
+      // Operations
+      std::size_t size () const { return _size;      }
+      bool        empty() const { return _size == 0; }
+
+      const T & operator[]( std::size_t index ) const;
+      void      push_back ( T value );
+      void      set       ( std::size_t index, T value );
+
+    private:
+      struct Node
+      {
+        std::vector<std::shared_ptr<Node>> children;    // branches only
+        std::vector<T>                     values;      // leaves only
+      };
+
+      std::shared_ptr<Node> _root;
+      std::size_t           _size  = 0;
+      unsigned              _shift = 0;    // levels of branches above the leaves, times Bits
+  };    // class CopyOnWriteVector
+
+
+
+
+  template<typename Key, typename Value, typename Hash = std::hash<Key>>
+  class CopyOnWriteMap
+  {
+    public:
+      // Operations
+      std::size_t   size() const { return _size; }
+      const Value * find( const Key & key ) const;    // nullptr if absent
+
+      // Returns key's value ready to change, inserting a default constructed one if absent.  The reference is good until the map
+      // next changes.
+      Value & modify( const Key & key );
+
+      template<typename Function>
+      void forEach( Function && function ) const { if( _root ) forEach( *_root, function ); }    // calls function( key, value ), in no particular order
+
+    private:
+      // Hash array mapped trie:  a branch holds only the children that exist, picked by 5 bits of the key's hash per level, and a leaf
+      // holds a few entries whose hashes share those bits so far
+      struct Node
+      {
+        bool                                branch = false;
+        std::uint32_t                       bitmap = 0;    // branches:  which of the Width children exist
+        std::vector<std::shared_ptr<Node>>  children;      // branches:  those children, in bit order
+        std::vector<std::pair<Key, Value>>  entries;       // leaves
+      };
+
+      static constexpr std::size_t LeafCapacity = 8;
+
+      static std::uint32_t bit ( std::size_t hash, unsigned shift ) { return std::uint32_t{ 1 } << ( ( hash >> shift ) & CopyOnWrite::Mask ); }
+      static std::size_t   slot( const Node & node, std::uint32_t bit ) { return static_cast<std::size_t>( std::popcount( node.bitmap & ( bit - 1 ) ) ); }
+
+      static void split( Node & leaf, unsigned shift );    // turns a full leaf into a branch
+
+      template<typename Function>
+      static void forEach( const Node & node, Function & function );
+
+      std::shared_ptr<Node> _root;
+      std::size_t           _size = 0;
+  };    // class CopyOnWriteMap
+
+
+
+
+
+
+
+
+  /*****************************************************************************
+  ** Copy On Write Vector - Template implementation
+  ******************************************************************************/
+  template<typename T>
+  const T & CopyOnWriteVector<T>::operator[]( std::size_t index ) const
+  {
+    const Node * node = _root.get();
+    for( auto shift = _shift; shift != 0; shift -= CopyOnWrite::Bits ) node = node->children[( index >> shift ) & CopyOnWrite::Mask].get();
+    return node->values[index & CopyOnWrite::Mask];
+  }
+
+
+
+
+  template<typename T>
+  void CopyOnWriteVector<T>::push_back( T value )
+  {
+    // Full, so grow a level at the top
+    if( _root != nullptr && _size == CopyOnWrite::Width << _shift )
+    {
+      auto root = std::make_shared<Node>();
+      root->children.push_back( std::move( _root ) );
+      _root   = std::move( root );
+      _shift += CopyOnWrite::Bits;
+    }
+
+    Node * node = &CopyOnWrite::writable( _root );
+    for( auto shift = _shift; shift != 0; shift -= CopyOnWrite::Bits )
+    {
+      auto slot = ( _size >> shift ) & CopyOnWrite::Mask;
+      if( slot == node->children.size() ) node->children.emplace_back();
+      node = &CopyOnWrite::writable( node->children[slot] );
+    }
+
+    node->values.push_back( std::move( value ) );
+    ++_size;
+  }
+
+
+
+
+  template<typename T>
+  void CopyOnWriteVector<T>::set( std::size_t index, T value )
+  {
+    Node * node = &CopyOnWrite::writable( _root );
+    for( auto shift = _shift; shift != 0; shift -= CopyOnWrite::Bits ) node = &CopyOnWrite::writable( node->children[( index >> shift ) & CopyOnWrite::Mask] );
+    node->values[index & CopyOnWrite::Mask] = std::move( value );
+  }
+
+
+
+
+
+
+
+
+  /*****************************************************************************
+  ** Copy On Write Map - Template implementation
+  ******************************************************************************/
+  template<typename Key, typename Value, typename Hash>
+  const Value * CopyOnWriteMap<Key, Value, Hash>::find( const Key & key ) const
+  {
+    auto         hash = Hash{}( key );
+    const Node * node = _root.get();
+    for( unsigned shift = 0; node != nullptr && node->branch; shift += CopyOnWrite::Bits )
+    {
+      auto which = bit( hash, shift );
+      if( ( node->bitmap & which ) == 0 ) return nullptr;
+      node = node->children[slot( *node, which )].get();
+    }
+    if( node == nullptr ) return nullptr;
+
+    for( const auto & entry : node->entries ) if( entry.first == key ) return &entry.second;
+    return nullptr;
+  }
+
+
+
+
+  template<typename Key, typename Value, typename Hash>
+  Value & CopyOnWriteMap<Key, Value, Hash>::modify( const Key & key )
+  {
+    auto     hash  = Hash{}( key );
+    Node *   node  = &CopyOnWrite::writable( _root );
+    unsigned shift = 0;
+    while( true )
+    {
+      if( !node->branch )
+      {
+        for( auto & entry : node->entries ) if( entry.first == key ) return entry.second;
+
+        // Hashes that agree in every bit can't be told apart by splitting, so such a leaf just grows
+        if( node->entries.size() < LeafCapacity || shift + CopyOnWrite::Bits > std::numeric_limits<std::size_t>::digits )
+        {
+          ++_size;
+          return node->entries.emplace_back( key, Value{} ).second;
+        }
+        split( *node, shift );
+      }
+
+      auto which = bit( hash, shift );
+      auto index = slot( *node, which );
+      if( ( node->bitmap & which ) == 0 )
+      {
+        node->bitmap |= which;
+        node->children.emplace( node->children.begin() + static_cast<std::ptrdiff_t>( index ) );
+      }
+      node   = &CopyOnWrite::writable( node->children[index] );
+      shift += CopyOnWrite::Bits;
+    }
+  }
+
+
+
+
+  template<typename Key, typename Value, typename Hash>
+  void CopyOnWriteMap<Key, Value, Hash>::split( Node & leaf, unsigned shift )
+  {
+    auto entries = std::move( leaf.entries );
+    leaf.entries.clear();
+    leaf.branch = true;
+
+    for( auto & entry : entries )
+    {
+      auto which = bit( Hash{}( entry.first ), shift );
+      auto index = slot( leaf, which );
+      if( ( leaf.bitmap & which ) == 0 )
+      {
+        leaf.bitmap |= which;
+        leaf.children.insert( leaf.children.begin() + static_cast<std::ptrdiff_t>( index ), std::make_shared<Node>() );
+      }
+      leaf.children[index]->entries.push_back( std::move( entry ) );
+    }
+  }
+
+
+
+
+  template<typename Key, typename Value, typename Hash>
+  template<typename Function>
+  void CopyOnWriteMap<Key, Value, Hash>::forEach( const Node & node, Function & function )
+  {
+    for( const auto & child : node.children ) forEach( *child, function );
+    for( const auto & [key, value] : node.entries ) function( key, value );
+  }
+}    // namespace TechnicalServices::Persistence
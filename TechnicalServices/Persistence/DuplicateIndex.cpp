@@ -0,0 +1,372 @@
+#include "TechnicalServices/Persistence/DuplicateIndex.hpp"
+
+#include <algorithm>    // find_if(), is_sorted(), lower_bound(), min(), sort()
+#include <array>
+#include <bit>          // bit_width(), has_single_bit()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint16_t, uint32_t, uint64_t
+#include <limits>
+#include <numeric>      // iota()
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>       // hardware_concurrency(), jthread
+#include <utility>      // exchange(), swap()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    constexpr std::size_t shingleLength = 5;
+    constexpr std::size_t mostLeaders   = 8;     // distinct originals a run of equal band values is compared against
+
+    // splitmix64's finalizer, every input bit affecting every output bit
+    std::uint64_t mix( std::uint64_t value )
+    {
+      value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+      value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+      return value ^ ( value >> 31 );
+    }
+
+    // Stable, so entries listed in catalog order are left in order of key then position.  Sixteen bits of the key a pass.
+    template<typename Entry>
+    void sortByKey( std::vector<Entry> & entries )
+    {
+      std::vector<Entry> sorted( entries.size() );
+      for( unsigned shift = 0; shift != 32; shift += 16 )
+      {
+        std::vector<std::size_t> starts( ( 1U << 16 ) + 1 );
+        for( const auto & entry : entries ) ++starts[( entry.key >> shift & 0xFFFFU ) + 1];
+        for( std::size_t digit = 1; digit != starts.size(); ++digit ) starts[digit] += starts[digit - 1];
+        for( const auto & entry : entries ) sorted[starts[entry.key >> shift & 0xFFFFU]++] = entry;
+        entries.swap( sorted );
+      }
+    }
+
+
+
+
+    std::uint64_t hash( std::string_view text )
+    {
+      std::uint64_t hash = text.size();
+      for( auto character : text ) hash = mix( hash ^ static_cast<unsigned char>( character ) );
+      return hash;
+    }
+  }    // namespace
+
+
+
+
+  DuplicateIndex::Signature DuplicateIndex::signature( const JobInfo & job )
+  {
+    // The text that's worded, the facets only decide which jobs are comparable, so they season every bin instead
+    std::string text;
+    for( const auto * field : { &job.name, &job.type, &job.description, &job.qualification, &job.salary } ) ( text += normalize( *field ) ) += '\n';
+    auto facets = hash( normalize( job.location ) + '\n' + normalize( job.category ) );
+
+    // One permutation hashing:  the top bits of a shingle's hash pick its bin, the rest compete for the bin's minimum.  The
+    // shingle rolls along the text a character at a time, its characters packed into an integer.
+    static_assert( std::has_single_bit( Bins ), "bins are picked by a shingle hash's top bits" );
+    constexpr auto        binBits     = std::numeric_limits<std::uint64_t>::digits - std::bit_width( Bins - 1 );
+    constexpr std::uint64_t shingleMask = ( std::uint64_t{ 1 } << ( 8 * shingleLength ) ) - 1;
+
+    std::array<std::uint64_t, Bins> minimums;
+    minimums.fill( std::numeric_limits<std::uint64_t>::max() );
+
+    std::uint64_t shingle = 0;
+    for( std::size_t next = 0; next != text.size(); ++next )
+    {
+      shingle = ( shingle << 8 | static_cast<unsigned char>( text[next] ) ) & shingleMask;
+      if( next + 1 < shingleLength ) continue;
+
+      auto   hashed = mix( shingle );
+      auto & bin    = minimums[hashed >> binBits];
+      bin           = std::min( bin, hashed & ( ( std::uint64_t{ 1 } << binBits ) - 1 ) );
+    }
+
+    // A bin no shingle fell in borrows from the next one that has, offset by how far it reached, so short texts still compare
+    Signature signature;
+    for( std::size_t bin = 0; bin != Bins; ++bin )
+    {
+      std::size_t reach = 0;
+      while( reach != Bins && minimums[( bin + reach ) % Bins] == std::numeric_limits<std::uint64_t>::max() ) ++reach;
+
+      auto minimum   = reach == Bins ? std::uint64_t{ 0 } : minimums[( bin + reach ) % Bins] + reach;
+      signature[bin] = static_cast<std::uint16_t>( mix( minimum ^ facets ) );
+    }
+    return signature;
+  }
+
+
+
+
+  std::uint32_t DuplicateIndex::key( const Signature & signature, std::size_t band )
+  {
+    std::uint64_t bins = 0;
+    for( std::size_t bin = band * BandWidth; bin != ( band + 1 ) * BandWidth; ++bin ) bins = bins << 16 | signature[bin];
+    return static_cast<std::uint32_t>( mix( bins ) );
+  }
+
+
+
+
+  bool DuplicateIndex::similar( const Signature & lhs, const Signature & rhs )
+  {
+    std::size_t agreements = 0;
+    for( std::size_t bin = 0; bin != Bins; ++bin ) agreements += lhs[bin] == rhs[bin] ? 1 : 0;
+    return agreements >= Agreements;
+  }
+
+
+
+
+  std::optional<RowId> DuplicateIndex::lookup( const Signature & signature, RowId position ) const
+  {
+    std::optional<RowId> earliest;
+    auto consider = [&]( RowId candidate )
+    {
+      if( candidate >= position || _originals[candidate] != candidate || ( earliest && *earliest <= candidate ) ) return;
+      if( similar( _signatures[candidate], signature ) ) earliest = candidate;
+    };
+
+    for( std::size_t band = 0; band != Bands; ++band )
+    {
+      auto value = key( signature, band );
+      for( auto filed = std::lower_bound( _filed[band].cbegin(), _filed[band].cend(), Filed{ value, 0 } );
+           filed != _filed[band].cend() && filed->key == value; ++filed ) consider( filed->position );
+
+      auto [first, last] = _added[band].equal_range( value );
+      for( auto added = first; added != last; ++added ) consider( added->second );
+    }
+    return earliest;
+  }
+
+
+
+
+  void DuplicateIndex::file( RowId position )
+  {
+    for( std::size_t band = 0; band != Bands; ++band ) _added[band].emplace( key( _signatures[position], band ), position );
+  }
+
+
+
+
+  void DuplicateIndex::append( std::span<const JobInfo> jobs, std::size_t firstPosition )
+  {
+    auto   first      = static_cast<RowId>( firstPosition );
+    auto & signatures = _signatures.writable();
+    signatures.resize( firstPosition + jobs.size() );
+    _originals.resize( firstPosition + jobs.size() );
+
+    // A few jobs are looked up one at a time, cheaper than regrouping every filed original with them
+    if( jobs.size() * 32 < firstPosition )
+    {
+      for( std::size_t job = 0; job != jobs.size(); ++job )
+      {
+        auto position = static_cast<RowId>( first + job );
+        signatures[position] = signature( jobs[job] );
+        _originals[position] = lookup( signatures[position], position ).value_or( position );
+        if( _originals[position] == position ) file( position );
+      }
+      return;
+    }
+
+
+    // Sign the jobs in parallel, each thread a contiguous share of them
+    {
+      auto threads = std::min<std::size_t>( std::max( 1U, std::thread::hardware_concurrency() ), std::max<std::size_t>( jobs.size(), 1 ) );
+      std::vector<std::jthread> signers;
+      for( std::size_t thread = 0; thread != threads; ++thread ) signers.emplace_back( [&, thread]
+      {
+        for( auto job = jobs.size() * thread / threads; job != jobs.size() * ( thread + 1 ) / threads; ++job ) signatures[first + job] = signature( jobs[job] );
+      } );
+    }
+
+
+    // Each band, in parallel, sorts the new jobs with the originals already filed by band value.  Within a run of equal values,
+    // in catalog order, each job is compared with the run's first few distinct originals, and linked to the first it nearly
+    // duplicates.
+    struct Link
+    {
+      RowId original;
+      RowId copy;    // one of the new jobs
+    };
+
+    std::array<std::vector<Filed>, Bands> grouped;
+    std::array<std::vector<Link>,  Bands> links;
+    {
+      std::vector<std::jthread> banders;
+      for( std::size_t band = 0; band != Bands; ++band ) banders.emplace_back( [&, band]
+      {
+        auto & filed = grouped[band];
+        filed.reserve( _originals.size() );
+        for( RowId position = 0; position != _originals.size(); ++position )
+          if( position >= first || _originals[position] == position ) filed.push_back( { key( _signatures[position], band ), position } );
+        sortByKey( filed );
+
+        std::vector<RowId> leaders;
+        for( std::size_t entry = 0; entry != filed.size(); ++entry )
+        {
+          if( entry == 0 || filed[entry].key != filed[entry - 1].key ) leaders.clear();
+
+          auto position = filed[entry].position;
+          auto leader   = std::find_if( leaders.cbegin(), leaders.cend(), [&]( RowId candidate ) { return similar( _signatures[candidate], _signatures[position] ); } );
+          if     ( leader != leaders.cend() ) { if( position >= first ) links[band].push_back( { *leader, position } ); }
+          else if( leaders.size() != mostLeaders ) leaders.push_back( position );
+        }
+      } );
+    }
+
+
+    // Join the links into groups, each rooted at its earliest new job, and each new job's original is the earliest of its group's
+    // root and any filed original linked to the group
+    std::vector<RowId> roots( jobs.size() );
+    std::vector<RowId> anchors( jobs.size(), Erased );
+    std::iota( roots.begin(), roots.end(), RowId{ 0 } );
+    auto root = [&]( RowId job )
+    {
+      while( roots[job] != job ) job = roots[job] = roots[roots[job]];
+      return job;
+    };
+
+    for( const auto & band : links )
+      for( const auto & link : band )
+      {
+        auto copy = root( link.copy - first );
+        if( link.original < first ) { anchors[copy] = std::min( anchors[copy], link.original ); continue; }
+
+        auto original = root( link.original - first );
+        if( original == copy ) continue;
+        if( original > copy ) std::swap( original, copy );
+        roots  [copy]     = original;
+        anchors[original] = std::min( anchors[original], anchors[copy] );
+      }
+
+    for( RowId job = 0; job != jobs.size(); ++job )
+    {
+      auto group = root( job );
+      _originals[first + job] = std::min( anchors[group], first + group );
+    }
+
+
+    // Only the originals stay filed, including those added one at a time since the last bulk load
+    for( std::size_t band = 0; band != Bands; ++band )
+    {
+      std::erase_if( grouped[band], [&]( const Filed & entry ) noexcept { return _originals[entry.position] != entry.position; } );
+      _filed[band] = std::move( grouped[band] );
+      _added[band].clear();
+    }
+  }
+
+
+
+
+  void DuplicateIndex::erase( RowId position )
+  {
+    if( position >= _originals.size() || _originals[position] == Erased ) return;
+
+    auto original = std::exchange( _originals[position], Erased );
+    if( original != position ) return;
+
+    // The earliest copy takes the original's place for the rest, all of them later than the original
+    std::optional<RowId> successor;
+    for( auto copy = position + 1; copy < _originals.size(); ++copy )
+      if( _originals[copy] == position )
+      {
+        if( !successor ) successor = copy;
+        _originals[copy] = *successor;
+      }
+    if( successor ) file( *successor );
+  }
+
+
+
+
+  std::size_t DuplicateIndex::copies() const
+  {
+    std::size_t copies = 0;
+    for( RowId position = 0; position != _originals.size(); ++position ) copies += _originals[position] != position && _originals[position] != Erased ? 1 : 0;
+    return copies;
+  }
+
+
+
+
+  std::optional<RowId> DuplicateIndex::original( RowId position ) const
+  {
+    if( position >= _originals.size() || _originals[position] == Erased || _originals[position] == position ) return std::nullopt;
+    return _originals[position];
+  }
+
+
+
+
+  std::optional<RowId> DuplicateIndex::find( const JobInfo & job ) const
+  {
+    return lookup( signature( job ), Erased );
+  }
+
+
+
+
+  std::vector<RowId> DuplicateIndex::group( RowId position ) const
+  {
+    std::vector<RowId> group;
+    if( position >= _originals.size() || _originals[position] == Erased ) return group;
+
+    // Copies are never filed, so the group is found by scanning for them
+    auto original = _originals[position];
+    for( auto member = original; member != _originals.size(); ++member ) if( _originals[member] == original ) group.push_back( member );
+    return group;
+  }
+
+
+
+
+  void DuplicateIndex::save( SnapshotWriter & image ) const
+  {
+    image.write( _signatures );
+    image.write( _originals  );
+
+    // Those added one at a time are saved sorted in with the rest
+    for( std::size_t band = 0; band != Bands; ++band )
+    {
+      std::vector<Filed> filed;
+      for( const auto & entry : _filed[band] ) if( _originals[entry.position] == entry.position ) filed.push_back( entry );
+      for( const auto & [value, position] : _added[band] ) if( _originals[position] == position ) filed.push_back( { value, position } );
+      std::sort( filed.begin(), filed.end() );
+      image.write( filed );
+    }
+  }
+
+
+
+
+  void DuplicateIndex::load( SnapshotReader & image )
+  {
+    _signatures = image.viewArray<Signature>();
+    _originals  = image.readArray<RowId>();
+    if( _originals.size() != _signatures.size() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, duplicate index columns differ in length" );
+
+    // An original is always earlier than its copies, and every position read indexes the columns
+    for( RowId position = 0; position != _originals.size(); ++position )
+      if( _originals[position] != Erased && _originals[position] > position ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, duplicate original out of range" );
+
+    for( std::size_t band = 0; band != Bands; ++band )
+    {
+      _filed[band] = image.viewArray<Filed>();
+      _added[band].clear();
+      for( const auto & entry : _filed[band] ) if( entry.position >= _originals.size() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, filed duplicate out of range" );
+      if( !std::is_sorted( _filed[band].cbegin(), _filed[band].cend() ) ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, filed duplicates out of order" );
+    }
+  }
+}    // namespace TechnicalServices::Persistence
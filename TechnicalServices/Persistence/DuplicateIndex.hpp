@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>        // size_t
+#include <cstdint>        // uint16_t, uint32_t
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Duplicate Index
+  **   Finds job postings that nearly duplicate an earlier one, such as the same job posted again with its wording touched up.
+  **   Jobs are kept by catalog position, and every job is either an original or a copy of the earliest original it nearly
+  **   duplicates.  Two jobs are near duplicates if they share location and category and most of their text's five character
+  **   shingles (its overlapping five character runs, normalized, see Normalization).
+  **
+  **   Each job's shingles are summarized by a MinHash signature, one hash per shingle spread over Bins bins, each bin keeping the
+  **   smallest hash it's given, so two jobs' signatures agree in about the same share of bins as their shingle sets overlap.
+  **   Some of each signature's bins are cut into Bands bands, and an original is filed under each band's value (locality
+  **   sensitive hashing):  a near duplicate very likely agrees with it in all of some band, so only the few originals filed with
+  **   one of a new job's band values are compared with it, however big the catalog.  The comparison takes every bin, so jobs
+  **   merely sharing a band are told apart.
+  **
+  **   Jobs loaded in bulk are signed in parallel and grouped a band at a time in parallel, sorting each band's values so equal
+  **   ones fall together, rather than looked up one by one.
+  ******************************************************************************/
+  class DuplicateIndex
+  {
+    public:
+      static constexpr std::size_t Bins       = 32;
+      static constexpr std::size_t Bands      = 4;
+      static constexpr std::size_t BandWidth  = 4;     // bins, the bands covering the first Bands * BandWidth bins
+      static constexpr std::size_t Agreements = 24;    // bins agreeing, of Bins, for jobs to be near duplicates
+
+      using Signature = std::array<std::uint16_t, Bins>;
+
+
+      // Operations
+      static Signature signature( const JobInfo & job );
+
+      // Adds jobs at consecutive catalog positions from firstPosition (which must be size()) on, each finding its original
+      // among the jobs before it
+      void append( std::span<const JobInfo> jobs, std::size_t firstPosition );
+      void erase ( RowId position );    // a removed original's earliest copy becomes the original of the rest
+
+      std::size_t          size    ()                       const { return _originals.size(); }    // catalog positions, erased included
+      std::size_t          copies  ()                       const;                                 // of the jobs not erased
+      std::optional<RowId> original( RowId position )       const;    // the job's original, none if it's one itself or is erased
+      std::optional<RowId> find    ( const JobInfo & job )  const;    // the original job would be a copy of, none if it'd be one itself
+      std::vector<RowId>   group   ( RowId position )       const;    // the job, its original and every other copy, ascending
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      static constexpr RowId Erased = ~RowId{ 0 };
+
+      struct Filed
+      {
+        std::uint32_t key;         // a band's bins hashed together
+        RowId         position;
+
+        friend bool operator<( const Filed & lhs, const Filed & rhs ) { return lhs.key < rhs.key || ( lhs.key == rhs.key && lhs.position < rhs.position ); }
+      };
+
+      static std::uint32_t key    ( const Signature & signature, std::size_t band );
+      static bool          similar( const Signature & lhs, const Signature & rhs );
+
+      // The earliest original filed under one of signature's band values and similar to it, before position
+      std::optional<RowId> lookup( const Signature & signature, RowId position ) const;
+      void                 file  ( RowId position );    // under each of its band values, as an original added one at a time
+
+      MappedArray<Signature> _signatures;    // by catalog position
+      std::vector<RowId>     _originals;     // by catalog position, a job's own if it's an original, Erased if erased
+
+      // Originals by band value, those loaded in bulk sorted, those added since in a hash table.  An erased original stays filed
+      // until the next bulk load, skipped when found.
+      std::array<MappedArray<Filed>, Bands>                                _filed;
+      std::array<std::unordered_multimap<std::uint32_t, RowId>, Bands>     _added;
+  };    // class DuplicateIndex
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,115 @@
+#include "TechnicalServices/Persistence/FacetIndex.hpp"
+
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+#include <initializer_list>
+#include <string>
+
+#include "TechnicalServices/Persistence/Bitmap.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  bool FacetIndex::faceted( JobField field )
+  {
+    return field == JobField::Location || field == JobField::Category;
+  }
+
+
+
+
+  const FacetIndex::Facets & FacetIndex::facets( JobField field ) const
+  {
+    return field == JobField::Location ? _locations : _categories;
+  }
+
+
+
+
+  FacetIndex::Facets & FacetIndex::facets( JobField field )
+  {
+    return field == JobField::Location ? _locations : _categories;
+  }
+
+
+
+
+  void FacetIndex::insert( RowId row, const JobInfo & job )
+  {
+    _locations [job.location].add( row );
+    _categories[job.category].add( row );
+    ++_rows;
+  }
+
+
+
+
+  Bitmap FacetIndex::matching( JobField field, const std::string & criterion ) const
+  {
+    Bitmap result;
+    for( const auto & [value, rows] : facets( field ) ) if( value.find( criterion ) != std::string::npos ) result = result | rows;
+    return result;
+  }
+
+
+
+
+  // A row has one value per field, so the rows of the values containing criterion never overlap
+  std::size_t FacetIndex::cardinality( JobField field, const std::string & criterion ) const
+  {
+    std::size_t rows = 0;
+    for( const auto & [value, bitmap] : facets( field ) ) if( value.find( criterion ) != std::string::npos ) rows += bitmap.cardinality();
+    return rows;
+  }
+
+
+
+
+  std::size_t FacetIndex::count( const std::string & location, const std::string & category ) const
+  {
+    auto locationRows = _locations .find( location );
+    auto categoryRows = _categories.find( category );
+
+    if( location.empty() && category.empty() ) return _rows;
+    if( location.empty() ) return categoryRows == _categories.cend() ? 0 : categoryRows->second.cardinality();
+    if( category.empty() ) return locationRows == _locations .cend() ? 0 : locationRows->second.cardinality();
+
+    if( locationRows == _locations.cend() || categoryRows == _categories.cend() ) return 0;
+    return intersectionCardinality( locationRows->second, categoryRows->second );
+  }
+
+
+
+
+  void FacetIndex::save( SnapshotWriter & image ) const
+  {
+    image.write( std::uint64_t{ _rows } );
+    for( auto field : { JobField::Location, JobField::Category } )
+    {
+      image.write( std::uint64_t{ facets( field ).size() } );
+      for( const auto & [value, rows] : facets( field ) ) { image.write( value ); rows.save( image ); }
+    }
+  }
+
+
+
+
+  void FacetIndex::load( SnapshotReader & image )
+  {
+    _rows = image.readInteger();
+    for( auto field : { JobField::Location, JobField::Category } )
+    {
+      auto & values = facets( field );
+      values.clear();
+      for( auto count = image.readInteger(); count != 0; --count )
+      {
+        auto value = values.emplace_hint( values.end(), image.readString(), Bitmap{} );
+        value->second.load( image );
+      }
+    }
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>    // size_t
+#include <map>
+#include <string>
+
+#include "TechnicalServices/Persistence/Bitmap.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Facet Index
+  **   Keeps one compressed bitmap of rows per distinct location and per distinct category.  These fields have few distinct
+  **   values, so a substring criterion is answered exactly by uniting the bitmaps of the values containing it, "category X in
+  **   location Y" becomes a bitmap AND, and facet counts fall out of the bitmap cardinalities.  Jobs are inserted, and criteria
+  **   and facets given, normalized (see Normalization).
+  ******************************************************************************/
+  class FacetIndex
+  {
+    public:
+      // Operations
+      void insert( RowId row, const JobInfo & job );                                               // rows must be inserted in ascending order
+
+      static bool faceted( JobField field );                                                       // true for Location and Category
+
+      // Returns exactly the rows whose faceted field contains criterion as a substring, or just how many there are
+      Bitmap      matching   ( JobField field, const std::string & criterion ) const;
+      std::size_t cardinality( JobField field, const std::string & criterion ) const;
+
+      // Returns the number of rows having exactly this location and category, an empty value matches any
+      std::size_t count( const std::string & location, const std::string & category ) const;
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      using Facets = std::map<std::string /*Value*/, Bitmap>;
+
+      const Facets & facets( JobField field ) const;
+      Facets       & facets( JobField field );
+
+      Facets      _locations;
+      Facets      _categories;
+      std::size_t _rows = 0;
+  };    // class FacetIndex
+}    // namespace TechnicalServices::Persistence
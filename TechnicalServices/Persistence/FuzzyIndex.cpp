@@ -0,0 +1,264 @@
+#include "TechnicalServices/Persistence/FuzzyIndex.hpp"
+
+#include <algorithm>    // binary_search(), min(), min_element(), none_of(), sort()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t, uint64_t
+#include <functional>   // function
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>      // move(), swap()
+#include <vector>
+
+#include "TechnicalServices/Persistence/RelevanceIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    /*****************************************************************************
+    ** Levenshtein Automaton
+    **   Accepts the strings within a number of edits of a word.  A state is the row of edit distances between the input read so
+    **   far and each prefix of the word, capped at one more than the edits allowed, so states are built as the input is read
+    **   rather than enumerated up front.  A state is dead once no entry is within the edits allowed, as reading more can only
+    **   add edits.
+    ******************************************************************************/
+    class LevenshteinAutomaton
+    {
+      public:
+        using State = std::uint8_t;    // the first of width() entries
+
+        LevenshteinAutomaton( std::string_view word, int edits )
+          : _word( word ), _limit( static_cast<State>( edits + 1 ) ), _width( word.size() + 1 )
+        {}
+
+        std::size_t width() const { return _width; }
+
+        void start( State * state ) const
+        {
+          for( std::size_t prefix = 0; prefix != _width; ++prefix ) state[prefix] = cap( prefix );
+        }
+
+        void step( const State * from, char input, State * to ) const
+        {
+          to[0] = cap( from[0] + 1U );
+          for( std::size_t prefix = 1; prefix != _width; ++prefix )
+          {
+            auto replace = from[prefix - 1] + ( _word[prefix - 1] == input ? 0U : 1U );
+            to[prefix]   = cap( std::min( { replace, from[prefix] + 1U, to[prefix - 1] + 1U } ) );
+          }
+        }
+
+        bool alive  ( const State * state ) const { return *std::min_element( state, state + _width ) < _limit; }
+        bool accepts( const State * state ) const { return state[_width - 1] < _limit; }
+
+        // The whole of text read from the start state
+        bool accepts( std::string_view text ) const
+        {
+          std::vector<State> states( 2 * _width );
+          auto * current = states.data();
+          auto * next    = current + _width;
+
+          start( current );
+          for( auto input : text )
+          {
+            step( current, input, next );
+            if( !alive( next ) ) return false;
+            std::swap( current, next );
+          }
+          return accepts( current );
+        }
+
+      private:
+        State cap( std::size_t distance ) const { return static_cast<State>( std::min<std::size_t>( distance, _limit ) ); }
+
+        std::string_view _word;
+        State            _limit;    // one more than the edits allowed
+        std::size_t      _width;
+    };
+
+
+
+
+    int allowedEdits( std::string_view word, int edits )
+    {
+      if( edits != FuzzyIndex::AutomaticEdits ) return std::min( edits, FuzzyIndex::MostEdits );
+      return word.size() <= 2 ? 0 : word.size() <= 5 ? 1 : 2;
+    }
+  }    // namespace
+
+
+
+
+  void FuzzyIndex::insert( RowId row, const JobInfo & job )
+  {
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+    {
+      auto & vocabulary = _vocabulary[field];
+
+      for( auto & word : RelevanceIndex::terms( fieldValue( job, static_cast<JobField>( field ) ) ) )
+      {
+        auto term = vocabulary.find( word );
+        if( term == vocabulary.end() ) term = vocabulary.emplace( std::move( word ), MappedArray<RowId>{} ).first;
+
+        // A word repeated within the same field must not post the row twice
+        if( term->second.empty() || term->second.back() != row ) term->second.push_back( row );
+      }
+    }
+  }
+
+
+
+
+  void FuzzyIndex::forEachTerm( const Vocabulary & vocabulary, const std::string & word, int edits, const std::function<void( PostingView )> & visit )
+  {
+    LevenshteinAutomaton automaton( word, allowedEdits( word, edits ) );
+    const auto           width = automaton.width();
+
+    // The automaton's states after each prefix of the previous term, the start state first
+    std::vector<LevenshteinAutomaton::State> states( width );
+    automaton.start( states.data() );
+    std::string_view previous;
+
+    for( auto term = vocabulary.cbegin(); term != vocabulary.cend(); )
+    {
+      std::string_view text  = term->first;
+      std::size_t      known = states.size() / width - 1;
+      std::size_t      depth = 0;
+      while( depth < known && depth < text.size() && text[depth] == previous[depth] ) ++depth;
+      states.resize( ( depth + 1 ) * width );
+
+      bool alive = true;
+      for( ; depth < text.size(); ++depth )
+      {
+        states.resize( ( depth + 2 ) * width );
+        automaton.step( &states[depth * width], text[depth], &states[( depth + 1 ) * width] );
+        if( !automaton.alive( &states[( depth + 1 ) * width] ) ) { alive = false; break; }
+      }
+      previous = text;
+
+      if( alive )
+      {
+        if( automaton.accepts( &states[text.size() * width] ) ) visit( term->second );
+        ++term;
+        continue;
+      }
+
+      // No term beginning with text's first depth + 1 characters can be accepted, so seek past every one of them
+      states.resize( ( depth + 1 ) * width );
+      std::string next( text.substr( 0, depth + 1 ) );
+      while( !next.empty() && static_cast<unsigned char>( next.back() ) == std::numeric_limits<unsigned char>::max() ) next.pop_back();
+      if( next.empty() ) break;
+      next.back() = static_cast<char>( static_cast<unsigned char>( next.back() ) + 1 );
+      term = vocabulary.lower_bound( next );
+    }
+  }
+
+
+
+
+  PostingList FuzzyIndex::matching( JobField field, const std::string & criterion, int edits ) const
+  {
+    const auto & vocabulary = _vocabulary[static_cast<std::size_t>( field )];
+
+    // Each word's matching terms, rarest word first
+    struct Word
+    {
+      std::vector<PostingView> lists;
+      std::size_t              rows = 0;
+    };
+
+    std::vector<Word> words;
+    for( const auto & text : RelevanceIndex::terms( criterion ) )
+    {
+      auto & word = words.emplace_back();
+      forEachTerm( vocabulary, text, edits, [&]( PostingView rows ) { word.lists.push_back( rows ); word.rows += rows.size(); } );
+    }
+    if( words.empty() ) return {};
+    std::sort( words.begin(), words.end(), []( const Word & lhs, const Word & rhs ) { return lhs.rows < rhs.rows; } );
+
+    // A word matching far more rows than are left (a common word, or a short one matching many terms) only filters what's left,
+    // rather than uniting all of its rows first
+    constexpr std::size_t filterRatio = 16;
+
+    auto result = uniteAll( words.front().lists );
+    for( auto word = words.cbegin() + 1; word != words.cend() && !result.empty(); ++word )
+    {
+      if( word->rows < filterRatio * result.size() ) { result = intersect( result, uniteAll( word->lists ) ); continue; }
+
+      std::erase_if( result, [&]( RowId row )
+      {
+        return std::none_of( word->lists.cbegin(), word->lists.cend(), [&]( PostingView rows ) { return std::binary_search( rows.begin(), rows.end(), row ); } );
+      } );
+    }
+    return result;
+  }
+
+
+
+
+  // The rows of the rarest word's matches, as every word must match
+  std::size_t FuzzyIndex::cardinality( JobField field, const std::string & criterion, int edits ) const
+  {
+    const auto & vocabulary = _vocabulary[static_cast<std::size_t>( field )];
+
+    std::optional<std::size_t> fewest;
+    for( const auto & word : RelevanceIndex::terms( criterion ) )
+    {
+      std::size_t rows = 0;
+      forEachTerm( vocabulary, word, edits, [&]( PostingView postings ) noexcept { rows += postings.size(); } );
+      fewest = std::min( fewest.value_or( rows ), rows );
+    }
+    return fewest.value_or( 0 );
+  }
+
+
+
+
+  bool FuzzyIndex::matches( std::string_view text, const std::string & criterion, int edits )
+  {
+    auto words = RelevanceIndex::terms( text );
+    auto terms = RelevanceIndex::terms( criterion );
+    if( terms.empty() ) return false;
+
+    for( const auto & term : terms )
+    {
+      LevenshteinAutomaton automaton( term, allowedEdits( term, edits ) );
+      if( std::none_of( words.cbegin(), words.cend(), [&]( const std::string & word ) { return automaton.accepts( word ); } ) ) return false;
+    }
+    return true;
+  }
+
+
+
+
+  void FuzzyIndex::save( SnapshotWriter & image ) const
+  {
+    for( const auto & vocabulary : _vocabulary )
+    {
+      image.write( std::uint64_t{ vocabulary.size() } );
+      for( const auto & [term, postings] : vocabulary ) { image.write( term ); image.write( postings ); }
+    }
+  }
+
+
+
+
+  void FuzzyIndex::load( SnapshotReader & image )
+  {
+    for( auto & vocabulary : _vocabulary )
+    {
+      vocabulary.clear();
+      for( auto terms = image.readInteger(); terms != 0; --terms )
+      {
+        auto term = image.readString();    // terms were saved in order, so each one goes at the end
+        vocabulary.emplace_hint( vocabulary.end(), std::move( term ), image.viewArray<RowId>() );
+      }
+    }
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>        // size_t
+#include <functional>     // function, less
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Fuzzy Index
+  **   Finds jobs despite typos in the criteria.  A fuzzy criterion matches a job's field if every word of the criterion is within
+  **   a few edits (characters inserted, deleted or replaced) of some word of the field, ignoring case.  So "Starbuks" finds
+  **   Starbucks and "Barrista" finds Barista.
+  **
+  **   The words of each searchable field are kept in a sorted term dictionary.  A criterion's word is turned into a Levenshtein
+  **   automaton, which is run over the dictionary in order:  words sharing a prefix share the automaton's states for it, and once
+  **   a prefix leaves the automaton with no way to accept, every word starting with it is skipped in one seek.  Only the few
+  **   branches of the dictionary within reach of the word are ever visited, rather than measuring the distance to every word.
+  ******************************************************************************/
+  class FuzzyIndex
+  {
+    public:
+      static constexpr int AutomaticEdits = -1;    // as many as the word's length allows:  none up to 2 letters, 1 up to 5, else 2
+      static constexpr int MostEdits      = 2;
+
+
+      // Operations
+      void insert( RowId row, const JobInfo & job );    // rows must be inserted in ascending order
+
+      // Returns exactly the rows whose searchable field matches criterion with up to edits per word, or just at most how many
+      // there are
+      PostingList matching   ( JobField field, const std::string & criterion, int edits ) const;
+      std::size_t cardinality( JobField field, const std::string & criterion, int edits ) const;
+
+      // True if every word of criterion is within edits of some word of text, the same test without an index
+      static bool matches( std::string_view text, const std::string & criterion, int edits );
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      using Vocabulary = std::map<std::string /*Term*/, MappedArray<RowId>, std::less<>>;    // sorted, so a prefix is a contiguous range
+
+      // Calls visit( postings ) for every term within edits of word
+      static void forEachTerm( const Vocabulary & vocabulary, const std::string & word, int edits, const std::function<void( PostingView )> & visit );
+
+      std::array<Vocabulary, JobFieldCount> _vocabulary;
+  };    // class FuzzyIndex
+}    // namespace TechnicalServices::Persistence
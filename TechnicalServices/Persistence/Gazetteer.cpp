@@ -0,0 +1,63 @@
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+
+#include <algorithm>    // min()
+#include <cctype>       // isspace(), tolower()
+#include <cmath>        // asin(), cos(), sin(), sqrt()
+#include <numbers>      // pi
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  std::string Gazetteer::key( std::string_view name )
+  {
+    while( !name.empty() && std::isspace( static_cast<unsigned char>( name.front() ) ) ) name.remove_prefix( 1 );
+    while( !name.empty() && std::isspace( static_cast<unsigned char>( name.back () ) ) ) name.remove_suffix( 1 );
+
+    std::string folded;
+    folded.reserve( name.size() );
+    for( auto character : name ) folded += static_cast<char>( std::tolower( static_cast<unsigned char>( character ) ) );
+    return folded;
+  }
+
+
+
+
+  void Gazetteer::insert( const Place & place )
+  {
+    _places.insert_or_assign( key( place.name ), Coordinates{ static_cast<float>( place.latitude ), static_cast<float>( place.longitude ) } );
+  }
+
+
+
+
+  std::optional<Coordinates> Gazetteer::find( std::string_view location ) const
+  {
+    if( auto place = _places.find( key( location ) ); place != _places.cend() ) return place->second;
+
+    if( auto comma = location.find( ',' ); comma != std::string_view::npos )
+      if( auto place = _places.find( key( location.substr( 0, comma ) ) ); place != _places.cend() ) return place->second;
+
+    return std::nullopt;
+  }
+
+
+
+
+  // Haversine formula, which stays accurate for the short distances searched most
+  double Gazetteer::miles( const Coordinates & from, const Coordinates & to )
+  {
+    constexpr double earthRadius = 3958.8;    // miles
+    constexpr double radians     = std::numbers::pi / 180.0;
+
+    double latitudeChange  = ( to.latitude  - from.latitude  ) * radians;
+    double longitudeChange = ( to.longitude - from.longitude ) * radians;
+    double a               = std::sin( latitudeChange / 2 ) * std::sin( latitudeChange / 2 )
+                           + std::cos( from.latitude * radians ) * std::cos( to.latitude * radians ) * std::sin( longitudeChange / 2 ) * std::sin( longitudeChange / 2 );
+    return 2 * earthRadius * std::asin( std::sqrt( std::min( a, 1.0 ) ) );
+  }
+}    // namespace TechnicalServices::Persistence
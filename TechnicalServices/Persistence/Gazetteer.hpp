@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cmath>          // isnan()
+#include <cstddef>        // size_t
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  // A point on the Earth's surface, in degrees.  Single precision places a point to within a few feet, close enough for towns.
+  struct Coordinates
+  {
+    float latitude  = std::numeric_limits<float>::quiet_NaN();    // NaN means nowhere known
+    float longitude = std::numeric_limits<float>::quiet_NaN();
+
+    bool known() const { return !std::isnan( latitude ); }
+  };
+
+  // A gazetteer entry, as imported
+  struct Place
+  {
+    std::string name;
+    double      latitude  = 0.0;
+    double      longitude = 0.0;
+  };
+
+
+
+
+  /*****************************************************************************
+  ** Gazetteer
+  **   Resolves place names, as jobs give their locations, to coordinates.  Names are matched ignoring case and surrounding
+  **   whitespace, and a location such as "Fullerton, CA" that isn't itself listed is looked up by the part before its first
+  **   comma.
+  ******************************************************************************/
+  class Gazetteer
+  {
+    public:
+      // Operations
+      void                       insert( const Place & place );    // a later entry for the same name replaces an earlier one
+      std::optional<Coordinates> find  ( std::string_view location ) const;
+      std::size_t                size  () const { return _places.size(); }
+
+      static double              miles ( const Coordinates & from, const Coordinates & to );    // great circle distance
+
+    private:
+      static std::string key( std::string_view name );
+
+      std::unordered_map<std::string /*Folded name*/, Coordinates> _places;
+  };    // class Gazetteer
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,169 @@
+#include "TechnicalServices/Persistence/InvertedIndex.hpp"
+
+#include <algorithm>  // min()
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+#include <limits>     // numeric_limits
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>    // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  std::vector<std::string_view> InvertedIndex::tokenize( std::string_view text )
+  {
+    constexpr std::string_view whitespace = " \t\n\v\f\r";
+
+    std::vector<std::string_view> tokens;
+    for( auto begin = text.find_first_not_of( whitespace ); begin != std::string_view::npos; )
+    {
+      auto end = text.find_first_of( whitespace, begin );
+      if( end == std::string_view::npos ) end = text.size();
+
+      tokens.push_back( text.substr( begin, end - begin ) );
+      begin = text.find_first_not_of( whitespace, end );
+    }
+    return tokens;
+  }
+
+
+
+
+  void InvertedIndex::insert( RowId row, const JobInfo & job )
+  {
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+    {
+      auto & vocabulary = _vocabulary[field];
+
+      for( const auto & token : tokenize( fieldValue( job, static_cast<JobField>( field ) ) ) )
+      {
+        auto term = vocabulary.find( token );
+        if( term == vocabulary.end() ) term = vocabulary.emplace( std::string( token ), MappedArray<RowId>{} ).first;
+
+        // A term repeated within the same field must not post the row twice
+        if( term->second.empty() || term->second.back() != row ) term->second.push_back( row );
+      }
+    }
+  }
+
+
+
+
+  std::optional<PostingList> InvertedIndex::candidates( JobField field, const std::string & criterion ) const
+  {
+    const auto & vocabulary = _vocabulary[static_cast<std::size_t>( field )];
+    const auto   tokens     = tokenize( criterion );
+
+    if( tokens.empty() ) return std::nullopt;    // whitespace only criterion, can't be narrowed by terms
+
+    // Single token:  it may sit anywhere within a term.  The vocabulary grows much slower than the catalog, so walking it is
+    // still cheap compared to walking the rows.
+    if( tokens.size() == 1 )
+    {
+      std::vector<PostingView> matches;
+      for( const auto & [term, postings] : vocabulary ) if( term.find( tokens.front() ) != std::string::npos ) matches.push_back( postings );
+
+      return matches.empty() ? PostingList{} : uniteAll( matches );
+    }
+
+
+    // Many tokens:  the interior tokens must be whole terms, so look those up first as they are the most selective
+    std::optional<PostingList> result;
+    auto narrow = [&]( PostingView rows ) { result = result ? intersect( *result, rows ) : PostingList( rows.begin(), rows.end() ); };
+
+    for( std::size_t i = 1; i + 1 < tokens.size(); ++i )
+    {
+      auto term = vocabulary.find( tokens[i] );
+      if( term == vocabulary.end() ) return PostingList{};
+
+      narrow( term->second );
+      if( result->empty() ) return result;
+    }
+
+    // The last token must be the prefix of a term, and prefixes form a contiguous range of the sorted vocabulary
+    {
+      const auto &             prefix = tokens.back();
+      std::vector<PostingView> matches;
+      for( auto term = vocabulary.lower_bound( prefix ); term != vocabulary.end() && term->first.starts_with( prefix ); ++term )
+        matches.push_back( term->second );
+
+      if( matches.empty() ) return PostingList{};
+      narrow( uniteAll( matches ) );
+      if( result->empty() ) return result;
+    }
+
+    // The first token must be the suffix of a term
+    {
+      const auto &             suffix = tokens.front();
+      std::vector<PostingView> matches;
+      for( const auto & [term, postings] : vocabulary ) if( term.ends_with( suffix ) ) matches.push_back( postings );
+
+      if( matches.empty() ) return PostingList{};
+      narrow( uniteAll( matches ) );
+    }
+
+    return result;
+  }
+
+
+
+
+  // Adds up the rows of the terms the criterion could fall in rather than uniting them, and an interior token bounds it by a single term
+  std::optional<std::size_t> InvertedIndex::estimate( JobField field, const std::string & criterion ) const
+  {
+    const auto & vocabulary = _vocabulary[static_cast<std::size_t>( field )];
+    const auto   tokens     = tokenize( criterion );
+
+    if( tokens.empty() ) return std::nullopt;
+
+    std::size_t bound = std::numeric_limits<std::size_t>::max();
+    for( std::size_t i = 1; i + 1 < tokens.size(); ++i )
+    {
+      auto term = vocabulary.find( tokens[i] );
+      bound = std::min( bound, term == vocabulary.end() ? 0 : term->second.size() );
+    }
+
+    // A single token anywhere within a term, otherwise the last token starting one
+    std::size_t rows = 0;
+    if( tokens.size() == 1 ) { for( const auto & [term, postings] : vocabulary ) if( term.find( tokens.front() ) != std::string::npos ) rows += postings.size(); }
+    else for( auto term = vocabulary.lower_bound( tokens.back() ); term != vocabulary.end() && term->first.starts_with( tokens.back() ); ++term ) rows += term->second.size();
+
+    return std::min( bound, rows );
+  }
+
+
+
+
+  void InvertedIndex::save( SnapshotWriter & image ) const
+  {
+    for( const auto & vocabulary : _vocabulary )
+    {
+      image.write( std::uint64_t{ vocabulary.size() } );
+      for( const auto & [term, postings] : vocabulary ) { image.write( term ); image.write( postings ); }
+    }
+  }
+
+
+
+
+  void InvertedIndex::load( SnapshotReader & image )
+  {
+    for( auto & vocabulary : _vocabulary )
+    {
+      vocabulary.clear();
+      for( auto terms = image.readInteger(); terms != 0; --terms )
+      {
+        auto term = image.readString();    // terms were saved in order, so each one goes at the end
+        vocabulary.emplace_hint( vocabulary.end(), std::move( term ), image.viewArray<RowId>() );
+      }
+    }
+  }
+}    // namespace TechnicalServices::Persistence
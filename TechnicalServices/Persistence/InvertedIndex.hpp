@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Inverted Index
+  **   Maps each whitespace delimited token of a job's name, location and category to the ascending list of rows containing it.
+  **   Substring criteria are narrowed by term:
+  **     - a single token criterion may appear anywhere within a term, so all terms containing it contribute their rows
+  **     - a multi-token criterion's first token must end a term, its last token must start a term, and any tokens in between
+  **       must be whole terms
+  ******************************************************************************/
+  class InvertedIndex : public TechnicalServices::Persistence::SearchIndex
+  {
+    public:
+      // Operations
+      void insert( RowId row, const JobInfo & job ) override;
+
+      // Returns nothing if the criterion is all whitespace
+      std::optional<PostingList> candidates( JobField field, const std::string & criterion ) const override;
+      std::optional<std::size_t> estimate  ( JobField field, const std::string & criterion ) const override;
+
+      void save( SnapshotWriter & image ) const override;
+      void load( SnapshotReader & image )       override;
+
+      static std::vector<std::string_view> tokenize( std::string_view text );
+
+
+      // Destructor
+      ~InvertedIndex() noexcept override = default;
+
+    private:
+      using Vocabulary = std::map<std::string /*Term*/, MappedArray<RowId>, std::less<>>;   // sorted so prefixes form a contiguous range
+
+      std::array<Vocabulary, JobFieldCount> _vocabulary;
+  };    // class InvertedIndex
+}    // namespace TechnicalServices::Persistence
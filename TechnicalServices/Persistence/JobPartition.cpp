@@ -0,0 +1,465 @@
+#include "TechnicalServices/Persistence/JobPartition.hpp"
+
+#include <algorithm>    // binary_search(), is_sorted(), lower_bound(), min(), set_difference(), stable_sort()
+#include <cstddef>      // size_t
+#include <iterator>     // back_inserter()
+#include <memory>       // unique_ptr
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>       // jthread
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Bitmap.hpp"
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  JobPartition::JobPartition( std::unique_ptr<SearchIndex> searchIndex, const Gazetteer & gazetteer )
+    : _searchIndex( std::move( searchIndex ) ), _spatialIndex( gazetteer )
+  {}
+
+
+
+
+  void JobPartition::append( std::span<const JobInfo> jobs, std::size_t firstPosition )
+  {
+    auto first = _storedJobs.size();
+
+    // Every job is normalized once, up front, for the table's shadow text and the indexes criteria are matched against
+    std::vector<JobInfo> normalized;
+    normalized.reserve( jobs.size() );
+    for( const auto & job : jobs ) normalized.push_back( normalize( job ) );
+
+    // The table and indexes are independent of each other, so build them side by side straight from the incoming jobs.  Salaries
+    // and locations are parsed and placed as given, gazetteer lookups folding case themselves.
+    auto index = [&]( auto & target, std::span<const JobInfo> from )
+    {
+      for( std::size_t job = 0; job != from.size(); ++job ) target.insert( static_cast<RowId>( first + job ), from[job] );
+    };
+
+    auto facets    = [&] { index( _facetIndex, normalized ); index( _salaryIndex, jobs ); index( _spatialIndex, jobs ); };
+    auto relevance = [&] { index( _relevanceIndex, normalized ); };
+    auto fuzzy     = [&] { index( _fuzzyIndex,     normalized ); };
+    auto table     = [&]
+    {
+      _storedJobs.reserve( first + jobs.size() );
+      for( std::size_t job = 0; job != jobs.size(); ++job ) _storedJobs.append( jobs[job], normalized[job] );
+
+      _positions.writable().reserve( first + jobs.size() );
+      for( std::size_t job = 0; job != jobs.size(); ++job ) _positions.push_back( static_cast<RowId>( firstPosition + job ) );
+    };
+
+    // Starting threads costs more than a few jobs take to index, so only a bulk load is built side by side
+    constexpr std::size_t bulkLoad = 1'024;
+    if( jobs.size() < bulkLoad )
+    {
+      facets();
+      relevance();
+      fuzzy();
+      table();
+      if( _searchIndex ) index( *_searchIndex, normalized );
+      return;
+    }
+
+    std::jthread facetBuilder    ( facets    );
+    std::jthread relevanceBuilder( relevance );
+    std::jthread fuzzyBuilder    ( fuzzy     );
+    std::jthread tableBuilder    ( table     );
+    if( _searchIndex ) index( *_searchIndex, normalized );
+  }
+
+
+
+
+  JobPartition::Plan JobPartition::resolve( const std::vector<std::string> & args ) const
+  {
+    Plan plan;
+
+    // A criterion of "0" means skip, which is the same as matching everything.  The rest are matched in normalized form.
+    for( std::size_t field = 0; field != JobFieldCount; ++field ) plan.criteria[field] = args[field] == "0" ? "" : normalize( args[field] );
+
+    // Dictionary encoded fields are verified by code, having found once up front which of their (few) distinct values match
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+      if( !plan.criteria[field].empty() && JobTable::encoded( static_cast<JobField>( field ) ) )
+        plan.acceptedCodes[field] = _storedJobs.dictionary( static_cast<JobField>( field ) ).containing( plan.criteria[field] );
+
+    return plan;
+  }
+
+
+
+
+  JobPartition::Plan JobPartition::plan( const std::vector<std::string> & args ) const
+  {
+    Plan         plan       = resolve( args );
+    const auto & criteria   = plan.criteria;
+    auto &       candidates = plan.candidates;
+
+    // Narrow the rows to those the indexes say could possibly match.  Location and category are answered exactly by ANDing their
+    // facet bitmaps, the remaining criteria by the search index.  No candidates means no criterion could be narrowed and every
+    // row must be examined.
+    std::optional<Bitmap> facetRows;
+    for( auto field : { JobField::Location, JobField::Category } )
+    {
+      const auto & criterion = criteria[static_cast<std::size_t>( field )];
+      if( criterion.empty() ) continue;
+
+      auto rows = _facetIndex.matching( field, criterion );
+      facetRows = facetRows ? *facetRows & rows : std::move( rows );
+    }
+
+    if( facetRows ) candidates = facetRows->rows();
+
+    for( std::size_t field = 0; _searchIndex && field != JobFieldCount && !( candidates && candidates->empty() ); ++field )
+    {
+      if( criteria[field].empty() || FacetIndex::faceted( static_cast<JobField>( field ) ) ) continue;
+
+      auto rows = _searchIndex->candidates( static_cast<JobField>( field ), criteria[field] );
+      if( rows ) candidates = candidates ? intersect( *candidates, *rows ) : std::move( *rows );
+    }
+
+    // Still nothing narrowed the name, so scan the whole name column for it in one pass rather than calling find() row by row
+    const auto & name = criteria[static_cast<std::size_t>( JobField::Name )];
+    if( !candidates && !name.empty() ) candidates = _substringScanner.rowsContainingAll( *_storedJobs.normalizedHeap( JobField::Name ), { name } );
+
+    return plan;
+  }
+
+
+
+
+  // Verifies a candidate with the original substring semantics, between normalized forms
+  bool JobPartition::matches( const Plan & plan, RowId row ) const
+  {
+    if( _removed.contains( row ) ) return false;
+
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+    {
+      auto jobField = static_cast<JobField>( field );
+      if( plan.criteria[field].empty() ) continue;
+
+      if( JobTable::encoded( jobField ) ) { if( !plan.acceptedCodes[field][_storedJobs.codes( jobField )[row]] ) return false; }
+      else if( _storedJobs.normalizedText( jobField, row ).find( plan.criteria[field] ) == std::string_view::npos ) return false;
+    }
+    return true;
+  }
+
+
+
+
+  std::vector<RowId> JobPartition::search( const Plan & plan, std::size_t from, std::size_t limit ) const
+  {
+    std::vector<RowId> rows;
+
+    // Catalog positions ascend with the rows, so the first row at or after from is found by bisection
+    auto first = static_cast<RowId>( std::lower_bound( _positions.cbegin(), _positions.cend(), from ) - _positions.cbegin() );
+    if( plan.candidates )
+    {
+      const auto & candidates = *plan.candidates;
+      for( auto row = std::lower_bound( candidates.cbegin(), candidates.cend(), first ); row != candidates.cend() && rows.size() != limit; ++row )
+        if( matches( plan, *row ) ) rows.push_back( *row );
+    }
+    else
+    {
+      for( auto row = first; row < _storedJobs.size() && rows.size() != limit; ++row ) if( matches( plan, row ) ) rows.push_back( row );
+    }
+    return rows;
+  }
+
+
+
+
+  std::vector<RowId> JobPartition::search( const JobQuery & query, std::size_t from, std::size_t limit, std::string * explanation ) const
+  {
+    // A later page is evaluated over the rows from its first on, so the rows earlier pages held aren't gathered all over again
+    auto first = static_cast<RowId>( std::lower_bound( _positions.cbegin(), _positions.cend(), from ) - _positions.cbegin() );
+    auto rows  = evaluate( query.root(), nullptr, first, explanation, 1 );
+
+    std::vector<RowId> found;
+    for( auto row = rows.cbegin(); row != rows.cend() && found.size() != limit; ++row )
+      if( !_removed.contains( *row ) ) found.push_back( *row );
+    return found;
+  }
+
+
+
+
+  std::size_t JobPartition::estimate( const JobQuery::Node & node ) const
+  {
+    using Kind = JobQuery::Node::Kind;
+
+    std::size_t rows = _storedJobs.size();
+    switch( node.kind )
+    {
+      case Kind::And: for( const auto & child : node.children ) rows = std::min( rows, estimate( child ) ); return rows;
+      case Kind::Or:
+      {
+        std::size_t sum = 0;
+        for( const auto & child : node.children ) sum += estimate( child );
+        return std::min( rows, sum );
+      }
+      case Kind::Fuzzy: return _fuzzyIndex  .cardinality( node.field, node.value, node.edits );
+      case Kind::Range: return _salaryIndex .cardinality( node.range );
+      case Kind::Near:  return _spatialIndex.cardinality( node.centre, node.miles );
+      case Kind::Criterion:
+        if( FacetIndex::faceted( node.field ) ) return _facetIndex.cardinality( node.field, node.value );
+        if( _searchIndex && static_cast<std::size_t>( node.field ) < JobFieldCount )
+          if( auto candidates = _searchIndex->estimate( node.field, node.value ) ) return std::min( rows, *candidates );
+        return rows;
+      case Kind::Not:    // excluding a few rows still leaves nearly all of them
+      default:
+        return rows;
+    }
+  }
+
+
+
+
+  // Operands are evaluated rarest first, each examining only the rows those before it left, so the cost follows the most selective
+  // criterion rather than the catalog.  A criterion estimated to match more rows than are left is verified row by row rather than
+  // looked up, and one no index can narrow is scanned only if nothing has narrowed the rows before it.
+  PostingList JobPartition::evaluate( const JobQuery::Node & node, const PostingList * within, RowId first, std::string * explanation, std::size_t depth ) const
+  {
+    using Kind = JobQuery::Node::Kind;
+
+    auto        estimated = estimate( node );
+    std::string label;    // composites name their operator, criteria describe themselves
+    std::string how;
+    std::string steps;    // of the operands, explained after this node
+    auto *      stepsTo   = explanation == nullptr ? nullptr : &steps;
+    PostingList rows;
+
+    auto verify = [&]( const PostingList & candidates )
+    {
+      for( auto row : candidates ) if( matches( node, row ) ) rows.push_back( row );
+      how = "verified " + std::to_string( candidates.size() ) + " rows";
+    };
+
+    auto everyRow = [&]
+    {
+      PostingList all( _storedJobs.size() - first );
+      for( RowId row = 0; row != all.size(); ++row ) all[row] = first + row;
+      return all;
+    };
+
+    switch( node.kind )
+    {
+      case Kind::And:
+      {
+        std::vector<const JobQuery::Node *> operands;
+        for( const auto & child : node.children ) operands.push_back( &child );
+        std::stable_sort( operands.begin(), operands.end(), [&]( const auto * lhs, const auto * rhs ) { return estimate( *lhs ) < estimate( *rhs ); } );
+
+        const PostingList * left = within;
+        for( const auto * operand : operands )
+        {
+          rows = evaluate( *operand, left, first, stepsTo, depth + 1 );
+          left = &rows;
+          if( rows.empty() ) break;
+        }
+        label = "AND";
+        how   = "rarest first";
+        break;
+      }
+
+      case Kind::Or:
+        for( const auto & child : node.children ) rows = unite( rows, evaluate( child, within, first, stepsTo, depth + 1 ) );
+        label = "OR";
+        how   = "united";
+        break;
+
+      case Kind::Not:
+      {
+        auto all      = within == nullptr ? everyRow() : *within;
+        auto excluded = evaluate( node.children.front(), &all, first, stepsTo, depth + 1 );
+        std::set_difference( all.cbegin(), all.cend(), excluded.cbegin(), excluded.cend(), std::back_inserter( rows ) );
+        label = "NOT";
+        how   = "complement of " + std::to_string( all.size() ) + " rows";
+        break;
+      }
+
+      case Kind::Fuzzy:
+        if( within != nullptr && within->size() <= estimated ) verify( *within );
+        else
+        {
+          rows = _fuzzyIndex.matching( node.field, node.value, node.edits );
+          if( within != nullptr ) rows = intersect( rows, *within );
+          how = "fuzzy index";
+        }
+        break;
+
+      case Kind::Range:
+        if( within != nullptr && within->size() <= estimated ) verify( *within );
+        else
+        {
+          rows = _salaryIndex.matching( node.range );
+          if( within != nullptr ) rows = intersect( rows, *within );
+          how = "salary index";
+        }
+        break;
+
+      case Kind::Near:
+        if( within != nullptr && within->size() <= estimated ) verify( *within );
+        else
+        {
+          rows = _spatialIndex.within( node.centre, node.miles );
+          if( within != nullptr ) rows = intersect( rows, *within );
+          how = "spatial index";
+        }
+        break;
+
+      case Kind::Criterion:
+      default:
+      {
+        std::optional<PostingList> candidates;
+        if( within != nullptr && within->size() <= estimated ) verify( *within );
+        else if( FacetIndex::faceted( node.field ) )
+        {
+          rows = _facetIndex.matching( node.field, node.value ).rows();
+          if( within != nullptr ) rows = intersect( rows, *within );
+          how = "facet index";
+        }
+        else if( _searchIndex && static_cast<std::size_t>( node.field ) < JobFieldCount && ( candidates = _searchIndex->candidates( node.field, node.value ) ) )
+        {
+          verify( within == nullptr ? *candidates : intersect( *candidates, *within ) );
+          how = "search index, " + how;
+        }
+        else if( within != nullptr ) verify( *within );
+        else if( const auto * column = _storedJobs.normalizedHeap( node.field ) )
+        {
+          rows = _substringScanner.rowsContainingAll( *column, { node.value } );
+          how  = "scanned";
+        }
+        else
+        {
+          // Dictionary encoded, so find the values containing it once and then just compare codes
+          auto         accepted = _storedJobs.dictionary( node.field ).containing( node.value );
+          const auto & codes    = _storedJobs.codes( node.field );
+          for( RowId row = first; row < codes.size(); ++row ) if( accepted[codes[row]] ) rows.push_back( row );
+          how = "scanned codes";
+        }
+        break;
+      }
+    }
+
+    // Indexes and scans of every row find those before first too
+    if( within == nullptr && !rows.empty() && rows.front() < first ) rows.erase( rows.begin(), std::lower_bound( rows.begin(), rows.end(), first ) );
+
+    if( explanation != nullptr )
+    {
+      if( label.empty() ) label = JobQuery::describe( node );
+      *explanation += std::string( 2 * depth, ' ' ) + label + "  (" + how + ", estimated " + std::to_string( estimated ) + ", matched "
+                      + std::to_string( rows.size() ) + ")\n" + steps;
+    }
+    return rows;
+  }
+
+
+
+
+  bool JobPartition::matches( const JobQuery::Node & node, RowId row ) const
+  {
+    using Kind = JobQuery::Node::Kind;
+
+    switch( node.kind )
+    {
+      case Kind::Not: return !matches( node.children.front(), row );
+      case Kind::And: for( const auto & child : node.children ) if( !matches( child, row ) ) return false; return true;
+      case Kind::Or:  for( const auto & child : node.children ) if(  matches( child, row ) ) return true;  return false;
+      case Kind::Fuzzy: return FuzzyIndex::matches( _storedJobs.normalizedText( node.field, row ), node.value, node.edits );
+      case Kind::Range: return node.range.contains( _salaryIndex.rate( row ) );
+      case Kind::Near:
+      {
+        auto location = _spatialIndex.coordinates( row );
+        return location.known() && Gazetteer::miles( node.centre, location ) <= node.miles;
+      }
+      case Kind::Criterion:
+      default:        return _storedJobs.normalizedText( node.field, row ).find( node.value ) != std::string_view::npos;
+    }
+  }
+
+
+
+
+  std::optional<RowId> JobPartition::row( RowId position ) const
+  {
+    auto row = std::lower_bound( _positions.cbegin(), _positions.cend(), position );
+    if( row == _positions.cend() || *row != position ) return std::nullopt;
+    return static_cast<RowId>( row - _positions.cbegin() );
+  }
+
+
+
+
+  std::vector<RelevanceIndex::Match> JobPartition::topK( const std::string & keywords, std::size_t k, const Plan & filter,
+                                                         const RelevanceIndex::Statistics & catalog ) const
+  {
+    return _relevanceIndex.topK( keywords, k, [&]( RowId row ) { return matches( filter, row ); }, catalog );
+  }
+
+
+
+
+  std::vector<RelevanceIndex::Match> JobPartition::topK( const RelevanceIndex::Profile & profile, std::size_t k, std::span<const int> excluded,
+                                                         const RelevanceIndex::Statistics & catalog ) const
+  {
+    return _relevanceIndex.topK( profile, k, [&]( RowId row )
+                                 { return !_removed.contains( row ) && !std::binary_search( excluded.begin(), excluded.end(), _storedJobs.id( row ) ); }, catalog );
+  }
+
+
+
+
+  std::size_t JobPartition::countByFacets( const std::string & location, const std::string & category ) const
+  {
+    // The facet bitmaps still hold removed rows, and there are few enough of those to discount one at a time
+    auto count = _facetIndex.count( location, category );
+    for( auto row : _removed.rows() )
+      if( ( location.empty() || _storedJobs.normalizedText( JobField::Location, row ) == location ) && ( category.empty() || _storedJobs.normalizedText( JobField::Category, row ) == category ) ) --count;
+    return count;
+  }
+
+
+
+
+  void JobPartition::save( SnapshotWriter & image ) const
+  {
+    _storedJobs.save( image );
+    image.write( _positions );
+    _removed.save( image );
+    _facetIndex.save( image );
+    _fuzzyIndex.save( image );
+    _salaryIndex.save( image );
+    _spatialIndex.save( image );
+    if( _searchIndex ) _searchIndex->save( image );
+    _relevanceIndex.save( image );
+  }
+
+
+
+
+  void JobPartition::load( SnapshotReader & image )
+  {
+    _storedJobs.load( image );
+    _positions = image.viewArray<RowId>();
+    _removed.load( image );
+    _facetIndex.load( image );
+    _fuzzyIndex.load( image );
+    _salaryIndex.load( image );
+    _spatialIndex.load( image );
+    if( _searchIndex ) _searchIndex->load( image );
+    _relevanceIndex.load( image );
+
+    if( _salaryIndex.size() != _storedJobs.size() || _spatialIndex.size() != _storedJobs.size() )
+      throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, job partition salaries or coordinates don't match its rows" );
+    if( _positions.size() != _storedJobs.size() || !std::is_sorted( _positions.cbegin(), _positions.cend() ) )
+      throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, job partition positions don't match its rows" );
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>    // size_t
+#include <memory>     // unique_ptr
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "TechnicalServices/Persistence/Bitmap.hpp"
+#include "TechnicalServices/Persistence/FacetIndex.hpp"
+#include "TechnicalServices/Persistence/FuzzyIndex.hpp"
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/JobQuery.hpp"
+#include "TechnicalServices/Persistence/JobTable.hpp"
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/RelevanceIndex.hpp"
+#include "TechnicalServices/Persistence/SalaryIndex.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/SpatialIndex.hpp"
+#include "TechnicalServices/Persistence/SubstringScanner.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Job Partition
+  **   Some or all of the job catalog, stored by column with its own search, facet, fuzzy, salary, spatial and relevance
+  **   indexes, and searched independently of any other partition.  Rows are numbered within the partition, and each remembers
+  **   its position in the whole catalog so results from several partitions can be merged back into catalog order.
+  **
+  **   A removed job keeps its row, marked removed, so row numbers and positions never shift.  Searches skip removed rows, but the
+  **   relevance statistics still count them, as they would a job that has since been filled.
+  ******************************************************************************/
+  class JobPartition
+  {
+    public:
+      // A search's criteria resolved against the indexes, ready to enumerate its matches in row order
+      struct Plan
+      {
+        std::array<std::string, JobFieldCount>       criteria;         // normalized, "0" resolved to empty, which matches anything
+        std::optional<PostingList>                   candidates;       // rows that could match, none means every row could
+        std::array<std::vector<char>, JobFieldCount> acceptedCodes;    // per dictionary encoded field, a flag per code
+      };
+
+
+      // Constructors
+      // No search index means searches scan every row.  Locations are placed by gazetteer, which must outlive the partition.
+      JobPartition( std::unique_ptr<SearchIndex> searchIndex, const Gazetteer & gazetteer );
+
+
+      // Operations
+      // Appends jobs, which take up consecutive catalog positions from firstPosition on, and indexes them
+      void        append    ( std::span<const JobInfo> jobs, std::size_t firstPosition );
+      std::size_t size      ()            const { return _storedJobs.size(); }
+      std::size_t bytes     ()            const { return _storedJobs.bytes(); }
+      RowId       position  ( RowId row ) const { return _positions[row]; }    // in the whole catalog
+      std::optional<RowId> row( RowId position ) const;    // holding the job at catalog position, none if another partition does
+      JobInfo     job       ( RowId row ) const { return _storedJobs.row( row ); }    // materialized from the columns
+      int         id        ( RowId row ) const { return _storedJobs.id( row ); }
+
+      void        remove    ( RowId row )       { _removed.add( row ); }
+      bool        removed   ( RowId row ) const { return _removed.contains( row ); }
+
+      Plan        resolve   ( const std::vector<std::string> & args ) const;    // criteria and codes only, no candidates
+      Plan        plan      ( const std::vector<std::string> & args ) const;
+      bool        matches   ( const Plan & plan, RowId row ) const;
+
+      // Returns up to limit matching rows, in row order, starting with the first at or after catalog position from.  A query's
+      // evaluation, step by step, is appended to explanation if one is given.
+      std::vector<RowId> search( const Plan & plan, std::size_t from, std::size_t limit ) const;
+      std::vector<RowId> search( const JobQuery & query, std::size_t from, std::size_t limit, std::string * explanation = nullptr ) const;
+      std::size_t        estimate( const JobQuery::Node & node ) const;    // the most rows node could match, removed rows included
+
+      // Returns up to k rows most relevant to keywords and accepted by filter, best first.  Scored against the statistics of the
+      // whole catalog, which are this partition's own if it is the whole catalog.
+      std::vector<RelevanceIndex::Match> topK( const std::string & keywords, std::size_t k, const Plan & filter,
+                                               const RelevanceIndex::Statistics & catalog ) const;
+      RelevanceIndex::Statistics         relevanceStatistics( const std::string & keywords ) const { return _relevanceIndex.statistics( keywords ); }
+
+      // Returns up to k rows most like profile (see RelevanceIndex), best first, leaving out removed rows and the jobs with
+      // excluded ids (ascending).  Scored against the statistics of the whole catalog, as topK() is.
+      std::vector<RelevanceIndex::Match> topK( const RelevanceIndex::Profile & profile, std::size_t k, std::span<const int> excluded,
+                                               const RelevanceIndex::Statistics & catalog ) const;
+      RelevanceIndex::Statistics         relevanceStatistics( const RelevanceIndex::Profile & profile ) const { return _relevanceIndex.statistics( profile ); }
+
+      std::size_t countByFacets( const std::string & location, const std::string & category ) const;    // both normalized
+
+      // Snapshot image support, load() replaces the partition's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      // Query evaluation:  node's matching rows from row first on among within (nullptr means among every row from first on), and
+      // whether a single row matches node.  Removed rows are left to the caller.
+      PostingList evaluate( const JobQuery::Node & node, const PostingList * within, RowId first, std::string * explanation, std::size_t depth ) const;
+      bool        matches ( const JobQuery::Node & node, RowId row ) const;
+
+      JobTable                     _storedJobs;          // stored by column
+      MappedArray<RowId>           _positions;           // catalog position of each row, ascending
+      Bitmap                       _removed;             // rows of jobs since removed
+      std::unique_ptr<SearchIndex> _searchIndex;         // over _storedJobs, none means full scan
+      SubstringScanner             _substringScanner;    // for criteria _searchIndex can't narrow
+      FacetIndex                   _facetIndex;          // over _storedJobs' locations and categories
+      FuzzyIndex                   _fuzzyIndex;          // over _storedJobs' searchable fields' words, for criteria with typos
+      SalaryIndex                  _salaryIndex;         // over _storedJobs' salaries, for salary ranges
+      SpatialIndex                 _spatialIndex;        // over _storedJobs' locations, for distances
+      RelevanceIndex               _relevanceIndex;      // ranks _storedJobs against keywords
+  };    // class JobPartition
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,343 @@
+#include "TechnicalServices/Persistence/JobQuery.hpp"
+
+#include <cctype>       // isspace()
+#include <charconv>     // from_chars()
+#include <cmath>        // isfinite()
+#include <cstddef>      // size_t
+#include <cstdio>       // snprintf()
+#include <map>
+#include <optional>
+#include <string>
+#include <system_error> // errc
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/RelevanceIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    const std::map<std::string, JobField> fields = { {"name",          JobField::Name         },
+                                                     {"keyword",       JobField::Name         },
+                                                     {"location",      JobField::Location     },
+                                                     {"category",      JobField::Category     },
+                                                     {"type",          JobField::Type         },
+                                                     {"description",   JobField::Description  },
+                                                     {"qualification", JobField::Qualification},
+                                                     {"salary",        JobField::Salary       } };
+
+    const char * fieldName( JobField field )
+    {
+      for( const auto & [name, named] : fields ) if( named == field && name != "keyword" ) return name.c_str();
+      return "name";
+    }
+
+
+
+
+    // Recursive descent over the query text, one token of look ahead
+    //   or       := and { "OR" and }
+    //   and      := not { [ "AND" ] not }
+    //   not      := "NOT" not | primary
+    //   primary  := "(" or ")" | field ( "<" | "<=" | ">" | ">=" ) amount | "near:" place [ "~" miles ] | [ field ":" ] value [ "~" [ edits ] ]
+    class Parser
+    {
+      public:
+        Parser( const std::string & text, const Gazetteer * gazetteer ) : _text( text ), _gazetteer( gazetteer ) {}
+
+        JobQuery::Node parse()
+        {
+          auto root = parseOr();
+          if( !atEnd() ) fail( "unexpected \"" + peek() + '"' );
+          return root;
+        }
+
+      private:
+        using Node = JobQuery::Node;
+
+        void skipSpace() { while( _next < _text.size() && std::isspace( static_cast<unsigned char>( _text[_next] ) ) ) ++_next; }
+        bool atEnd    () { skipSpace(); return _next == _text.size(); }
+
+        // The next token without consuming it:  a parenthesis, a quoted value (quotes included), or a run of anything else
+        std::string peek()
+        {
+          skipSpace();
+          if( _next == _text.size() ) return {};
+          if( _text[_next] == '(' || _text[_next] == ')' ) return std::string( 1, _text[_next] );
+
+          auto end = _next;
+          while( end < _text.size() && !std::isspace( static_cast<unsigned char>( _text[end] ) ) && _text[end] != '(' && _text[end] != ')' )
+          {
+            if( _text[end] == '"' )
+            {
+              auto close = _text.find( '"', end + 1 );
+              if( close == std::string::npos ) fail( "unterminated quote" );
+              end = close;
+            }
+            ++end;
+          }
+          return _text.substr( _next, end - _next );
+        }
+
+        bool accept( const std::string & token )
+        {
+          if( peek() != token ) return false;
+          _next += token.size();
+          return true;
+        }
+
+        [[noreturn]] void fail( const std::string & problem ) const
+        {
+          throw PersistenceHandler::BadQuery( "Query not understood at character " + std::to_string( _next + 1 ) + ": " + problem );
+        }
+
+        static Node combine( Node::Kind kind, std::vector<Node> operands )
+        {
+          if( operands.size() == 1 ) return std::move( operands.front() );
+
+          // Nested operators of the same kind are flattened, so the planner sees every operand it may reorder at once
+          Node node;
+          node.kind = kind;
+          for( auto & operand : operands )
+          {
+            if( operand.kind == kind ) for( auto & child : operand.children ) node.children.push_back( std::move( child ) );
+            else node.children.push_back( std::move( operand ) );
+          }
+          return node;
+        }
+
+        Node parseOr()
+        {
+          std::vector<Node> operands{ parseAnd() };
+          while( accept( "OR" ) ) operands.push_back( parseAnd() );
+          return combine( Node::Kind::Or, std::move( operands ) );
+        }
+
+        Node parseAnd()
+        {
+          std::vector<Node> operands{ parseNot() };
+          while( true )
+          {
+            if( accept( "AND" ) ) { operands.push_back( parseNot() ); continue; }
+
+            auto next = peek();
+            if( next.empty() || next == ")" || next == "OR" ) break;
+            operands.push_back( parseNot() );    // side by side, implicitly ANDed
+          }
+          return combine( Node::Kind::And, std::move( operands ) );
+        }
+
+        Node parseNot()
+        {
+          if( !accept( "NOT" ) ) return parsePrimary();
+
+          Node node;
+          node.kind = Node::Kind::Not;
+          node.children.push_back( parseNot() );
+          return node;
+        }
+
+        Node parsePrimary()
+        {
+          if( accept( "(" ) )
+          {
+            auto node = parseOr();
+            if( !accept( ")" ) ) fail( "expected \")\"" );
+            return node;
+          }
+
+          auto token = peek();
+          if( token.empty() || token == ")" || token == "AND" || token == "OR" ) fail( token.empty() ? "expected a criterion" : "expected a criterion before \"" + token + '"' );
+          _next += token.size();
+
+          // A comparison may be spelled with spaces around its operator, "salary >= 20"
+          if( fields.contains( token ) && ( peek().starts_with( '<' ) || peek().starts_with( '>' ) ) ) token += take();
+          if( auto op = token.find_first_of( "<>" ); op != std::string::npos && fields.contains( token.substr( 0, op ) ) )
+          {
+            if( token.find_first_not_of( "<>=", op ) == std::string::npos ) token += take();
+            return parseRange( token, op );
+          }
+
+          Node node;
+          if( auto colon = token.find( ':' ); colon != std::string::npos && token.front() != '"' )
+          {
+            if( token.substr( 0, colon ) == "near" ) return parseNear( token.substr( colon + 1 ) );
+
+            auto field = fields.find( token.substr( 0, colon ) );
+            if( field == fields.cend() ) fail( "unknown field \"" + token.substr( 0, colon ) + '"' );
+            node.field = field->second;
+            token.erase( 0, colon + 1 );
+          }
+
+          // A trailing ~, outside any quotes and with or without a number of edits, tolerates typos
+          if( auto tilde = token.rfind( '~' ); tilde != std::string::npos && token.find( '"', tilde ) == std::string::npos
+                                               && token.find_first_not_of( "0123456789", tilde + 1 ) == std::string::npos )
+          {
+            auto edits = token.substr( tilde + 1 );
+            if( edits.size() > 1 || ( !edits.empty() && edits.front() - '0' > FuzzyIndex::MostEdits ) ) fail( "at most " + std::to_string( FuzzyIndex::MostEdits ) + " typos a word are tolerated" );
+            if( static_cast<std::size_t>( node.field ) >= JobFieldCount ) fail( "typos are tolerated only in names, locations and categories" );
+
+            node.kind  = Node::Kind::Fuzzy;
+            node.edits = edits.empty() ? FuzzyIndex::AutomaticEdits : edits.front() - '0';
+            token.erase( tilde );
+          }
+
+          // Quotes only group, they aren't part of the value, which is matched normalized
+          for( auto character : token ) if( character != '"' ) node.value += character;
+          node.value = normalize( node.value );
+          if( node.kind == Node::Kind::Fuzzy && RelevanceIndex::terms( node.value ).empty() ) fail( "expected a word before \"~\"" );
+          return node;
+        }
+
+        std::string take()
+        {
+          auto token = peek();
+          _next += token.size();
+          return token;
+        }
+
+        Node parseRange( const std::string & token, std::size_t op )
+        {
+          auto field = fields.at( token.substr( 0, op ) );
+          if( field != JobField::Salary ) fail( "only salary can be compared, not " + token.substr( 0, op ) );
+
+          auto end    = token.find_first_not_of( "<>=", op );
+          auto symbol = token.substr( op, end - op );
+          if( symbol != "<" && symbol != "<=" && symbol != ">" && symbol != ">=" ) fail( "unknown comparison \"" + symbol + '"' );
+
+          auto amount = end == std::string::npos ? std::nullopt : SalaryIndex::parse( token.substr( end ) );
+          if( !amount ) fail( "expected an amount after \"" + token.substr( 0, end ) + '"' );
+
+          // Strict bounds become inclusive ones a cent further in
+          Node node;
+          node.kind  = Node::Kind::Range;
+          node.field = field;
+          auto rate  = amount->hourly();
+          if     ( symbol == ">=" ) node.range.low  = rate;
+          else if( symbol == ">"  ) node.range.low  = rate + 1;
+          else if( symbol == "<=" ) node.range.high = rate;
+          else if( rate == 0      ) node.range.low  = 1, node.range.high = 0;    // nothing is paid less than nothing
+          else                      node.range.high = rate - 1;
+          return node;
+        }
+
+        Node parseNear( const std::string & token )
+        {
+          constexpr double defaultMiles = 25.0;
+
+          Node node;
+          node.kind  = Node::Kind::Near;
+          node.miles = defaultMiles;
+
+          auto place = token;
+          if( auto tilde = token.rfind( '~' ); tilde != std::string::npos && token.find( '"', tilde ) == std::string::npos )
+          {
+            place = token.substr( 0, tilde );
+            auto [end, error] = std::from_chars( token.data() + tilde + 1, token.data() + token.size(), node.miles );
+            if( error != std::errc() || end != token.data() + token.size() || !std::isfinite( node.miles ) || node.miles <= 0 )    // from_chars() takes "inf" and "nan"
+              fail( "expected a positive number of miles after \"~\" in \"near:" + token + '"' );
+          }
+
+          for( auto character : place ) if( character != '"' ) node.value += character;
+          if( node.value.empty() ) fail( "expected a place after \"near:\"" );
+
+          auto centre = _gazetteer == nullptr ? std::nullopt : _gazetteer->find( node.value );
+          if( !centre ) fail( "no coordinates known for \"" + node.value + '"' );
+          node.centre = *centre;
+          return node;
+        }
+
+        const std::string & _text;
+        const Gazetteer *   _gazetteer;
+        std::size_t         _next = 0;
+    };
+  }    // namespace
+
+
+
+
+  JobQuery::JobQuery( const std::string & text, const Gazetteer * gazetteer ) : _gazetteer( gazetteer ), _root( Parser( text, gazetteer ).parse() )
+  {}
+
+
+
+
+  bool JobQuery::matches( const JobInfo & job, const JobInfo & normalized ) const
+  {
+    auto evaluate = [&]( const auto & self, const Node & node ) -> bool
+    {
+      switch( node.kind )
+      {
+        case Node::Kind::Criterion: return fieldValue( normalized, node.field ).find( node.value ) != std::string::npos;
+        case Node::Kind::Fuzzy:     return FuzzyIndex::matches( fieldValue( normalized, node.field ), node.value, node.edits );
+        case Node::Kind::Range:
+        {
+          auto salary = SalaryIndex::parse( job.salary );
+          return salary && node.range.contains( salary->hourly() );
+        }
+        case Node::Kind::Near:
+        {
+          auto location = _gazetteer->find( job.location );
+          return location && Gazetteer::miles( node.centre, *location ) <= node.miles;
+        }
+        case Node::Kind::Not:       return !self( self, node.children.front() );
+        case Node::Kind::And:       for( const auto & child : node.children ) if( !self( self, child ) ) return false; return true;
+        case Node::Kind::Or:        for( const auto & child : node.children ) if(  self( self, child ) ) return true;  return false;
+        default:                    return false;
+      }
+    };
+    return evaluate( evaluate, _root );
+  }
+
+
+
+
+  std::string JobQuery::describe( const Node & node )
+  {
+    switch( node.kind )
+    {
+      case Node::Kind::Criterion: return std::string( fieldName( node.field ) ) + ":\"" + node.value + '"';
+      case Node::Kind::Fuzzy:     return std::string( fieldName( node.field ) ) + ":\"" + node.value + "\"~" + ( node.edits == FuzzyIndex::AutomaticEdits ? "" : std::to_string( node.edits ) );
+      case Node::Kind::Range:
+      {
+        auto dollars = []( SalaryIndex::Rate rate )
+        {
+          char text[32];
+          std::snprintf( text, sizeof( text ), "%u.%02u", rate / 100, rate % 100 );
+          return std::string( text );
+        };
+
+        std::string low  = std::string( fieldName( node.field ) ) + ">=" + dollars( node.range.low  );
+        std::string high = std::string( fieldName( node.field ) ) + "<=" + dollars( node.range.high );
+        if( node.range.high == SalaryIndex::Highest ) return low;
+        if( node.range.low  == 0                    ) return high;
+        return '(' + low + " AND " + high + ')';
+      }
+      case Node::Kind::Near:
+      {
+        auto miles = std::to_string( node.miles );
+        miles.erase( miles.find_last_not_of( '0' ) + 1 );
+        if( miles.back() == '.' ) miles.pop_back();
+        return "near:\"" + node.value + "\"~" + miles;
+      }
+      case Node::Kind::Not:       return "NOT " + describe( node.children.front() );
+      case Node::Kind::And:
+      case Node::Kind::Or:
+      default:
+      {
+        std::string text = "(";
+        for( const auto & child : node.children )
+        {
+          if( text.size() > 1 ) text += node.kind == Node::Kind::And ? " AND " : " OR ";
+          text += describe( child );
+        }
+        return text + ')';
+      }
+    }
+  }
+}    // namespace TechnicalServices::Persistence
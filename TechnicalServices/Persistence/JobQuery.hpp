@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TechnicalServices/Persistence/FuzzyIndex.hpp"
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SalaryIndex.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Job Query
+  **   A boolean combination of field criteria, parsed from text such as
+  **
+  **       category:Barista AND (location:Fullerton OR location:Irvine) AND NOT type:"Part time"
+  **
+  **   Each criterion is field:value, and matches a job whose field contains value as a substring, ignoring case, accents and
+  **   spacing (see Normalization), just as searchByCriteria() does.  The fields are name (or keyword), location, category, type, description, qualification and salary, and a value
+  **   without a field is a name.  Values holding spaces or parentheses are quoted.  NOT binds tightest, then AND, then OR, and
+  **   criteria side by side without an operator are ANDed.  Operators are upper case, so "and" on its own is just a name.
+  **
+  **   Salaries are also compared by amount, as in salary>=20 or salary<50000/year.  An amount is in dollars an hour unless it
+  **   names another period, and matches the jobs whose salary, normalized to an hourly rate, compares so.
+  **
+  **   near:place~miles matches the jobs located within that many miles of place (25 if ~miles is left off), as placed by the
+  **   gazetteer, so near:Fullerton~10 finds jobs in Anaheim too.
+  **
+  **   A name, location or category criterion ending in ~ tolerates typos:  Starbuks~ matches the jobs whose name has, for each of
+  **   its words, a word within a couple of edits (see FuzzyIndex).  ~1 or ~2 sets the edits allowed per word.
+  ******************************************************************************/
+  class JobQuery
+  {
+    public:
+      struct Node
+      {
+        enum class Kind { Criterion, Fuzzy, Range, Near, And, Or, Not };
+
+        Kind                kind  = Kind::Criterion;
+        JobField            field = JobField::Name;    // criteria, fuzzy criteria and ranges only, ranges are always of salary
+        std::string         value;                     // criteria and fuzzy criteria, and the place named for near
+        int                 edits = FuzzyIndex::AutomaticEdits;    // fuzzy criteria only, per word
+        SalaryIndex::Range  range;                     // ranges only
+        Coordinates         centre;                    // near only
+        double              miles = 0.0;               // near only
+        std::vector<Node>   children;                  // two or more for And and Or, one for Not
+      };
+
+
+      // Constructors
+      // Throws PersistenceHandler::BadQuery if text isn't a query, or names a place gazetteer doesn't know
+      explicit JobQuery( const std::string & text, const Gazetteer * gazetteer = nullptr );
+
+
+      // Operations
+      const Node & root   ()                     const { return _root; }
+      bool         matches( const JobInfo & job, const JobInfo & normalized ) const;    // normalized being normalize( job )
+
+      static std::string describe( const Node & node );    // back to query text, fully parenthesized
+
+    private:
+      const Gazetteer * _gazetteer;
+      Node              _root;
+  };    // class JobQuery
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,344 @@
+#include "TechnicalServices/Persistence/JobTable.hpp"
+
+#include <algorithm>    // lower_bound()
+#include <array>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** String Heap
+  ******************************************************************************/
+  void StringHeap::append( std::string_view text )
+  {
+    auto & characters = _characters.writable();
+    characters.insert( characters.end(), text.begin(), text.end() );
+    _offsets.push_back( characters.size() );
+  }
+
+
+
+
+  void StringHeap::reserve( std::size_t rows, std::size_t characters )
+  {
+    _offsets   .writable().reserve( rows + 1    );
+    _characters.writable().reserve( characters );
+  }
+
+
+
+
+  std::size_t StringHeap::bytes() const
+  {
+    return _characters.bytes() + _offsets.bytes();
+  }
+
+
+
+
+  void StringHeap::save( SnapshotWriter & image ) const
+  {
+    image.write( _characters );
+    image.write( _offsets    );
+  }
+
+
+
+
+  void StringHeap::load( SnapshotReader & image )
+  {
+    _characters = image.viewArray<char>();
+    _offsets    = image.viewArray<std::uint64_t>();
+
+    // Offsets index straight into the characters, so make sure they can't reach outside them
+    if( _offsets.empty() || _offsets.front() != 0 || _offsets.back() != _characters.size() )
+      throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, string heap offsets out of range" );
+    for( std::size_t row = 1; row != _offsets.size(); ++row )
+      if( _offsets[row] < _offsets[row - 1] ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, string heap offsets out of order" );
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Dictionary
+  ******************************************************************************/
+  Dictionary::Code Dictionary::encode( const std::string & value )
+  {
+    auto byValue = [&]( Code code, std::string_view wanted ) { return _values[code] < wanted; };
+    auto sorted  = std::lower_bound( _sorted.cbegin(), _sorted.cend(), std::string_view( value ), byValue );
+    if( sorted != _sorted.cend() && _values[*sorted] == value ) return *sorted;
+
+    auto   code  = static_cast<Code>( _values.size() );
+    auto   place = sorted - _sorted.cbegin();    // writable() may copy the codes out of the image, moving them
+    auto & codes = _sorted.writable();
+    codes.insert( codes.begin() + place, code );
+    _values    .append( value );
+    _normalized.append( normalize( value ) );
+    return code;
+  }
+
+
+
+
+  std::optional<Dictionary::Code> Dictionary::find( const std::string & value ) const
+  {
+    auto byValue = [&]( Code code, std::string_view wanted ) { return _values[code] < wanted; };
+    auto sorted  = std::lower_bound( _sorted.cbegin(), _sorted.cend(), std::string_view( value ), byValue );
+    if( sorted == _sorted.cend() || _values[*sorted] != value ) return std::nullopt;
+    return *sorted;
+  }
+
+
+
+
+  std::size_t Dictionary::bytes() const
+  {
+    return _values.bytes() + _normalized.bytes() + _sorted.bytes();
+  }
+
+
+
+
+  std::vector<char> Dictionary::containing( const std::string & criterion ) const
+  {
+    std::vector<char> flags( size() );
+    for( std::size_t code = 0; code != size(); ++code ) flags[code] = _normalized[code].find( criterion ) != std::string_view::npos;
+    return flags;
+  }
+
+
+
+
+  void Dictionary::save( SnapshotWriter & image ) const
+  {
+    _values    .save( image );
+    _normalized.save( image );
+    image.write( _sorted );
+  }
+
+
+
+
+  void Dictionary::load( SnapshotReader & image )
+  {
+    _values    .load( image );
+    _normalized.load( image );
+    _sorted = image.viewArray<Code>();
+
+    // Codes index straight into the heaps, so make sure each is one of them, exactly once and in order of its value
+    bool consistent = _normalized.size() == size() && _sorted.size() == size();
+    std::vector<char> seen( size() );
+    for( std::size_t place = 0; consistent && place != _sorted.size(); ++place )
+    {
+      auto code  = _sorted[place];
+      consistent = code < size() && !seen[code] && ( place == 0 || _values[_sorted[place - 1]] < _values[code] );
+      if( consistent ) seen[code] = true;
+    }
+    if( !consistent ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, malformed dictionary" );
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Job Table
+  ******************************************************************************/
+  void JobTable::append( const JobInfo & job, const JobInfo & normalized )
+  {
+    _ids           .push_back( job.id                              );
+    _names         .append   ( job.name                            );
+    _locations     .push_back( _locationValues.encode( job.location ) );
+    _categories    .push_back( _categoryValues.encode( job.category ) );
+    _types         .push_back( _typeValues    .encode( job.type     ) );
+    _descriptions  .append   ( job.description                     );
+    _qualifications.append   ( job.qualification                   );
+    _salaries      .append   ( job.salary                          );
+
+    _normalizedNames         .append( normalized.name          );
+    _normalizedDescriptions  .append( normalized.description   );
+    _normalizedQualifications.append( normalized.qualification );
+    _normalizedSalaries      .append( normalized.salary        );
+  }
+
+
+
+
+  void JobTable::reserve( std::size_t rows )
+  {
+    _ids       .writable().reserve( rows );
+    _locations .writable().reserve( rows );
+    _categories.writable().reserve( rows );
+    _types     .writable().reserve( rows );
+
+    // Only the row counts are known, the characters grow as they come
+    for( auto * heap : heaps() ) heap->reserve( rows, 0 );
+  }
+
+
+
+
+  std::size_t JobTable::bytes() const
+  {
+    std::size_t bytes = _ids.bytes();
+    for( const auto * codes : { &_locations,      &_categories,     &_types      } ) bytes += codes->bytes();
+    for( const auto * heap  : heaps() ) bytes += heap->bytes();
+    for( const auto * words : { &_locationValues, &_categoryValues, &_typeValues } ) bytes += words->bytes();
+    return bytes;
+  }
+
+
+
+
+  JobInfo JobTable::row( RowId row ) const
+  {
+    return { _ids[row],
+             std::string( _names[row] ),
+             std::string( _locationValues.value( _locations [row] ) ),
+             std::string( _categoryValues.value( _categories[row] ) ),
+             std::string( _typeValues    .value( _types     [row] ) ),
+             std::string( _descriptions  [row] ),
+             std::string( _qualifications[row] ),
+             std::string( _salaries      [row] ) };
+  }
+
+
+
+
+  std::string_view JobTable::text( JobField field, RowId row ) const
+  {
+    if( const auto * column = heap( field ) ) return ( *column )[row];
+
+    return dictionary( field ).value( codes( field )[row] );
+  }
+
+
+
+
+  std::string_view JobTable::normalizedText( JobField field, RowId row ) const
+  {
+    if( const auto * column = normalizedHeap( field ) ) return ( *column )[row];
+
+    return dictionary( field ).normalized( codes( field )[row] );
+  }
+
+
+
+
+  const StringHeap * JobTable::heap( JobField field ) const
+  {
+    switch( field )
+    {
+      case JobField::Name:          return &_names;
+      case JobField::Description:   return &_descriptions;
+      case JobField::Qualification: return &_qualifications;
+      case JobField::Salary:        return &_salaries;
+      case JobField::Location:
+      case JobField::Category:
+      case JobField::Type:
+      default:                      return nullptr;
+    }
+  }
+
+
+
+
+  const StringHeap * JobTable::normalizedHeap( JobField field ) const
+  {
+    switch( field )
+    {
+      case JobField::Name:          return &_normalizedNames;
+      case JobField::Description:   return &_normalizedDescriptions;
+      case JobField::Qualification: return &_normalizedQualifications;
+      case JobField::Salary:        return &_normalizedSalaries;
+      case JobField::Location:
+      case JobField::Category:
+      case JobField::Type:
+      default:                      return nullptr;
+    }
+  }
+
+
+
+
+  std::array<const StringHeap *, 8> JobTable::heaps() const
+  {
+    return { &_names, &_descriptions, &_qualifications, &_salaries, &_normalizedNames, &_normalizedDescriptions, &_normalizedQualifications, &_normalizedSalaries };
+  }
+
+
+
+
+  std::array<StringHeap *, 8> JobTable::heaps()
+  {
+    return { &_names, &_descriptions, &_qualifications, &_salaries, &_normalizedNames, &_normalizedDescriptions, &_normalizedQualifications, &_normalizedSalaries };
+  }
+
+
+
+
+  const Dictionary & JobTable::dictionary( JobField field ) const
+  {
+    if( field == JobField::Location ) return _locationValues;
+    if( field == JobField::Category ) return _categoryValues;
+    return _typeValues;
+  }
+
+
+
+
+  const MappedArray<Dictionary::Code> & JobTable::codes( JobField field ) const
+  {
+    if( field == JobField::Location ) return _locations;
+    if( field == JobField::Category ) return _categories;
+    return _types;
+  }
+
+
+
+
+  void JobTable::save( SnapshotWriter & image ) const
+  {
+    image.write( std::uint64_t{ _ids.size() } );
+    image.write( _ids );
+
+    for( const auto * words : { &_locationValues, &_categoryValues, &_typeValues } ) words->save( image );
+    for( const auto * codes : { &_locations,      &_categories,     &_types      } ) image.write( *codes );
+    for( const auto * heap  : heaps() ) heap->save( image );
+  }
+
+
+
+
+  void JobTable::load( SnapshotReader & image )
+  {
+    auto rows = image.readInteger();
+    _ids = image.viewArray<int>();
+
+    for( auto * words : { &_locationValues, &_categoryValues, &_typeValues } ) words->load( image );
+    for( auto [codes, words] : { std::pair{ &_locations, &_locationValues }, { &_categories, &_categoryValues }, { &_types, &_typeValues } } )
+    {
+      *codes = image.viewArray<Dictionary::Code>();
+      for( auto code : *codes ) if( code >= words->size() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, dictionary code out of range" );
+    }
+    for( auto * heap : heaps() ) heap->load( image );
+
+    // Every column must describe the same rows
+    bool consistent = _ids.size() == rows;
+    for( const auto * codes : { &_locations, &_categories, &_types } ) consistent = consistent && codes->size() == rows;
+    for( const auto * heap  : heaps() ) consistent = consistent && heap->size() == rows;
+    if( !consistent ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, job table columns differ in length" );
+  }
+}    // namespace TechnicalServices::Persistence
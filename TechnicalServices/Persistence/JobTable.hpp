@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>        // size_t
+#include <cstdint>        // uint32_t, uint64_t
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** String Heap
+  **   One text column.  Every row's characters sit back to back in a single buffer, found through an offsets array, so a column
+  **   costs one allocation rather than one per row and scanning it walks memory sequentially.  A column restored from a snapshot
+  **   image is read in place from the mapping (see MappedArray) until it's next appended to.
+  ******************************************************************************/
+  class StringHeap
+  {
+    public:
+      // Operations
+      void             append    ( std::string_view text );
+      std::string_view operator[]( RowId row ) const { return { _characters.data() + _offsets[row], _offsets[row + 1] - _offsets[row] }; }
+      std::size_t      size      () const            { return _offsets.size() - 1; }
+      std::size_t      bytes     () const;                                           // memory held, including slack
+      std::string_view characters() const            { return { _characters.data(), _characters.size() }; }    // every row's text, back to back
+      std::span<const std::uint64_t> offsets() const { return _offsets; }            // row r spans [offsets[r], offsets[r+1])
+
+      void reserve( std::size_t rows, std::size_t characters );
+
+      // Snapshot image support, load() replaces the heap's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      MappedArray<char>          _characters;
+      MappedArray<std::uint64_t> _offsets = std::vector<std::uint64_t>{ 0 };
+  };    // class StringHeap
+
+
+
+
+  /*****************************************************************************
+  ** Dictionary
+  **   Maps each distinct value of a low cardinality column to a small dense code, in order of first appearance, and back again.
+  **   Each value's normalized form (see Normalization) is kept alongside it for matching criteria.  Values are found by bisecting
+  **   the codes sorted by value, so like its string heaps that array is read in place from a snapshot image too.
+  ******************************************************************************/
+  class Dictionary
+  {
+    public:
+      using Code = std::uint32_t;
+
+      // Operations
+      Code                encode    ( const std::string & value );                  // adds value if it's new
+      std::optional<Code> find      ( const std::string & value ) const;
+      std::string_view    value     ( Code code )                 const { return _values[code]; }
+      std::string_view    normalized( Code code )                 const { return _normalized[code]; }
+      std::size_t         size      ()                            const { return _values.size(); }
+      std::size_t         bytes     ()                            const;            // memory held, approximately
+
+      // One flag per code, set for each value whose normalized form contains criterion (normalized too), so a column can then be
+      // filtered by code alone
+      std::vector<char>   containing( const std::string & criterion ) const;
+
+      // Snapshot image support, load() replaces the dictionary's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      StringHeap        _values;        // indexed by code
+      StringHeap        _normalized;    // indexed by code
+      MappedArray<Code> _sorted;        // every code, ordered by its value
+  };    // class Dictionary
+
+
+
+
+  /*****************************************************************************
+  ** Job Table
+  **   The job catalog stored by column rather than as an array of JobInfo.  Location, category and type have few distinct values
+  **   and are dictionary encoded into dense arrays of codes, so filtering on them compares integers and never touches text.  The
+  **   free text fields each live in a string heap, so a scan of one field doesn't drag the others through the cache.  Jobs are
+  **   materialized as JobInfo only on the way out.
+  **
+  **   Criteria are matched against normalized text (see Normalization), so every text field is also kept normalized:  the free
+  **   text fields in shadow string heaps, the encoded ones in their dictionaries.  Both forms are stored as the job is appended.
+  ******************************************************************************/
+  class JobTable
+  {
+    public:
+      // Operations
+      void        append ( const JobInfo & job, const JobInfo & normalized );    // becomes row size(), normalized being normalize( job )
+      void        reserve( std::size_t rows );
+      std::size_t size   () const { return _ids.size(); }
+      std::size_t bytes  () const;                                        // memory held, approximately
+      JobInfo     row    ( RowId row ) const;
+
+      int              id            ( RowId row )                 const { return _ids[row]; }
+      std::string_view text          ( JobField field, RowId row ) const;
+      std::string_view normalizedText( JobField field, RowId row ) const;
+
+      // The field's text column, and its normalized shadow, nullptr for dictionary encoded fields
+      const StringHeap * heap          ( JobField field ) const;
+      const StringHeap * normalizedHeap( JobField field ) const;
+
+      // Dictionary encoded fields (Location, Category and Type):  a dense code per row, and the dictionary decoding them
+      static bool                             encoded   ( JobField field ) { return field == JobField::Location || field == JobField::Category || field == JobField::Type; }
+      const Dictionary                      & dictionary( JobField field ) const;
+      const MappedArray<Dictionary::Code>   & codes     ( JobField field ) const;
+
+      // Snapshot image support, load() replaces the table's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      // Every string heap, the originals then their shadows
+      std::array<const StringHeap *, 8> heaps() const;
+      std::array<StringHeap *, 8>       heaps();
+
+      MappedArray<int>              _ids;
+      StringHeap                    _names;
+      MappedArray<Dictionary::Code> _locations;
+      MappedArray<Dictionary::Code> _categories;
+      MappedArray<Dictionary::Code> _types;
+      StringHeap                    _descriptions;
+      StringHeap                    _qualifications;
+      StringHeap                    _salaries;
+      StringHeap                    _normalizedNames;
+      StringHeap                    _normalizedDescriptions;
+      StringHeap                    _normalizedQualifications;
+      StringHeap                    _normalizedSalaries;
+
+      Dictionary                    _locationValues;
+      Dictionary                    _categoryValues;
+      Dictionary                    _typeValues;
+  };    // class JobTable
+}    // namespace TechnicalServices::Persistence
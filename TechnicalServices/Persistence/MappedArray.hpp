@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>        // size_t
+#include <memory>         // shared_ptr
+#include <span>
+#include <type_traits>    // is_trivially_copyable_v
+#include <utility>        // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Mapped Array
+  **   An array that is either held in memory, like a std::vector, or read in place from a mapped snapshot image (see
+  **   SnapshotReader::viewArray()), sharing ownership of the mapping so it stays mapped for as long as any array reads from it.
+  **   Restoring from an image then costs neither a copy nor an allocation per array, and pages are only read from disk as
+  **   queries touch them.
+  **
+  **   The first change to an array read in place copies it into memory, so the image is never written and an array changed
+  **   since the restore is no different from one built from the catalogs.
+  ******************************************************************************/
+  template<typename T>
+  class MappedArray
+  {
+    static_assert( std::is_trivially_copyable_v<T> );
+
+    public:
+      // Constructors
+      MappedArray() = default;
+      MappedArray( std::vector<T> values ) : _owned( std::move( values ) ) {}
+      MappedArray( std::shared_ptr<const MappedFile> file, std::span<const T> view ) : _file( std::move( file ) ), _view( view ) {}
+
+
+      // Queries
+      const T *   data () const noexcept { return _file ? _view.data() : _owned.data(); }
+      std::size_t size () const noexcept { return _file ? _view.size() : _owned.size(); }
+      bool        empty() const noexcept { return size() == 0; }
+      std::size_t bytes() const noexcept { return _owned.capacity() * sizeof( T ); }    // memory held, nothing for an array read in place
+
+      const T & operator[]( std::size_t index ) const noexcept { return data()[index]; }
+      const T & front     ()                    const noexcept { return data()[0]; }
+      const T & back      ()                    const noexcept { return data()[size() - 1]; }
+      const T * begin     ()                    const noexcept { return data(); }
+      const T * end       ()                    const noexcept { return data() + size(); }
+      const T * cbegin    ()                    const noexcept { return begin(); }
+      const T * cend      ()                    const noexcept { return end(); }
+
+      operator std::span<const T>() const noexcept { return { data(), size() }; }
+
+
+      // Operations
+      // Returns the array ready to change, first copying it into memory if it's read in place
+      std::vector<T> & writable();
+
+      void push_back( const T & value ) { writable().push_back( value ); }
+
+    private:
+      std::vector<T>                    _owned;
+      std::shared_ptr<const MappedFile> _file;    // set while the array is read in place
+      std::span<const T>                _view;
+  };    // class MappedArray
+
+
+
+
+  /*****************************************************************************
+  ** Template implementations
+  ******************************************************************************/
+  template<typename T>
+  std::vector<T> & MappedArray<T>::writable()
+  {
+    if( _file )
+    {
+      _owned.assign( _view.begin(), _view.end() );
+      _file.reset();
+      _view = {};
+    }
+    return _owned;
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,97 @@
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+
+#include <fstream>
+#include <iterator>    // istreambuf_iterator
+#include <string>
+#include <utility>     // exchange(), move(), swap()
+
+#if __has_include( <sys/mman.h> )
+  #include <fcntl.h>       // open()
+  #include <sys/mman.h>    // mmap(), munmap(), madvise()
+  #include <sys/stat.h>    // fstat()
+  #include <unistd.h>      // close()
+  #define MAPPED_FILE_USES_MMAP
+#endif
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  MappedFile::MappedFile( const std::string & path )
+  {
+    #if defined( MAPPED_FILE_USES_MMAP )
+      int descriptor = ::open( path.c_str(), O_RDONLY );
+      if( descriptor < 0 ) throw PersistenceHandler::PersistenceException( "Unable to open \"" + path + "\" detected in function " + __func__ );
+
+      struct stat status{};
+      if( ::fstat( descriptor, &status ) != 0 )
+      {
+        ::close( descriptor );
+        throw PersistenceHandler::PersistenceException( "Unable to size \"" + path + "\" detected in function " + __func__ );
+      }
+
+      _size = static_cast<std::size_t>( status.st_size );
+      if( _size != 0 )    // mapping an empty file fails, but an empty view is fine
+      {
+        void * address = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+        if( address == MAP_FAILED )
+        {
+          ::close( descriptor );
+          throw PersistenceHandler::PersistenceException( "Unable to map \"" + path + "\" detected in function " + __func__ );
+        }
+
+        ::madvise( address, _size, MADV_SEQUENTIAL );    // a hint only, so failure doesn't matter
+        _data   = static_cast<const char *>( address );
+        _mapped = true;
+      }
+      ::close( descriptor );    // the mapping keeps its own reference to the file
+
+    #else
+      std::ifstream file( path, std::ios::binary );
+      if( !file.is_open() ) throw PersistenceHandler::PersistenceException( "Unable to open \"" + path + "\" detected in function " + __func__ );
+
+      _buffer.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+      _data = _buffer.data();
+      _size = _buffer.size();
+    #endif
+  }
+
+
+
+
+  MappedFile::MappedFile( MappedFile && other ) noexcept
+    : _data  ( std::exchange( other._data,   nullptr ) ),
+      _size  ( std::exchange( other._size,   0       ) ),
+      _mapped( std::exchange( other._mapped, false   ) ),
+      _buffer( std::move( other._buffer ) )
+  {
+    if( !_mapped && _size != 0 ) _data = _buffer.data();    // moving a short string may have moved its characters
+  }
+
+
+
+
+  MappedFile & MappedFile::operator=( MappedFile && other ) noexcept
+  {
+    MappedFile temp( std::move( other ) );
+    std::swap( _data,   temp._data   );
+    std::swap( _size,   temp._size   );
+    std::swap( _mapped, temp._mapped );
+    std::swap( _buffer, temp._buffer );
+    if( !_mapped && _size != 0 ) _data = _buffer.data();
+    return *this;
+  }
+
+
+
+
+  MappedFile::~MappedFile() noexcept
+  {
+    #if defined( MAPPED_FILE_USES_MMAP )
+      if( _mapped ) ::munmap( const_cast<char *>( _data ), _size );
+    #endif
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>    // size_t
+#include <string>
+#include <string_view>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Mapped File
+  **   Read only view of a whole file.  On POSIX systems the file is mapped into memory with mmap(), so pages are only read from
+  **   disk as they are touched and are shared with the page cache instead of copied.  Elsewhere the file is read into memory.
+  **   Throws PersistenceHandler::PersistenceException if the file can't be opened.
+  ******************************************************************************/
+  class MappedFile
+  {
+    public:
+      // Constructors
+      explicit MappedFile( const std::string & path );
+      MappedFile            ( MappedFile && other ) noexcept;
+      MappedFile & operator=( MappedFile && other ) noexcept;
+      MappedFile            ( const MappedFile & ) = delete;
+      MappedFile & operator=( const MappedFile & ) = delete;
+
+
+      // Operations
+      std::string_view contents() const { return { _data, _size }; }
+
+
+      // Destructor
+      ~MappedFile() noexcept;
+
+    private:
+      const char * _data = nullptr;
+      std::size_t  _size = 0;
+      bool         _mapped = false;    // true if _data must be unmapped, false if it points into _buffer (or is empty)
+      std::string  _buffer;            // the file's contents where mapping isn't available
+  };    // class MappedFile
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,106 @@
+#include "TechnicalServices/Persistence/Normalization.hpp"
+
+#include <cstddef>    // size_t
+#include <string>
+#include <string_view>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    // The Latin-1 Supplement and Latin Extended-A letters, by code point, as the lower case ASCII letters they're written with
+    // once their diacritics are gone.  Code points between ranges (×, ÷) have no plain form and are kept as they are.
+    struct LatinLetters
+    {
+      char32_t     first;
+      char32_t     last;
+      const char * plain;
+    };
+
+    constexpr LatinLetters latinLetters[] = {
+      {0x00C0, 0x00C5, "a" }, {0x00C6, 0x00C6, "ae"}, {0x00C7, 0x00C7, "c" }, {0x00C8, 0x00CB, "e" }, {0x00CC, 0x00CF, "i" },
+      {0x00D0, 0x00D0, "d" }, {0x00D1, 0x00D1, "n" }, {0x00D2, 0x00D6, "o" }, {0x00D8, 0x00D8, "o" }, {0x00D9, 0x00DC, "u" },
+      {0x00DD, 0x00DD, "y" }, {0x00DE, 0x00DE, "th"}, {0x00DF, 0x00DF, "ss"}, {0x00E0, 0x00E5, "a" }, {0x00E6, 0x00E6, "ae"},
+      {0x00E7, 0x00E7, "c" }, {0x00E8, 0x00EB, "e" }, {0x00EC, 0x00EF, "i" }, {0x00F0, 0x00F0, "d" }, {0x00F1, 0x00F1, "n" },
+      {0x00F2, 0x00F6, "o" }, {0x00F8, 0x00F8, "o" }, {0x00F9, 0x00FC, "u" }, {0x00FD, 0x00FD, "y" }, {0x00FE, 0x00FE, "th"},
+      {0x00FF, 0x00FF, "y" }, {0x0100, 0x0105, "a" }, {0x0106, 0x010D, "c" }, {0x010E, 0x0111, "d" }, {0x0112, 0x011B, "e" },
+      {0x011C, 0x0123, "g" }, {0x0124, 0x0127, "h" }, {0x0128, 0x0131, "i" }, {0x0132, 0x0133, "ij"}, {0x0134, 0x0135, "j" },
+      {0x0136, 0x0138, "k" }, {0x0139, 0x0142, "l" }, {0x0143, 0x014B, "n" }, {0x014C, 0x0151, "o" }, {0x0152, 0x0153, "oe"},
+      {0x0154, 0x0159, "r" }, {0x015A, 0x0161, "s" }, {0x0162, 0x0167, "t" }, {0x0168, 0x0173, "u" }, {0x0174, 0x0175, "w" },
+      {0x0176, 0x0178, "y" }, {0x0179, 0x017E, "z" }, {0x017F, 0x017F, "s" } };
+
+    const char * plainLetter( char32_t codePoint )
+    {
+      for( const auto & letters : latinLetters ) if( codePoint >= letters.first && codePoint <= letters.last ) return letters.plain;
+      return nullptr;
+    }
+
+    constexpr char32_t noBreakSpace            = 0x00A0;
+    constexpr char32_t firstCombiningDiacritic = 0x0300;    // the accents of decomposed text, written after their letter
+    constexpr char32_t lastCombiningDiacritic  = 0x036F;
+
+    bool whitespace( unsigned char byte ) { return byte == ' ' || ( byte >= '\t' && byte <= '\r' ); }
+  }    // namespace
+
+
+
+
+  std::string normalize( std::string_view text )
+  {
+    std::string normalized;
+    normalized.reserve( text.size() );
+
+    // Whitespace is held back until something follows it, so runs collapse and none is left at the end
+    bool spaced = false;
+    auto append = [&]( std::string_view characters )
+    {
+      if( spaced && !normalized.empty() ) normalized += ' ';
+      spaced = false;
+      normalized += characters;
+    };
+
+    for( std::size_t next = 0; next != text.size(); ++next )
+    {
+      auto byte = static_cast<unsigned char>( text[next] );
+      if( byte < 0x80 )
+      {
+        if( whitespace( byte ) ) { spaced = true; continue; }
+        if( byte >= 'A' && byte <= 'Z' ) byte = static_cast<unsigned char>( byte - 'A' + 'a' );
+        if( spaced && !normalized.empty() ) normalized += ' ';
+        spaced = false;
+        normalized += static_cast<char>( byte );
+        continue;
+      }
+
+      // Every letter with a plain form is a two byte sequence, anything else is copied byte by byte
+      auto following = next + 1 == text.size() ? 0U : static_cast<unsigned char>( text[next + 1] );
+      if( byte < 0xC2 || byte > 0xDF || ( following & 0xC0U ) != 0x80 ) { append( text.substr( next, 1 ) ); continue; }
+
+      auto codePoint = static_cast<char32_t>( ( byte & 0x1FU ) << 6 | ( following & 0x3FU ) );
+      if     ( codePoint == noBreakSpace ) spaced = true;
+      else if( codePoint >= firstCombiningDiacritic && codePoint <= lastCombiningDiacritic ) {}
+      else if( const auto * plain = plainLetter( codePoint ) ) append( plain );
+      else append( text.substr( next, 2 ) );
+      ++next;
+    }
+    return normalized;
+  }
+
+
+
+
+  JobInfo normalize( const JobInfo & job )
+  {
+    return { job.id,
+             normalize( job.name          ),
+             normalize( job.location      ),
+             normalize( job.category      ),
+             normalize( job.type          ),
+             normalize( job.description   ),
+             normalize( job.qualification ),
+             normalize( job.salary        ) };
+  }
+}    // namespace TechnicalServices::Persistence
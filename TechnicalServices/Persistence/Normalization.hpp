@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Text Normalization
+  **   Criteria are matched against job text as both are normalized:  letters folded to lower case, Latin letters stripped of
+  **   accents and other diacritics (so "Café" and "cafe" match, and "Straße" becomes "strasse"), and every run of whitespace
+  **   collapsed to one space with none left at either end.  UTF-8 text outside the Latin letters passes through unchanged.
+  **
+  **   Job text is normalized once, as it's stored, and kept alongside the original, and criteria once per search, so matching
+  **   compares the precomputed forms and never transforms a row.
+  ******************************************************************************/
+  std::string normalize( std::string_view text );
+
+  // Every field of job normalized, its id as is
+  JobInfo     normalize( const JobInfo & job );
+}    // namespace TechnicalServices::Persistence
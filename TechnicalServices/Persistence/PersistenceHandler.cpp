@@ -1,4 +1,8 @@
+#include <memory>    // make_unique(), unique_ptr
+#include <string>
+
 #include "TechnicalServices/Persistence/SimpleDB.hpp"
+#include "TechnicalServices/Persistence/ShardedDB.hpp"
 #include "TechnicalServices/Persistence/PersistenceHandler.hpp"
 
 namespace TechnicalServices::Persistence
@@ -10,18 +14,27 @@ namespace TechnicalServices::Persistence
 
   PersistenceHandler & PersistenceHandler::instance()
   {
-    // Can't read the DB component preference from the database because the DB has not yet been created. So choosing the database
-    // implementation is really a configuration item (set by the vendor before delivery), not an adaptable item (set by the end-user
-    // after delivery)
-    using SelectedDatabase = SimpleDB;
+    // Can't read the DB component preference from the database because the DB has not yet been created, so it's read from the
+    // adaptation data file directly, once.  Component.Database "Sharded DB" splits the job catalog across every core, searching
+    // the parts in parallel.  Without the file or the key it's "Simple DB".
+    static std::unique_ptr<PersistenceHandler> instance = []() -> std::unique_ptr<PersistenceHandler>
+    {
+      auto        adaptationData = SimpleDB::readAdaptationData();
+      std::string requested      = "Simple DB";
+      if( adaptationData && adaptationData->contains( "Component.Database" ) ) requested = adaptationData->at( "Component.Database" );
+
+      if( requested == "Simple DB"  ) return std::make_unique<SimpleDB>();
+      if( requested == "Sharded DB" ) return std::make_unique<ShardedDB>();
 
-    static SelectedDatabase instance;    // Note the creation of a DB specialization (derived class), but returning a reference to
+      throw PersistenceException( "Unknown Database object requested: \"" + requested + "\"\n  detected in function " + __func__ );
+    }();
+                                         // Note the creation of a DB specialization (derived class), but returning a reference to
                                          // the generalization (base class). Since SimpleDB is-a PersistenceHandler, we can return a
                                          // reference to the base class that refers to a specific derived class.  SimpleDB is
                                          // accessed polymorphicly through the PersistenceHandler interface.  This source file knows
                                          // about the specific SimpleDB derived class, but that's okay.  This source file is not
                                          // delivered with the interface and remains That is, PersistenceHandler.hpp is given to the
                                          // upper architectural layers, but not PersistenceHandler.cpp.
-    return instance;
+    return *instance;
   }
 }    // namespace TechnicalServices::Persistence
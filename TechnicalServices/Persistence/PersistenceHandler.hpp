@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>      // size_t
 #include <map>
 #include <stdexcept>    // domain_error, runtime_error
 #include <string>
@@ -39,6 +40,45 @@ namespace TechnicalServices::Persistence
       std::string               status;
   };
 
+  // Where a search resumes for its next page.  Jobs are only ever appended, a changed job taking a new place at the end, so a
+  // cursor stays valid as jobs are added, changed and removed.
+  struct SearchCursor
+  {
+      std::vector<std::string>  criteria;              // as given to searchByCriteria()
+      std::string               query     = {};        // as given to searchByQuery(), searched instead of criteria if not empty
+      std::size_t               nextRow   = 0;         // position in the catalog to resume from
+      bool                      exhausted = false;     // true once every match has been returned
+  };
+
+  // Function argument type definitions
+  struct SearchPage
+  {
+      std::vector<JobInfo>      jobs;                  // at most a page of matches, in catalog order
+      SearchCursor              next;                  // resumes after the last of jobs
+  };
+
+  // Function argument type definitions
+  struct Suggestion
+  {
+      std::string               value;                 // of a job's name, location or category
+      std::size_t               jobs;                  // having that value
+  };
+
+  // Function argument type definitions
+  struct SavedSearch
+  {
+      std::size_t               id;
+      std::string               query;                 // as given to saveSearch()
+  };
+
+  // Function argument type definitions
+  struct JobAlert
+  {
+      std::size_t               search;                // id of the saved search matched
+      std::string               query;                 // its query
+      JobInfo                   job;                   // posted since the search was saved
+  };
+
   // Persistence Package within the Technical Services Layer Abstract class
   // Singleton Class - only one instance of the DB exists for the entire system
   class PersistenceHandler
@@ -50,6 +90,7 @@ namespace TechnicalServices::Persistence
       struct   NoSuchUser         : PersistenceException {using PersistenceException::PersistenceException;};
       struct   NoSuchJob          : PersistenceException { using PersistenceException::PersistenceException; };
       struct   NoSuchProperty     : PersistenceException {using PersistenceException::PersistenceException;};
+      struct   BadQuery           : PersistenceException { using PersistenceException::PersistenceException; };
 
       // Creation (Singleton)
       PersistenceHandler            (                            ) = default;
@@ -62,8 +103,33 @@ namespace TechnicalServices::Persistence
       virtual std::vector<std::string> findRoles()                                       = 0;   // Returns list of all legal roles
       virtual std::vector<Application>     getUserApplication(const std::string& name)   = 0;
       virtual bool                      makeApplication(const std::string& name, int jobId) = 0;
+      virtual bool                     updateApplicationStatus( const std::string & name, int jobId, const std::string & status ) = 0;   // Returns false if user hasn't applied for job
+      virtual std::vector<Application> getJobApplicants( int jobId, const std::string & status, std::size_t offset, std::size_t pageSize ) = 0;   // Returns one page of a job's applications with status ("0" for any)
       virtual UserCredentials          findCredentialsByName( const std::string & name ) = 0;   // Returns credentials for specified user, throws NoSuchUser if user not found
       virtual std::vector<JobInfo>     searchByCriteria(const std::vector<std::string>& args) = 0;   // Returns matching jobs for criteria, throws NoSuchJob if not found
+      virtual SearchPage               searchPage( const SearchCursor & cursor, std::size_t pageSize ) = 0;   // Returns the next page of jobs matching cursor's criteria or query, so callers hold a page at a time
+      virtual std::vector<JobInfo>     searchTopK( const std::vector<std::string> & args, std::size_t k ) = 0;   // Returns the k jobs most relevant to the keyword criterion, best first, location and category filter as usual
+      virtual std::vector<JobInfo>     recommendJobs( const std::string & name, std::size_t n ) = 0;   // Returns up to n jobs most like those the user has applied for (see RelevanceIndex), best first, none applied for included, none at all if the user hasn't applied for any
+      virtual std::size_t              countByFacets( const std::string & location, const std::string & category ) = 0;   // Returns number of jobs with exactly this location and category, ignoring case, accents and spacing, "0" matches any
+      virtual std::vector<JobInfo>     searchByQuery( const std::string & query ) = 0;   // Returns jobs matching a boolean query (see JobQuery), throws BadQuery if it isn't one
+      virtual std::string              explainQuery ( const std::string & query ) = 0;   // Returns how searchByQuery() would find the query's jobs, for tuning
+      virtual std::vector<Suggestion>  suggest( std::size_t criterion, const std::string & prefix, std::size_t limit ) = 0;   // Returns up to limit values of searchByCriteria()'s criterion (0 keyword, 1 location, 2 category) having a word starting with prefix, most jobs first
+      virtual JobInfo                  findJob( int jobId ) = 0;   // Returns the job with this id, throws NoSuchJob if there's no such job
+      virtual std::vector<JobInfo>     findDuplicates( int jobId ) = 0;   // Returns the job's near duplicates (see DuplicateIndex), the earliest posting of them and its other copies, earliest first, throws NoSuchJob if there's no such job
+
+      // Saved searches, each a boolean query (see JobQuery) for which a user is alerted to every job posted after it's saved
+      // (see SavedSearches), kept until shutdown.  Only jobs added alert, not jobs changed.
+      virtual std::size_t              saveSearch   ( const std::string & name, const std::string & query ) = 0;   // Returns the search's id, throws BadQuery if it isn't a query
+      virtual std::vector<SavedSearch> savedSearches( const std::string & name ) = 0;                              // Returns the user's saved searches, in the order saved
+      virtual bool                     forgetSearch ( const std::string & name, std::size_t id ) = 0;              // Returns false if the user saved no such search
+      virtual std::vector<JobAlert>    takeAlerts   ( const std::string & name ) = 0;                              // Returns the user's alerts not yet taken, oldest first, the oldest dropped once too many are queued
+
+      // Job catalog changes, kept until shutdown.  Each returns false, changing nothing, if a job with that id already exists (add)
+      // or doesn't (update, remove).  Add also returns false if near duplicates are collapsed (Persistence.NearDuplicates) and
+      // the job nearly duplicates one already posted.
+      virtual bool                     addJob   ( const JobInfo & job ) = 0;
+      virtual bool                     updateJob( const JobInfo & job ) = 0;   // Replaces the job with job.id
+      virtual bool                     removeJob( int jobId )           = 0;
 
 
       // Adaptation Data read only access.  Adaptation data is a Key/Value pair
@@ -0,0 +1,185 @@
+#include "TechnicalServices/Persistence/QueryCache.hpp"
+
+#include <cstddef>      // size_t
+#include <functional>   // hash
+#include <iterator>     // prev()
+#include <mutex>        // lock_guard
+#include <optional>
+#include <string>
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    // A single result may take at most this fraction of the capacity, so one enormous result can't flush everything else
+    constexpr std::size_t LargestShare = 8;
+  }
+
+
+
+
+  QueryCache::QueryCache( std::size_t capacity ) : _capacity( capacity )
+  {}
+
+
+
+
+  std::size_t QueryCache::KeyHash::operator()( const Key & key ) const noexcept
+  {
+    std::size_t hash = std::hash<std::size_t>{}( key.from ) ^ ( std::hash<std::size_t>{}( key.limit ) << 1 );
+    for( const auto & criterion : key.criteria ) hash = hash * 31 + std::hash<std::string>{}( criterion );
+    return hash * 31 + std::hash<std::string>{}( key.query );
+  }
+
+
+
+
+  // Criteria that always give the same results share a key.  Matching is by substring of the normalized forms, so criteria
+  // differing only in case, accents or spacing are one key, as are the skipped criterion's two spellings:  "0" and empty both match
+  // anything.
+  QueryCache::Key QueryCache::key( const std::vector<std::string> & args, std::size_t from, std::size_t limit )
+  {
+    Key key{ {}, {}, from, limit };
+    for( std::size_t field = 0; field != JobFieldCount; ++field ) key.criteria[field] = args[field] == "0" ? "" : normalize( args[field] );
+    return key;
+  }
+
+
+
+
+  // The same substring semantics searchByCriteria() applies, or the query's own, normalized being normalize( job )
+  bool QueryCache::matches( const Entry & entry, const JobInfo & job, const JobInfo & normalized )
+  {
+    if( entry.query ) return entry.query->matches( job, normalized );
+
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+      if( fieldValue( normalized, static_cast<JobField>( field ) ).find( entry.key.criteria[field] ) == std::string::npos ) return false;
+    return true;
+  }
+
+
+
+
+  std::size_t QueryCache::bytes( const Key & key, const Result & result )
+  {
+    // The entry, its list and map nodes, the text of the key and where each job is
+    std::size_t total = sizeof( Entry ) + 4 * sizeof( void * ) + result.size() * sizeof( Match ) + key.query.size();
+    for( const auto & criterion : key.criteria ) total += criterion.size();
+    return total;
+  }
+
+
+
+
+  std::optional<QueryCache::Result> QueryCache::find( const std::vector<std::string> & args, std::size_t from, std::size_t limit )
+  {
+    if( _capacity == 0 ) return std::nullopt;
+    return find( key( args, from, limit ) );
+  }
+
+
+
+
+  std::optional<QueryCache::Result> QueryCache::find( const JobQuery & query, std::size_t from, std::size_t limit )
+  {
+    if( _capacity == 0 ) return std::nullopt;
+    return find( Key{ {}, JobQuery::describe( query.root() ), from, limit } );
+  }
+
+
+
+
+  std::optional<QueryCache::Result> QueryCache::find( const Key & wanted )
+  {
+    std::lock_guard lock( _mutex );
+
+    auto entry = _byKey.find( wanted );
+    if( entry == _byKey.cend() ) { ++_misses; return std::nullopt; }
+
+    ++_hits;
+    _entries.splice( _entries.begin(), _entries, entry->second );
+    return entry->second->result;
+  }
+
+
+
+
+  void QueryCache::insert( const std::vector<std::string> & args, std::size_t from, std::size_t limit, const Result & result )
+  {
+    if( _capacity == 0 ) return;
+    insert( key( args, from, limit ), std::nullopt, result );
+  }
+
+
+
+
+  void QueryCache::insert( const JobQuery & query, std::size_t from, std::size_t limit, const Result & result )
+  {
+    if( _capacity == 0 ) return;
+    insert( Key{ {}, JobQuery::describe( query.root() ), from, limit }, query, result );
+  }
+
+
+
+
+  void QueryCache::insert( Key entryKey, std::optional<JobQuery> query, const Result & result )
+  {
+    auto entryBytes = bytes( entryKey, result );
+    if( entryBytes > _capacity / LargestShare ) return;
+
+    std::lock_guard lock( _mutex );
+    if( _byKey.contains( entryKey ) ) return;    // another thread got there first
+
+    _entries.push_front( { entryKey, std::move( query ), result, entryBytes } );
+    _byKey.emplace( std::move( entryKey ), _entries.begin() );
+    _bytes += entryBytes;
+
+    while( _bytes > _capacity ) erase( std::prev( _entries.end() ) );
+  }
+
+
+
+
+  void QueryCache::invalidate( const JobInfo & job, RowId position )
+  {
+    auto            normalized = normalize( job );
+    std::lock_guard lock( _mutex );
+
+    // A full result ending before the job can't gain or lose it, so only results whose range could include it are affected
+    for( auto entry = _entries.begin(); entry != _entries.end(); )
+    {
+      auto current = entry++;
+      const auto & result = current->result;
+
+      bool inRange = position >= current->key.from && ( result.size() < current->key.limit || ( !result.empty() && position <= result.back().position ) );
+      if( inRange && matches( *current, job, normalized ) ) erase( current );
+    }
+  }
+
+
+
+
+  QueryCache::Statistics QueryCache::statistics() const
+  {
+    std::lock_guard lock( _mutex );
+    return { _hits, _misses, _entries.size(), _bytes };
+  }
+
+
+
+
+  void QueryCache::erase( Entries::iterator entry )
+  {
+    _bytes -= entry->bytes;
+    _byKey.erase( entry->key );
+    _entries.erase( entry );
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstddef>          // size_t
+#include <cstdint>          // uint64_t
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>          // pair
+#include <vector>
+
+#include "TechnicalServices/Persistence/JobQuery.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Query Cache
+  **   Remembers the results of recent job searches, so a search repeated (the popular ones, the same first page asked for again)
+  **   is answered without touching the indexes.  Results are kept by criteria, or by query, and the range of catalog positions
+  **   asked for, and the least recently used are evicted once their combined size exceeds the capacity.  Queries are keyed by
+  **   their fully parenthesized text (see JobQuery::describe()), so queries differing only in spacing or redundant parentheses share
+  **   results.  A result holds where its jobs are rather than copies of them, so the jobs are rebuilt from the job table's columns
+  **   as they're returned and an entry costs a few words per job.
+  **
+  **   A changed job invalidates exactly the results it could have changed:  those whose criteria or query it matches, before or
+  **   after the change, and whose range its catalog position falls within.  Results for other searches, and full pages that end
+  **   before the job, stay cached.  Any number of threads may use the cache at once.
+  ******************************************************************************/
+  class QueryCache
+  {
+    public:
+      // Where a matching job is:  its catalog position, and the partition and row holding it
+      struct Match
+      {
+        RowId         position;
+        std::uint32_t partition;
+        RowId         row;
+      };
+
+      using Result = std::vector<Match>;    // in catalog order
+
+      struct Statistics
+      {
+        std::uint64_t hits    = 0;
+        std::uint64_t misses  = 0;
+        std::size_t   entries = 0;
+        std::size_t   bytes   = 0;    // of the results held, approximately
+
+        double hitRatio() const { return hits + misses == 0 ? 0.0 : static_cast<double>( hits ) / static_cast<double>( hits + misses ); }
+      };
+
+
+      // Constructors
+      explicit QueryCache( std::size_t capacity );    // in bytes, 0 disables the cache
+      QueryCache( const QueryCache & ) = delete;
+      QueryCache & operator=( const QueryCache & ) = delete;
+
+
+      // Operations
+      // The result of searching args from catalog position from for up to limit matches, if cached
+      std::optional<Result> find  ( const std::vector<std::string> & args, std::size_t from, std::size_t limit );
+      void                  insert( const std::vector<std::string> & args, std::size_t from, std::size_t limit, const Result & result );
+
+      // The same for a query's matches
+      std::optional<Result> find  ( const JobQuery & query, std::size_t from, std::size_t limit );
+      void                  insert( const JobQuery & query, std::size_t from, std::size_t limit, const Result & result );
+
+      // Forgets the results the job at catalog position could change by being added, changed or removed
+      void                  invalidate( const JobInfo & job, RowId position );
+
+      Statistics            statistics() const;
+
+    private:
+      struct Key
+      {
+        std::array<std::string, JobFieldCount> criteria;    // normalized, "0" resolved to empty, which matches anything
+        std::string                            query;       // described, empty for criteria
+        std::size_t                            from;
+        std::size_t                            limit;
+
+        bool operator==( const Key & ) const = default;
+      };
+
+      struct KeyHash
+      {
+        std::size_t operator()( const Key & key ) const noexcept;
+      };
+
+      struct Entry
+      {
+        Key                     key;
+        std::optional<JobQuery> query;    // to match changed jobs against, the key's criteria being all empty
+        Result                  result;
+        std::size_t             bytes;
+      };
+
+      using Entries = std::list<Entry>;    // most recently used first
+
+      static Key         key    ( const std::vector<std::string> & args, std::size_t from, std::size_t limit );
+      static bool        matches( const Entry & entry, const JobInfo & job, const JobInfo & normalized );
+      static std::size_t bytes  ( const Key & key, const Result & result );
+
+      std::optional<Result> find  ( const Key & wanted );
+      void                  insert( Key entryKey, std::optional<JobQuery> query, const Result & result );
+      void                  erase ( Entries::iterator entry );
+
+      const std::size_t                                          _capacity;
+      mutable std::mutex                                         _mutex;
+      Entries                                                    _entries;
+      std::unordered_map<Key, Entries::iterator, KeyHash>        _byKey;
+      std::size_t                                                _bytes  = 0;
+      std::uint64_t                                              _hits   = 0;
+      std::uint64_t                                              _misses = 0;
+  };    // class QueryCache
+}    // namespace TechnicalServices::Persistence
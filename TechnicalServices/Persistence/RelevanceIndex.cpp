@@ -0,0 +1,300 @@
+#include "TechnicalServices/Persistence/RelevanceIndex.hpp"
+
+#include <algorithm>    // max(), min(), partial_sort()
+#include <cctype>       // isalnum(), tolower()
+#include <cmath>        // log()
+#include <cstddef>      // ptrdiff_t, size_t
+#include <cstdint>      // uint8_t, uint16_t, uint64_t
+#include <functional>   // function, greater
+#include <map>
+#include <span>
+#include <limits>       // numeric_limits
+#include <queue>        // priority_queue
+#include <string>
+#include <string_view>
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace
+{
+  // BM25F parameters:  term frequency saturation, length normalization, and how much a match in each field counts
+  constexpr double K1             = 1.2;
+  constexpr double B              = 0.75;
+  constexpr double FieldWeights[] = { 3.0 /*Name*/, 2.0 /*Category*/, 1.0 /*Description*/ };
+
+
+  // How rare a term is across a catalog of rows, containing of which contain it
+  double idf( double rows, double containing )
+  {
+    return std::log( 1.0 + ( rows - containing + 0.5 ) / ( containing + 0.5 ) );
+  }
+
+
+  // A candidate for the result, ordered so the heap's top is the weakest one kept
+  struct Ranked
+  {
+    double                                  score;
+    TechnicalServices::Persistence::RowId   row;
+
+    bool operator>( const Ranked & rhs ) const noexcept { return score > rhs.score || ( !( score < rhs.score ) && row < rhs.row ); }
+  };
+}    // namespace
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  std::vector<std::string> RelevanceIndex::terms( std::string_view text )
+  {
+    std::vector<std::string> terms;
+    std::string              term;
+    for( auto character : text )
+    {
+      auto c = static_cast<unsigned char>( character );
+      if( std::isalnum( c ) ) { term += static_cast<char>( std::tolower( c ) ); continue; }
+      if( !term.empty() ) terms.push_back( std::move( term ) );
+      term.clear();
+    }
+    if( !term.empty() ) terms.push_back( std::move( term ) );
+    return terms;
+  }
+
+
+
+
+  void RelevanceIndex::insert( RowId row, const JobInfo & job )
+  {
+    const std::string * fields[Fields] = { &job.name, &job.category, &job.description };
+
+    auto & lengths = _lengths.writable().emplace_back();
+    for( std::size_t field = 0; field != Fields; ++field )
+    {
+      auto words = terms( *fields[field] );
+      lengths[field] = static_cast<std::uint16_t>( std::min<std::size_t>( words.size(), std::numeric_limits<std::uint16_t>::max() ) );
+      _totalLengths[field] += lengths[field];
+
+      for( auto & word : words )
+      {
+        auto & postings = _postings[std::move( word )].writable();
+        if( postings.empty() || postings.back().row != row ) postings.push_back( { row, {}, 0 } );
+
+        auto & frequency = postings.back().frequency[field];
+        if( frequency != std::numeric_limits<std::uint8_t>::max() ) ++frequency;
+      }
+    }
+  }
+
+
+
+
+  RelevanceIndex::Profile RelevanceIndex::distinctTerms( const std::string & query )
+  {
+    Profile words;
+    for( auto & word : terms( query ) ) words.insert_or_assign( std::move( word ), 1.0 );
+    return words;
+  }
+
+
+
+
+  RelevanceIndex::Profile RelevanceIndex::profile( std::span<const JobInfo> jobs )
+  {
+    Profile profile;
+    for( const auto & job : jobs )
+    {
+      const std::string * fields[Fields] = { &job.name, &job.category, &job.description };
+      for( std::size_t field = 0; field != Fields; ++field )
+        for( auto & word : terms( *fields[field] ) ) profile[std::move( word )] += FieldWeights[field];
+    }
+    return profile;
+  }
+
+
+
+
+  RelevanceIndex::Profile RelevanceIndex::mostTelling( const Profile & profile, const Statistics & catalog, std::size_t terms )
+  {
+    struct Telling
+    {
+      double                    weight;
+      Profile::const_iterator   term;
+    };
+
+    std::vector<Telling> telling;
+    auto                 containing = catalog.containing.cbegin();
+    for( auto term = profile.cbegin(); term != profile.cend() && containing != catalog.containing.cend(); ++term, ++containing )
+      if( *containing * 2 < catalog.rows ) telling.push_back( { term->second * idf( static_cast<double>( catalog.rows ), static_cast<double>( *containing ) ), term } );
+
+    auto kept = std::min( telling.size(), terms );
+    std::partial_sort( telling.begin(), telling.begin() + static_cast<std::ptrdiff_t>( kept ), telling.end(),
+                       []( const Telling & lhs, const Telling & rhs ) { return lhs.weight > rhs.weight || ( !( lhs.weight < rhs.weight ) && lhs.term->first < rhs.term->first ); } );
+
+    Profile mostTelling;
+    for( std::size_t term = 0; term != kept; ++term ) mostTelling.insert( *telling[term].term );
+    return mostTelling;
+  }
+
+
+
+
+  RelevanceIndex::Statistics & RelevanceIndex::Statistics::operator+=( const Statistics & rhs )
+  {
+    rows += rhs.rows;
+    for( std::size_t field = 0; field != Fields; ++field ) totalLengths[field] += rhs.totalLengths[field];
+
+    containing.resize( std::max( containing.size(), rhs.containing.size() ) );
+    for( std::size_t term = 0; term != rhs.containing.size(); ++term ) containing[term] += rhs.containing[term];
+    return *this;
+  }
+
+
+
+
+  RelevanceIndex::Statistics RelevanceIndex::statistics( const std::string & query ) const
+  {
+    return statistics( distinctTerms( query ) );
+  }
+
+
+
+
+  RelevanceIndex::Statistics RelevanceIndex::statistics( const Profile & profile ) const
+  {
+    Statistics statistics{ _lengths.size(), _totalLengths, {} };
+    for( const auto & [word, weight] : profile )
+    {
+      auto entry = _postings.find( word );
+      statistics.containing.push_back( entry == _postings.cend() ? 0 : entry->second.size() );
+    }
+    return statistics;
+  }
+
+
+
+
+  std::vector<RelevanceIndex::Match> RelevanceIndex::topK( const std::string & query, std::size_t k, const std::function<bool( RowId )> & accept ) const
+  {
+    return topK( query, k, accept, statistics( query ) );
+  }
+
+
+
+
+  std::vector<RelevanceIndex::Match> RelevanceIndex::topK( const std::string & query, std::size_t k, const std::function<bool( RowId )> & accept,
+                                                           const Statistics & catalog ) const
+  {
+    return topK( distinctTerms( query ), k, accept, catalog );
+  }
+
+
+
+
+  std::vector<RelevanceIndex::Match> RelevanceIndex::topK( const Profile & profile, std::size_t k, const std::function<bool( RowId )> & accept,
+                                                           const Statistics & catalog ) const
+  {
+    std::vector<Match> results;
+    if( k == 0 || _lengths.empty() ) return results;
+
+    // Each distinct term found here contributes a posting list, weighted by how rare the term is across the catalog and by the
+    // term's own weight
+    struct Cursor
+    {
+      const MappedArray<Posting> * postings;
+      std::size_t                  next;
+      double                       weight;
+    };
+
+    const auto          rows       = static_cast<double>( catalog.rows );
+    auto                containing = catalog.containing.cbegin();
+    std::vector<Cursor> cursors;
+    for( auto word = profile.cbegin(); word != profile.cend() && containing != catalog.containing.cend(); ++word, ++containing )
+    {
+      auto entry = _postings.find( word->first );
+      if( entry == _postings.cend() ) continue;
+
+      cursors.push_back( { &entry->second, 0, word->second * idf( rows, static_cast<double>( *containing ) ) } );
+    }
+
+    std::array<double, Fields> averageLengths;
+    for( std::size_t field = 0; field != Fields; ++field ) averageLengths[field] = std::max( 1.0, static_cast<double>( catalog.totalLengths[field] ) / rows );
+
+
+    // Merge the posting lists a row at a time, scoring each row once all its terms are known.  The heap holds the best k so
+    // far with the weakest on top, so a row either displaces it or is dropped straight away.
+    std::priority_queue<Ranked, std::vector<Ranked>, std::greater<>> best;
+    while( true )
+    {
+      auto row = std::numeric_limits<RowId>::max();
+      bool any = false;
+      for( const auto & cursor : cursors ) if( cursor.next != cursor.postings->size() )
+      {
+        row = std::min( row, ( *cursor.postings )[cursor.next].row );
+        any = true;
+      }
+      if( !any ) break;
+
+      double score = 0.0;
+      for( auto & cursor : cursors )
+      {
+        if( cursor.next == cursor.postings->size() || ( *cursor.postings )[cursor.next].row != row ) continue;
+
+        const auto & posting   = ( *cursor.postings )[cursor.next++];
+        double       frequency = 0.0;
+        for( std::size_t field = 0; field != Fields; ++field )
+          frequency += FieldWeights[field] * posting.frequency[field] / ( 1.0 - B + B * _lengths[row][field] / averageLengths[field] );
+
+        score += cursor.weight * frequency * ( K1 + 1.0 ) / ( frequency + K1 );
+      }
+
+      Ranked candidate{ score, row };
+      if( best.size() == k && !( candidate > best.top() ) ) continue;
+      if( !accept( row ) ) continue;                  // checked only for rows good enough to make the cut
+
+      if( best.size() == k ) best.pop();
+      best.push( candidate );
+    }
+
+    results.resize( best.size() );
+    for( auto result = results.rbegin(); result != results.rend(); ++result, best.pop() ) *result = { best.top().row, best.top().score };
+    return results;
+  }
+
+
+
+
+  void RelevanceIndex::save( SnapshotWriter & image ) const
+  {
+    image.write( std::uint64_t{ _postings.size() } );
+    for( const auto & [term, postings] : _postings ) { image.write( term ); image.write( postings ); }
+
+    image.write( _lengths );
+    for( auto total : _totalLengths ) image.write( total );
+  }
+
+
+
+
+  void RelevanceIndex::load( SnapshotReader & image )
+  {
+    _postings.clear();
+    for( auto terms = image.readInteger(); terms != 0; --terms )
+    {
+      auto term = image.readString();
+      _postings.insert_or_assign( std::move( term ), image.viewArray<Posting>() );
+    }
+
+    _lengths = image.viewArray<std::array<std::uint16_t, Fields>>();
+    for( auto & total : _totalLengths ) total = image.readInteger();
+
+    // Postings index straight into the row lengths, so make sure none reach outside them
+    for( const auto & [term, postings] : _postings )
+      for( const auto & posting : postings )
+        if( posting.row >= _lengths.size() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, relevance posting out of range" );
+  }
+}    // namespace TechnicalServices::Persistence
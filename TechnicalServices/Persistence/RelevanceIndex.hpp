@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>       // size_t
+#include <cstdint>       // uint8_t, uint16_t, uint64_t
+#include <functional>    // function
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Relevance Index
+  **   Ranks jobs against a keyword query with BM25F:  each query term found in a job's name, category or description scores by
+  **   how rare the term is across the catalog and how often it appears in the job, weighted by field (a name match counts most)
+  **   and normalized by field length.  The index keeps one posting list per term recording the term's frequency in each field.
+  **
+  **   Only the best k jobs are kept while the query's posting lists are merged, in a heap of k entries, so the full set of
+  **   matching jobs is never materialized and the cost is proportional to the posting lists merged, not to the results.
+  **
+  **   A query may instead be a profile, a sparse vector of weighted terms such as those of the jobs a seeker has applied for.
+  **   Each term's score is then multiplied by its weight, so a job scores the dot product of the profile's term frequencies and
+  **   its own TF-IDF weights, and the jobs most like the profile come first.  Only the profile's most telling terms are merged,
+  **   so a long profile costs no more than a long query.
+  ******************************************************************************/
+  class RelevanceIndex
+  {
+    public:
+      static constexpr std::size_t Fields           = 3;     // name, category, description
+      static constexpr std::size_t MostProfileTerms = 16;    // merged when ranking by profile
+
+      using Profile = std::map<std::string /*Term*/, double /*Weight*/>;
+
+      struct Match
+      {
+        RowId  row;
+        double score;
+      };
+
+      // The catalog wide figures a query's scores depend on.  An index over part of the catalog scores exactly as one over the
+      // whole would, given the statistics summed over every part.
+      struct Statistics
+      {
+        std::uint64_t                     rows         = 0;
+        std::array<std::uint64_t, Fields> totalLengths = {};
+        std::vector<std::uint64_t>        containing;         // per distinct query term, in sorted order, the rows containing it
+
+        Statistics & operator+=( const Statistics & rhs );
+      };
+
+
+      // Operations
+      void insert( RowId row, const JobInfo & job );                                               // rows must be inserted in ascending order
+
+      // Returns up to k of the rows accepted, most relevant first, ties in row order.  Only rows containing at least one of the
+      // query's terms are considered.  Scored by this index's own statistics unless given the whole catalog's.
+      std::vector<Match> topK( const std::string & query, std::size_t k, const std::function<bool( RowId )> & accept ) const;
+      std::vector<Match> topK( const std::string & query, std::size_t k, const std::function<bool( RowId )> & accept, const Statistics & catalog ) const;
+      Statistics         statistics( const std::string & query ) const;
+
+      // As above, for a profile rather than a query
+      std::vector<Match> topK( const Profile & profile, std::size_t k, const std::function<bool( RowId )> & accept, const Statistics & catalog ) const;
+      Statistics         statistics( const Profile & profile ) const;
+
+      static std::vector<std::string> terms( std::string_view text );                             // lower case runs of letters and digits
+
+      // The terms of jobs' names, categories and descriptions, each weighted by how often it appears, by field as it's scored.
+      // The jobs' text must be normalized (see Normalization) as indexed text is.
+      static Profile                  profile( std::span<const JobInfo> jobs );
+
+      // The terms of profile most telling of it, weighing each by how rare it is in the catalog.  Terms in at least half the
+      // catalog's jobs tell none of them apart and are left out.
+      static Profile                  mostTelling( const Profile & profile, const Statistics & catalog, std::size_t terms );
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      static Profile                  distinctTerms( const std::string & query );                 // each weighing 1
+
+      struct Posting
+      {
+        RowId        row;
+        std::uint8_t frequency[Fields];           // saturates at 255
+        std::uint8_t unused;                      // explicit, so postings are copied into snapshot images without stray bytes
+      };
+
+      std::unordered_map<std::string /*Term*/, MappedArray<Posting>> _postings;
+      MappedArray<std::array<std::uint16_t, Fields>>                 _lengths;                    // terms per field, per row
+      std::array<std::uint64_t, Fields>                              _totalLengths = {};
+  };    // class RelevanceIndex
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,145 @@
+#include "TechnicalServices/Persistence/SalaryIndex.hpp"
+
+#include <cctype>       // isdigit(), tolower()
+#include <cmath>        // llround()
+#include <cstddef>      // size_t
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>      // pair
+#include <vector>
+
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    using Period = SalaryIndex::Salary::Period;
+
+    // The words (and abbreviations) naming each period
+    constexpr std::pair<Period, std::string_view> periodWords[] = {
+      { Period::Year,  "year"  }, { Period::Year,  "yr"    }, { Period::Year, "annual" }, { Period::Year, "annum" },
+      { Period::Month, "month" },
+      { Period::Week,  "week"  }, { Period::Week,  "wk"    },
+      { Period::Day,   "day"   }, { Period::Day,   "daily" },
+      { Period::Hour,  "hour"  }, { Period::Hour,  "hr"    } };
+  }    // namespace
+
+
+
+
+  SalaryIndex::Rate SalaryIndex::Salary::hourly() const
+  {
+    double hours = 1;
+    switch( period )
+    {
+      case Period::Day:   hours = 8;                break;
+      case Period::Week:  hours = 40;               break;
+      case Period::Month: hours = 2080.0 / 12;      break;
+      case Period::Year:  hours = 2080;             break;
+      case Period::Hour:
+      default:            break;
+    }
+
+    auto cents = std::llround( amount * 100 / hours );
+    return cents < 0 ? 0 : cents > static_cast<long long>( Highest ) ? Highest : static_cast<Rate>( cents );
+  }
+
+
+
+
+  std::optional<SalaryIndex::Salary> SalaryIndex::parse( std::string_view text )
+  {
+    auto digit = [&]( std::size_t at ) { return at < text.size() && std::isdigit( static_cast<unsigned char>( text[at] ) ); };
+
+    std::size_t at = 0;
+    while( at < text.size() && !digit( at ) && !( text[at] == '.' && digit( at + 1 ) ) ) ++at;
+    if( at == text.size() ) return std::nullopt;
+
+    // Digits, thousands separators and at most one decimal point, then an optional "k" for thousands
+    double amount   = 0;
+    double place    = 1;       // of the next digit after the decimal point
+    bool   fraction = false;
+    for( ; at < text.size(); ++at )
+    {
+      if( digit( at ) )
+      {
+        if( !fraction ) amount = amount * 10 + ( text[at] - '0' );
+        else          { place /= 10; amount += ( text[at] - '0' ) * place; }
+      }
+      else if( text[at] == '.' && !fraction && digit( at + 1 ) ) fraction = true;
+      else if( text[at] != ',' || !digit( at + 1 ) ) break;
+    }
+    if( at < text.size() && ( text[at] == 'k' || text[at] == 'K' ) ) { amount *= 1000; ++at; }
+
+    std::string rest;
+    for( ; at < text.size(); ++at ) rest += static_cast<char>( std::tolower( static_cast<unsigned char>( text[at] ) ) );
+
+    // The period named soonest after the amount is the one it's paid per, so "20$ / hour, 40 hours a week" is per hour
+    Salary      salary{ amount, Period::Hour };
+    std::size_t nearest = std::string::npos;
+    for( const auto & [period, word] : periodWords )
+      if( auto found = rest.find( word ); found < nearest ) { nearest = found; salary.period = period; }
+
+    return salary;
+  }
+
+
+
+
+  void SalaryIndex::insert( RowId row, const JobInfo & job )
+  {
+    auto salary = parse( job.salary );
+    auto rate   = salary ? salary->hourly() : Unknown;
+
+    _rates.push_back( rate );
+    if( rate != Unknown ) _byRate[rate].push_back( row );
+  }
+
+
+
+
+  PostingList SalaryIndex::matching( const Range & range ) const
+  {
+    if( range.low > range.high ) return {};
+
+    std::vector<PostingView> lists;
+    for( auto rows = _byRate.lower_bound( range.low ), end = _byRate.upper_bound( range.high ); rows != end; ++rows ) lists.push_back( rows->second );
+    return uniteAll( lists );
+  }
+
+
+
+
+  std::size_t SalaryIndex::cardinality( const Range & range ) const
+  {
+    if( range.low > range.high ) return 0;
+
+    std::size_t rows = 0;
+    for( auto rate = _byRate.lower_bound( range.low ), end = _byRate.upper_bound( range.high ); rate != end; ++rate ) rows += rate->second.size();
+    return rows;
+  }
+
+
+
+
+  // Only the rates are saved, the ordering is rebuilt from them
+  void SalaryIndex::save( SnapshotWriter & image ) const
+  {
+    image.write( _rates );
+  }
+
+
+
+
+  void SalaryIndex::load( SnapshotReader & image )
+  {
+    _rates = image.viewArray<Rate>();
+    _byRate.clear();
+    for( RowId row = 0; row != _rates.size(); ++row ) if( _rates[row] != Unknown ) _byRate[_rates[row]].push_back( row );
+  }
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>        // uint32_t
+#include <cstddef>        // size_t
+#include <limits>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Salary Index
+  **   Salaries are free form text such as "15$ / hour" or "$52,000 a year".  Each is parsed once, as it's inserted, into an
+  **   amount and the period it's paid per, and normalized to cents an hour (a year being 2,080 working hours) so salaries paid
+  **   per different periods compare.  The rows are kept ordered by that rate, so the rows paying within a range are found by
+  **   looking up its ends rather than by scanning.  A salary that can't be parsed is never within any range.
+  ******************************************************************************/
+  class SalaryIndex
+  {
+    public:
+      using Rate = std::uint32_t;    // cents an hour
+
+      static constexpr Rate Unknown = std::numeric_limits<Rate>::max();    // no salary could be parsed
+      static constexpr Rate Highest = Unknown - 1;
+
+      struct Salary
+      {
+        enum class Period { Hour, Day, Week, Month, Year };
+
+        double amount;    // in dollars
+        Period period;
+
+        Rate hourly() const;
+      };
+
+      // Inclusive bounds, by default every parsed salary
+      struct Range
+      {
+        Rate low  = 0;
+        Rate high = Highest;
+
+        bool contains( Rate rate ) const { return rate != Unknown && low <= rate && rate <= high; }
+      };
+
+
+      // Operations
+      // The first amount in text (so the lower end of "15-20$ / hour") and the period named after it, hourly if none is named
+      static std::optional<Salary> parse( std::string_view text );
+
+      void        insert     ( RowId row, const JobInfo & job );    // rows must be inserted in ascending order
+      Rate        rate       ( RowId row ) const { return _rates[row]; }
+      std::size_t size       ()            const { return _rates.size(); }
+
+      // Returns exactly the rows paying within range, or just how many there are
+      PostingList matching   ( const Range & range ) const;
+      std::size_t cardinality( const Range & range ) const;
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      MappedArray<Rate>              _rates;     // by row
+      std::map<Rate, PostingList>    _byRate;    // parsed salaries only
+  };    // class SalaryIndex
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,198 @@
+#include "TechnicalServices/Persistence/SavedSearches.hpp"
+
+#include <algorithm>    // lower_bound(), sort(), unique()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t
+#include <iterator>     // make_move_iterator()
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>      // move()
+#include <vector>
+
+#include "TechnicalServices/Persistence/Normalization.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    // The trigram of text starting at start, filed for field
+    std::uint32_t anchorAt( JobField field, std::string_view text, std::size_t start )
+    {
+      return   static_cast<std::uint32_t>( field ) << 24
+             | std::uint32_t{ static_cast<unsigned char>( text[start]     ) } << 16
+             | std::uint32_t{ static_cast<unsigned char>( text[start + 1] ) } << 8
+             | std::uint32_t{ static_cast<unsigned char>( text[start + 2] ) };
+    }
+
+
+    void eraseId( std::vector<std::size_t> & ids, std::size_t id )
+    {
+      auto found = std::lower_bound( ids.begin(), ids.end(), id );
+      if( found != ids.end() && *found == id ) ids.erase( found );
+    }
+  }    // namespace
+
+
+
+
+  std::optional<SavedSearches::Anchors> SavedSearches::anchor( const JobQuery::Node & node, const Rarity & rarity )
+  {
+    using Kind = JobQuery::Node::Kind;
+
+    switch( node.kind )
+    {
+      // Every job containing the value contains each of its trigrams, so any one will do, and the rarest turns up the fewest jobs
+      case Kind::Criterion:
+      {
+        if( node.value.size() < 3 ) return std::nullopt;
+
+        std::optional<Anchors> rarest;
+        for( std::size_t start = 0; start + 3 <= node.value.size(); ++start )
+        {
+          auto jobs = rarity( node.field, node.value.substr( start, 3 ) );
+          if( !rarest || jobs < rarest->jobs ) rarest = Anchors{ { anchorAt( node.field, node.value, start ) }, jobs };
+        }
+        return rarest;
+      }
+
+      // A job matching every operand has any one operand's anchors
+      case Kind::And:
+      {
+        std::optional<Anchors> rarest;
+        for( const auto & child : node.children )
+          if( auto anchors = anchor( child, rarity ); anchors && ( !rarest || anchors->jobs < rarest->jobs ) ) rarest = std::move( anchors );
+        return rarest;
+      }
+
+      // A job matching some operand has one of that operand's anchors, so it takes every operand's
+      case Kind::Or:
+      {
+        Anchors all{ {}, 0 };
+        for( const auto & child : node.children )
+        {
+          auto anchors = anchor( child, rarity );
+          if( !anchors ) return std::nullopt;
+
+          all.anchors.insert( all.anchors.end(), anchors->anchors.cbegin(), anchors->anchors.cend() );
+          all.jobs += anchors->jobs;
+        }
+        std::sort( all.anchors.begin(), all.anchors.end() );
+        all.anchors.erase( std::unique( all.anchors.begin(), all.anchors.end() ), all.anchors.end() );
+        return all;
+      }
+
+      case Kind::Fuzzy:
+      case Kind::Range:
+      case Kind::Near:
+      case Kind::Not:
+      default:
+        return std::nullopt;
+    }
+  }
+
+
+
+
+  std::size_t SavedSearches::save( const std::string & userName, JobQuery query, const std::string & text, const Rarity & rarity )
+  {
+    auto id      = _searches.size();
+    auto anchors = anchor( query.root(), rarity );
+
+    if( anchors )
+      for( auto key : anchors->anchors )
+      {
+        _filed[key].push_back( id );
+        ++_anchoredFields[key >> 24];
+      }
+    else _unanchored.push_back( id );
+
+    _byUser[userName].push_back( id );
+    _searches.push_back( Search{ userName, text, std::move( query ), anchors ? std::move( anchors->anchors ) : std::vector<Anchor>{} } );
+    return id;
+  }
+
+
+
+
+  bool SavedSearches::forget( const std::string & userName, std::size_t id )
+  {
+    if( id >= _searches.size() || !_searches[id] || _searches[id]->userName != userName ) return false;
+
+    for( auto key : _searches[id]->anchors )
+    {
+      auto filed = _filed.find( key );
+      eraseId( filed->second, id );
+      if( filed->second.empty() ) _filed.erase( filed );
+      --_anchoredFields[key >> 24];
+    }
+    eraseId( _unanchored,       id );
+    eraseId( _byUser[userName], id );
+
+    _searches[id].reset();
+    return true;
+  }
+
+
+
+
+  std::vector<SavedSearch> SavedSearches::byUser( const std::string & userName ) const
+  {
+    std::vector<SavedSearch> searches;
+    if( auto ids = _byUser.find( userName ); ids != _byUser.cend() )
+      for( auto id : ids->second ) searches.push_back( { id, _searches[id]->text } );
+    return searches;
+  }
+
+
+
+
+  void SavedSearches::percolate( const JobInfo & job )
+  {
+    // The searches filed under one of the job's trigrams, in a field some search is anchored in, and those never filed
+    auto                     normalized = normalize( job );
+    std::vector<std::size_t> candidates = _unanchored;
+    for( std::size_t field = 0; field != Fields; ++field )
+    {
+      if( _anchoredFields[field] == 0 ) continue;
+
+      const auto & text = fieldValue( normalized, static_cast<JobField>( field ) );
+      for( std::size_t start = 0; start + 3 <= text.size(); ++start )
+        if( auto filed = _filed.find( anchorAt( static_cast<JobField>( field ), text, start ) ); filed != _filed.cend() )
+          candidates.insert( candidates.end(), filed->second.cbegin(), filed->second.cend() );
+    }
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    // Only the candidates are evaluated in full, and a user with several searches matching is alerted once, by the earliest
+    std::unordered_set<std::string_view> alerted;
+    for( auto id : candidates )
+    {
+      const auto & search = *_searches[id];
+      if( alerted.contains( search.userName ) || !search.query.matches( job, normalized ) ) continue;
+
+      auto & queue = _alerts[search.userName];
+      queue.push_back( { id, search.text, job } );
+      if( queue.size() > MostAlerts ) queue.pop_front();
+      alerted.insert( search.userName );
+    }
+  }
+
+
+
+
+  std::vector<JobAlert> SavedSearches::take( const std::string & userName )
+  {
+    auto queue = _alerts.find( userName );
+    if( queue == _alerts.end() ) return {};
+
+    std::vector<JobAlert> alerts( std::make_move_iterator( queue->second.begin() ), std::make_move_iterator( queue->second.end() ) );
+    _alerts.erase( queue );
+    return alerts;
+  }
+}    // namespace TechnicalServices::Persistence
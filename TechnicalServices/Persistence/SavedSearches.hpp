@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>        // size_t
+#include <cstdint>        // uint32_t
+#include <deque>
+#include <functional>     // function
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TechnicalServices/Persistence/JobQuery.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Saved Searches
+  **   Seekers' standing queries (see JobQuery), each matched against every job posted after it's saved, the jobs matching queued
+  **   as alerts for its seeker to collect.  Matching every saved query against every new job would cost a pass over all of them
+  **   per job, so the queries themselves are indexed instead (a percolator, a search index turned around):  each is filed under
+  **   a few anchors, trigrams of its criteria by field, such that every job it matches has one of them in that field.  A new job
+  **   looks up its own fields' trigrams to find the few queries it could match, and only those are evaluated.
+  **
+  **   A criterion is anchored by the trigram of its value found in the fewest jobs, an AND by its most selective operand's
+  **   anchors, an OR by every operand's.  What can't be anchored (a NOT, a criterion with typos, a salary range, a distance or a
+  **   value shorter than a trigram) is left to its siblings under an AND, and failing that the query is evaluated against every
+  **   new job.
+  ******************************************************************************/
+  class SavedSearches
+  {
+    public:
+      static constexpr std::size_t MostAlerts = 1000;    // queued per user, the oldest dropped beyond them
+
+      // How many jobs are likely to contain criterion (normalized) in field, for choosing the rarest anchors
+      using Rarity = std::function<std::size_t( JobField field, const std::string & criterion )>;
+
+
+      // Operations
+      std::size_t              save     ( const std::string & userName, JobQuery query, const std::string & text, const Rarity & rarity );    // returns its id
+      bool                     forget   ( const std::string & userName, std::size_t id );    // false if the user saved no such search
+      std::vector<SavedSearch> byUser   ( const std::string & userName ) const;              // in the order saved
+
+      void                     percolate( const JobInfo & job );                             // queues an alert for each user with a search job matches
+      std::vector<JobAlert>    take     ( const std::string & userName );                    // the user's alerts, oldest first, emptying the queue
+
+    private:
+      static constexpr std::size_t Fields = 7;    // every JobField, queries may name any of them
+
+      using Anchor = std::uint32_t;    // field in the top byte, a trigram of its normalized text in the low three
+
+      struct Anchors
+      {
+        std::vector<Anchor> anchors;
+        std::size_t         jobs;      // likely to have one of them, summed
+      };
+
+      struct Search
+      {
+        std::string         userName;
+        std::string         text;      // as saved
+        JobQuery            query;
+        std::vector<Anchor> anchors;   // none means it's evaluated against every job
+      };
+
+      // The anchors every job matching node has one of, none if node can't be anchored
+      static std::optional<Anchors> anchor( const JobQuery::Node & node, const Rarity & rarity );
+
+      std::vector<std::optional<Search>>                         _searches;               // by id, none once forgotten
+      std::unordered_map<Anchor, std::vector<std::size_t>>       _filed;                  // ids by anchor, ascending
+      std::vector<std::size_t>                                   _unanchored;             // ids, ascending
+      std::array<std::size_t, Fields>                            _anchoredFields = {};    // anchors filed per field, only those filed are looked up
+      std::unordered_map<std::string, std::vector<std::size_t>>  _byUser;                 // ids, ascending
+      std::unordered_map<std::string, std::deque<JobAlert>>      _alerts;                 // by user, oldest first
+  };    // class SavedSearches
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>    // set_intersection(), set_union(), sort(), unique()
+#include <cstdint>      // uint32_t
+#include <iterator>     // back_inserter()
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+namespace TechnicalServices::Persistence
+{
+  class SnapshotReader;
+  class SnapshotWriter;
+
+
+  // Row position of a job within SimpleDB's job table.  Rows are assigned in insertion order and never reused, so posting lists
+  // built by appending rows as jobs are inserted are always sorted ascending.
+  using RowId       = std::uint32_t;
+  using PostingList = std::vector<RowId>;        // ascending, no duplicates
+  using PostingView = std::span<const RowId>;    // a posting list read where it lies, in an index or a mapped snapshot image (see MappedArray)
+
+
+  // The job fields, the searchable ones first and in the same order as the searchByCriteria() arguments.  Only the searchable
+  // fields are indexed, queries (see JobQuery) may name any of them.
+  enum class JobField { Name, Location, Category, Type, Description, Qualification, Salary };
+  constexpr std::size_t JobFieldCount = 3;    // searchable fields
+
+  inline const std::string & fieldValue( const JobInfo & job, JobField field )
+  {
+    switch( field )
+    {
+      case JobField::Name:          return job.name;
+      case JobField::Location:      return job.location;
+      case JobField::Category:      return job.category;
+      case JobField::Type:          return job.type;
+      case JobField::Description:   return job.description;
+      case JobField::Qualification: return job.qualification;
+      case JobField::Salary:        return job.salary;
+      default:                      return job.name;     // unreachable, silences -Wswitch-default
+    }
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Posting list algebra
+  ******************************************************************************/
+  inline PostingList intersect( PostingView lhs, PostingView rhs )
+  {
+    PostingList result;
+    result.reserve( std::min( lhs.size(), rhs.size() ) );
+    std::set_intersection( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter( result ) );
+    return result;
+  }
+
+
+  inline PostingList unite( PostingView lhs, PostingView rhs )
+  {
+    PostingList result;
+    result.reserve( lhs.size() + rhs.size() );
+    std::set_union( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter( result ) );
+    return result;
+  }
+
+
+  // Union of many lists at once, cheaper than folding unite() when a criterion matches a large part of the vocabulary
+  inline PostingList uniteAll( const std::vector<PostingView> & lists )
+  {
+    if( lists.size() == 1 ) return PostingList( lists.front().begin(), lists.front().end() );
+
+    PostingList result;
+    for( auto list : lists ) result.insert( result.end(), list.begin(), list.end() );
+    std::sort( result.begin(), result.end() );
+    result.erase( std::unique( result.begin(), result.end() ), result.end() );
+    return result;
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Search Index
+  **   Abstract class for the job indexes behind searchByCriteria().  An index narrows a substring criterion to a candidate superset
+  **   of rows that must still be verified with std::string::find(), so every realization returns the same results as a full scan.
+  ******************************************************************************/
+  class SearchIndex
+  {
+    public:
+      // Operations
+      virtual void insert( RowId row, const JobInfo & job ) = 0;                                   // rows must be inserted in ascending order
+
+      // Returns the candidate rows for the criterion, or nothing if the index can't narrow the search for this criterion
+      virtual std::optional<PostingList> candidates( JobField field, const std::string & criterion ) const = 0;
+
+      // Returns at least as many rows as candidates() would, ideally without finding them, or nothing if it couldn't narrow them.
+      // Query planning orders lookups by it.
+      virtual std::optional<std::size_t> estimate  ( JobField field, const std::string & criterion ) const = 0;
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      virtual void save( SnapshotWriter & image ) const = 0;
+      virtual void load( SnapshotReader & image )       = 0;
+
+
+      // Destructor
+      // Pure virtual destructor helps force the class to be abstract, but must still be implemented
+      virtual ~SearchIndex() noexcept = 0;
+
+    protected:
+      // Copy assignment operators, protected to prevent mix derived-type assignments
+      SearchIndex & operator=( const SearchIndex &  rhs ) = default;  // copy assignment
+      SearchIndex & operator=(       SearchIndex && rhs ) = default;  // move assignment
+  };    // class SearchIndex
+
+
+
+
+  /*****************************************************************************
+  ** Inline implementations
+  ******************************************************************************/
+  inline SearchIndex::~SearchIndex() noexcept = default;
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,30 @@
+#include "TechnicalServices/Persistence/ShardedDB.hpp"
+
+#include <algorithm>    // max()
+#include <cstddef>      // size_t
+#include <functional>   // function
+#include <thread>       // hardware_concurrency()
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  ShardedDB::ShardedDB() : ShardedDB( std::thread::hardware_concurrency() )
+  {}
+
+
+
+
+  // The calling thread searches a shard too, so the pool needs one thread fewer than there are shards
+  ShardedDB::ShardedDB( std::size_t shards ) : SimpleDB( std::max<std::size_t>( 1, shards ) ), _shards( std::max<std::size_t>( 1, shards ) ), _pool( _shards - 1 )
+  {}
+
+
+
+
+  void ShardedDB::scatter( const std::function<void( std::size_t partition )> & work ) const
+  {
+    _pool.run( _shards, work );
+  }
+}    // namespace TechnicalServices::Persistence
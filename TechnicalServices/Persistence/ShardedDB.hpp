@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>      // size_t
+#include <functional>   // function
+
+#include "TechnicalServices/Persistence/SimpleDB.hpp"
+#include "TechnicalServices/Persistence/ThreadPool.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Sharded DB
+  **   SimpleDB with the job catalog split into one partition (shard) per processor core, each with its own table and indexes.
+  **   A search is scattered across the shards on a thread pool, each searching its own share of the jobs, and the results are
+  **   gathered back into catalog order, or relevance order for ranked searches.  So one search uses every core rather than one.
+  **   Chosen over SimpleDB by Component.Database in the adaptation data (see PersistenceHandler::instance()).
+  ******************************************************************************/
+  class ShardedDB : public SimpleDB
+  {
+    public:
+      ShardedDB();                                    // one shard per core
+      explicit ShardedDB( std::size_t shards );       // at least one
+
+    protected:
+      void scatter( const std::function<void( std::size_t partition )> & work ) const override;
+
+    private:
+      std::size_t        _shards;
+      mutable ThreadPool _pool;
+  };    // class ShardedDB
+}    // namespace TechnicalServices::Persistence
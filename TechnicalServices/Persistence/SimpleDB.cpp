@@ -1,14 +1,46 @@
 #include "TechnicalServices/Persistence/SimpleDB.hpp"
 
+#include <algorithm>  // merge(), min_element(), move(), sort(), unique()
+#include <chrono>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+#include <exception>
+#include <filesystem> // file_size(), last_write_time()
 #include <fstream>    // streamsize
+#include <functional> // function
+#include <initializer_list>
 #include <iomanip>    // quoted()
+#include <iterator>   // back_inserter(), make_move_iterator()
 #include <limits>     // numeric_limits
+#include <map>
 #include <memory>     // make_unique()
+#include <optional>
+#include <mutex>      // unique_lock
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>  // out_of_range
 #include <string>
+#include <system_error>    // error_code
+#include <thread>     // jthread
+#include <utility>    // move()
 #include <vector>
 
 #include "TechnicalServices/Logging/SimpleLogger.hpp"
+#include "TechnicalServices/Persistence/ApplicationLog.hpp"
+#include "TechnicalServices/Persistence/Autocompleter.hpp"
+#include "TechnicalServices/Persistence/BulkImporter.hpp"
+#include "TechnicalServices/Persistence/InvertedIndex.hpp"
+#include "TechnicalServices/Persistence/JobPartition.hpp"
+#include "TechnicalServices/Persistence/JobQuery.hpp"
+#include "TechnicalServices/Persistence/Normalization.hpp"
 #include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/QueryCache.hpp"
+#include "TechnicalServices/Persistence/RelevanceIndex.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+#include "TechnicalServices/Persistence/SubstringScanner.hpp"
+#include "TechnicalServices/Persistence/TrigramIndex.hpp"
+#include "TechnicalServices/Persistence/Versioned.hpp"
 
 
 
@@ -37,6 +69,92 @@ namespace
 
 namespace TechnicalServices::Persistence
 {
+  namespace
+  {
+    // The built-in sample data, used for each catalog the adaptation data doesn't name
+    std::vector<UserCredentials> sampleUsers()
+    {
+      return
+      {
+          // Username    Pass Phrase         Authorized roles
+            {"Tom",     "CPSC 462 Rocks!",  {"Borrower",     "Management"}},
+            {"abcde11", "abcde11",   {"Borrower"                  }},
+            {"admin",  "admin",                 {"Administrator"             }},
+            {"Hyejin",  "12345",            {"JobSeeker"             }},
+            {"abc",  "abc",                 {"JobSeeker"             }},
+            {"abcd",  "abcd",                 {"JobSeekerTroubleshoot"             }}
+      };
+    }
+
+
+    std::vector<JobInfo> sampleJobs()
+    {
+      return
+      {
+          // id, name, location, category, type, description, qualification, salary
+            {1, "Burger King", "Fullerton", "Server", "Part time", "Descrption about server at Burger King", "over 19", "15$ / hour"},
+            {2, "Starbucks", "Fullerton", "Barista", "Full time", "Descrption about barista at Starbucks", "over 21", "19$ / hour"},
+            {3, "Health Kitchen", "Las Vegas", "Chef", "Full time", "Descrption about chef at Health Kitchen", "over 25", "50$ / hour"},
+      };
+    }
+
+
+    std::vector<Application> sampleApplications()
+    {
+      return
+      {
+          // userName, jobId, state
+            {"Hyejin", 1, "reviewed"}
+      };
+    }
+
+
+    std::vector<Place> samplePlaces()
+    {
+      return
+      {
+          // name, latitude, longitude
+            {"Fullerton",   33.8704, -117.9242},
+            {"Anaheim",     33.8366, -117.9143},
+            {"Brea",        33.9167, -117.9001},
+            {"Placentia",   33.8722, -117.8703},
+            {"Buena Park",  33.8675, -117.9981},
+            {"Orange",      33.7879, -117.8531},
+            {"Santa Ana",   33.7455, -117.8677},
+            {"Irvine",      33.6846, -117.8265},
+            {"Long Beach",  33.7701, -118.1937},
+            {"Los Angeles", 34.0522, -118.2437},
+            {"Las Vegas",   36.1699, -115.1398}
+      };
+    }
+
+
+    // The built-in sample data for the catalog key names, as text, so a snapshot image built from it goes stale when it changes
+    std::string sampleData( const std::string & key )
+    {
+      std::string text;
+      if( key == "Persistence.UserCatalog" )
+        for( const auto & user : sampleUsers() )
+        {
+          text += user.userName + '\0' + user.passPhrase;
+          for( const auto & role : user.roles ) text += '\0' + role;
+          text += '\n';
+        }
+      else if( key == "Persistence.JobCatalog" )
+        for( const auto & job : sampleJobs() )
+          text += std::to_string( job.id ) + '\0' + job.name + '\0' + job.location + '\0' + job.category + '\0' + job.type + '\0' + job.description + '\0'
+                + job.qualification + '\0' + job.salary + '\n';
+      else if( key == "Persistence.ApplicationCatalog" )
+        for( const auto & application : sampleApplications() ) text += application.userName + '\0' + std::to_string( application.jobId ) + '\0' + application.status + '\n';
+      else if( key == "Persistence.Gazetteer" )
+        for( const auto & place : samplePlaces() ) text += place.name + '\0' + std::to_string( place.latitude ) + '\0' + std::to_string( place.longitude ) + '\n';
+      return text;
+    }
+  }    // namespace
+
+
+
+
   // Design decision/Programming note:
   //  - The persistence database contains adaptation data, and one of the adaptable items is which Logger component to use
   //  - The factory function TechnicalServices::Logging::create(std::ostream &) depends of the persistence database to obtain
@@ -44,60 +162,438 @@ namespace TechnicalServices::Persistence
   //  - However, the Persistence database implementations, like this one, should (must?) be able to log messages
   //  - Therefore, to maintain the design decision to allow Logging to depend on Persistence, but not Persistence to depend on
   //    Logging, we mustn't create this logger through the LoggingHandler interface, but rather select and create a specific Logger
-  SimpleDB::SimpleDB() : _loggerPtr( std::make_unique<TechnicalServices::Logging::SimpleLogger>() )
+  SimpleDB::SimpleDB() : SimpleDB( 1 )
+  {}
+
+
+
+
+  SimpleDB::SimpleDB( std::size_t jobPartitions ) : _loggerPtr( std::make_unique<TechnicalServices::Logging::SimpleLogger>() )
   {
     _logger << "Simple DB being used and has been successfully initialized";
 
 
     // Let's look for an adaptation data file, and if found load the contents.  Otherwise create some default values.
+    if( auto adaptationData = readAdaptationData() ) _adaptablePairs = std::move( *adaptationData );
+
+    else
+    {
+      _adaptablePairs = { /* KEY */               /* Value*/
+                          {"Component.Logger",      "Simple Logger"},
+                          {"Component.SearchIndex", "Trigram Index"},
+                          {"Component.UI",          "Simple UI"}
+//                        {"Component.UI",          "Contracted UI"}
+                        };
+    }
+
+    // Select the job search index.  Older adaptation data files predate the choice, so default to the trigram index
+    _adaptablePairs.try_emplace( "Component.SearchIndex", "Trigram Index" );
+    loadGazetteer();
+    _jobPartitions.reserve( jobPartitions );
+    for( std::size_t partition = 0; partition != jobPartitions; ++partition ) _jobPartitions.emplace_back( makeSearchIndex(), _gazetteer );
+
+    // Near duplicate postings are flagged unless asked to collapse them, ahead of loading so the catalogs are collapsed too
+    if( auto policy = adaptableItem( "Persistence.NearDuplicates" ); policy != nullptr && *policy != "Flag" )
+    {
+      if( *policy != "Collapse" )
+      {
+        std::string message = __func__;
+        message += " unknown near duplicate policy \"" + *policy + "\" requested";
+
+        _logger << message;
+        throw PersistenceException( message );
+      }
+      _collapseDuplicates = true;
+    }
+
+
+    // Start from the snapshot image if there's a current one, otherwise load the catalogs and save an image for the next start
+    if( auto snapshot = adaptableItem( "Persistence.Snapshot" ); snapshot == nullptr ) loadCatalogs();
+    else if( !restoreSnapshot( *snapshot ) )
+    {
+      loadCatalogs();
+      saveSnapshot( *snapshot );
+    }
+    std::size_t bytes = 0;
+    for( const auto & jobs : _jobPartitions ) bytes += jobs.bytes();
+    _logger << "Job table holds " + std::to_string( jobCount() ) + " jobs in " + std::to_string( bytes >> 20 ) + " MiB across " + std::to_string( _jobPartitions.size() )
+               + " partition(s), unindexed scans use the " + SubstringScanner::name( SubstringScanner::fastest() ) + " kernel";
+
+    // Applications made or changed since are kept in the application log, after the image so the image never holds them twice
+    if( auto log = adaptableItem( "Persistence.ApplicationLog" ); log != nullptr ) openApplicationLog( *log );
+
+    auto cacheCapacity = adaptableCount( "Persistence.QueryCacheCapacity", 16 );    // MiB
+    _queryCache = std::make_unique<QueryCache>( cacheCapacity << 20 );
+  }
+
+
+
+
+  std::optional<SimpleDB::AdaptationData> SimpleDB::readAdaptationData()
+  {
     std::ifstream adaptationDataFile( "Library_System_AdaptableData.dat", std::ios::binary );
+    if( !adaptationDataFile.is_open() ) return std::nullopt;
 
-    if( adaptationDataFile.is_open() )
+    // Expected format:  key = value
+    // Notes:
+    //   1) if key or value contain whitespace, they must be enclosed in double quotes
+    //   2) if the same Key appears more than once, last one wins
+    //   3) everything after the value is ignored, allowing that space to be used as comments
+    //   4) A Key of "//" is ignored, allowing the file to contain comment lines of the form // = ...
+    AdaptationData pairs;
+    std::string    key, value;
+    while( adaptationDataFile >> std::quoted( key ) >> ignore( '=' ) >> std::quoted( value ) >> ignore( '\n' ) )   pairs[key] = value;
+    pairs.erase( "//" );
+    return pairs;
+  }
+
+
+
+
+  const std::string * SimpleDB::adaptableItem( const std::string & key ) const
+  {
+    auto pair = _adaptablePairs.find( key );
+    return pair == _adaptablePairs.cend() || pair->second.empty() ? nullptr : &pair->second;
+  }
+
+
+
+
+  std::size_t SimpleDB::adaptableCount( const std::string & key, std::size_t otherwise ) const
+  {
+    auto value = adaptableItem( key );
+    if( value == nullptr ) return otherwise;
+
+    // stoul() would take a sign or stop at trailing junk, so only digits are a count
+    try
     {
-      // Expected format:  key = value
-      // Notes:
-      //   1) if key or value contain whitespace, they must be enclosed in double quotes
-      //   2) if the same Key appears more than once, last one wins
-      //   3) everything after the value is ignored, allowing that space to be used as comments
-      //   4) A Key of "//" is ignored, allowing the file to contain comment lines of the form // = ...
-      std::string key, value;
-      while( adaptationDataFile >> std::quoted( key ) >> ignore( '=' ) >> std::quoted( value ) >> ignore( '\n' ) )   _adaptablePairs[key] = value;
-      _adaptablePairs.erase( "//" );
+      if( value->find_first_not_of( "0123456789" ) == std::string::npos ) return std::stoul( *value );
     }
+    catch( const std::out_of_range & ) {}
 
-    else
+    std::string message = __func__;
+    message += " adaptation data \"" + key + "\" = \"" + *value + "\" is not a count";
+
+    _logger << message;
+    throw PersistenceException( message );
+  }
+
+
+
+
+  // Jobs are placed as they're indexed, so the gazetteer is loaded ahead of them, from the file named in the adaptation data or
+  // else the built-in sample places
+  void SimpleDB::loadGazetteer()
+  {
+    std::vector<Place> places;
+    if( auto path = adaptableItem( "Persistence.Gazetteer" ) )
     {
-      _adaptablePairs = { /* KEY */               /* Value*/
-                          {"Component.Logger",    "Simple Logger"},
-                          {"Component.UI",        "Simple UI"}
-//                        {"Component.UI",        "Contracted UI"}
-                        };
+      BulkImporter importer;
+      try
+      {
+        places = importer.importPlaces( *path );
+        _logger << BulkImporter::summary( *path, importer.statistics() );
+      }
+      catch( const PersistenceException & error )
+      {
+        _logger << std::string( "Gazetteer not loaded, locations have no coordinates: " ) + error.what();
+      }
     }
+    else places = samplePlaces();
+
+    for( const auto & place : places ) _gazetteer.insert( place );
+  }
+
+
+
 
-    _storedUsers =
+  // Loads the catalogs named in the adaptation data, or the built-in sample data for those that aren't named
+  void SimpleDB::loadCatalogs()
+  {
+    BulkImporter importer;
+    auto report = [&]( const std::string & path ) { _logger << BulkImporter::summary( path, importer.statistics() ); };
+
+
+    if( auto path = adaptableItem( "Persistence.UserCatalog" ) ) { loadUsers( importer.importUsers( *path ) ); report( *path ); }
+    else loadUsers( sampleUsers() );
+
+    if( auto path = adaptableItem( "Persistence.JobCatalog" ) ) { loadJobs( importer.importJobs( *path ) ); report( *path ); }
+    else loadJobs( sampleJobs() );
+
+    if( auto path = adaptableItem( "Persistence.ApplicationCatalog" ) ) { loadApplications( importer.importApplications( *path ) ); report( *path ); }
+    else loadApplications( sampleApplications() );
+  }
+
+
+
+
+  // Identifies the catalogs a snapshot image was built from, so an image is discarded as stale if a catalog changes
+  std::uint64_t SimpleDB::catalogFingerprint() const
+  {
+    std::string description = "Search index: " + _adaptablePairs.at( "Component.SearchIndex" ) + " in " + std::to_string( _jobPartitions.size() ) + " partitions";
+    description += _collapseDuplicates ? ", near duplicates collapsed" : ", near duplicates flagged";
+
+    for( const auto * key : { "Persistence.UserCatalog", "Persistence.JobCatalog", "Persistence.ApplicationCatalog", "Persistence.Gazetteer" } )
     {
-        // Username    Pass Phrase         Authorized roles
-          {"Tom",     "CPSC 462 Rocks!",  {"Borrower",     "Management"}},
-          {"abcde11", "abcde11",   {"Borrower"                  }},
-          {"admin",  "admin",                 {"Administrator"             }},
-          {"Hyejin",  "12345",            {"JobSeeker"             }},
-          {"abc",  "abc",                 {"JobSeeker"             }},
-          {"abcd",  "abcd",                 {"JobSeekerTroubleshoot"             }}
-    };
+      description += '\n';
+      description += key;
+
+      auto path = adaptableItem( key );
+      if( path == nullptr ) { description += " built-in\n" + sampleData( key ); continue; }
+
+      std::error_code error;    // a missing catalog simply yields a fingerprint no image will match
+      auto size     = std::filesystem::file_size      ( *path, error );
+      auto modified = std::filesystem::last_write_time( *path, error );
+      description += " " + *path + " " + std::to_string( size ) + " " + std::to_string( modified.time_since_epoch().count() );
+    }
+
+    SnapshotChecksum fingerprint;
+    fingerprint.update( description.data(), description.size() );
+    return fingerprint.value();
+  }
 
-    _storedJobs = 
+
+
+
+  bool SimpleDB::restoreSnapshot( const std::string & path )
+  {
+    try
     {
-        // id, name, location, category, type, description, qualification, salary
-          {1, "Burger King", "Fullerton", "Server", "Part time", "Descrption about server at Burger King", "over 19", "15$ / hour"},
-          {2, "Starbucks", "Fullerton", "Barista", "Full time", "Descrption about barista at Starbucks", "over 21", "19$ / hour"},
-          {3, "Health Kitchen", "Las Vegas", "Chef", "Full time", "Descrption about chef at Health Kitchen", "over 25", "50$ / hour"},
-    };
+      auto           start = std::chrono::steady_clock::now();
+      SnapshotReader image( path, catalogFingerprint() );
+
+      // Restore into temporaries, in the order saveSnapshot() wrote them, so a bad image leaves nothing half loaded
+      Users users;
+      for( auto count = image.readInteger(); count != 0; --count )
+      {
+        UserCredentials user;
+        user.userName   = image.readString();
+        user.passPhrase = image.readString();
+        for( auto roles = image.readInteger(); roles != 0; --roles ) user.roles.push_back( image.readString() );
+        users.insert_or_assign( user.userName, std::move( user ) );
+      }
+
+      ApplicationStore applications;
+      for( auto count = image.readInteger(); count != 0; --count )
+      {
+        Application application;
+        application.userName = image.readString();
+        application.jobId    = static_cast<int>( image.readInteger() );
+        application.status   = image.readString();
+        applications.insert( std::move( application ) );
+      }
+
+      if( image.readInteger() != _jobPartitions.size() ) throw PersistenceException( "Corrupt snapshot image, wrong number of job partitions" );
+      std::vector<JobPartition> jobPartitions;
+      for( std::size_t partition = 0; partition != _jobPartitions.size(); ++partition ) jobPartitions.emplace_back( makeSearchIndex(), _gazetteer ).load( image );
+
+      Autocompleter autocompleter;
+      autocompleter.load( image );
+
+      DuplicateIndex duplicates;
+      duplicates.load( image );
+      std::size_t positions = 0;
+      for( const auto & jobs : jobPartitions ) positions += jobs.size();
+      if( duplicates.size() != positions ) throw PersistenceException( "Corrupt snapshot image, duplicate index doesn't match the job partitions" );
+
+      if( !image.exhausted() ) throw PersistenceException( "Corrupt snapshot image, unexpected trailing data" );
 
-    _storedApplications =
+
+      // Everything checked out, so adopt it
+      _storedUsers       .update( [&]( Users &            stored ) { stored = std::move( users        ); return true; } );
+      _storedApplications.update( [&]( ApplicationStore & stored ) { stored = std::move( applications ); return true; } );
+      _jobPartitions = std::move( jobPartitions );
+      _autocompleter = std::move( autocompleter );
+      _duplicates    = std::move( duplicates    );
+      indexJobIds();
+
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+      _logger << "Restored " + std::to_string( jobCount() ) + " jobs from snapshot image \"" + path + "\" in " + std::to_string( elapsed.count() ) + " ms";
+      return true;
+    }
+    catch( const PersistenceException & error )
     {
-        // userName, jobId, state
-          {"Hyejin", 1, "reviewed"}
-    };
+      _logger << std::string( "Snapshot image not used, loading catalogs instead: " ) + error.what();
+      return false;
+    }
+  }
+
+
+
+
+  void SimpleDB::saveSnapshot( const std::string & path ) const
+  {
+    try
+    {
+      SnapshotWriter image( path, catalogFingerprint() );
+
+      {
+        auto users = _storedUsers.read();
+        image.write( std::uint64_t{ users->size() } );
+        for( const auto & [name, user] : *users )
+        {
+          image.write( user.userName   );
+          image.write( user.passPhrase );
+          image.write( std::uint64_t{ user.roles.size() } );
+          for( const auto & role : user.roles ) image.write( role );
+        }
+      }
+
+      {
+        auto applications = _storedApplications.read()->all();
+        image.write( std::uint64_t{ applications.size() } );
+        for( const auto & application : applications )
+        {
+          image.write( application.userName );
+          image.write( static_cast<std::uint64_t>( application.jobId ) );
+          image.write( application.status );
+        }
+      }
+
+      image.write( std::uint64_t{ _jobPartitions.size() } );
+      for( const auto & jobs : _jobPartitions ) jobs.save( image );
+      _autocompleter.save( image );
+      _duplicates   .save( image );
+
+      image.commit();
+      _logger << "Saved snapshot image \"" + path + '"';
+    }
+    catch( const std::exception & error )    // includes filesystem errors, the image is an optimization so carry on without it
+    {
+      _logger << std::string( "Unable to save snapshot image: " ) + error.what();
+    }
+  }
+
+
+
+
+  void SimpleDB::openApplicationLog( const std::string & path )
+  {
+    static const std::map<std::string, ApplicationLog::Durability> policies = { {"Every Write",  ApplicationLog::Durability::EveryWrite },
+                                                                                {"Group Commit", ApplicationLog::Durability::GroupCommit},
+                                                                                {"Deferred",     ApplicationLog::Durability::Deferred   } };
+
+    auto durability = ApplicationLog::Durability::GroupCommit;
+    if( auto requested = adaptableItem( "Persistence.ApplicationLogSync" ); requested != nullptr )
+    {
+      auto policy = policies.find( *requested );
+      if( policy == policies.cend() )
+      {
+        std::string message = __func__;
+        message += " unknown application log sync policy \"" + *requested + "\" requested";
+
+        _logger << message;
+        throw PersistenceException( message );
+      }
+      durability = policy->second;
+    }
+
+    std::chrono::milliseconds flushInterval( adaptableCount( "Persistence.ApplicationLogFlushInterval", 100 ) );
+
+
+    // Replay what was logged before the last shutdown, on top of whatever the catalogs or snapshot image provided
+    std::size_t replayed = 0;
+    _storedApplications.update( [&]( ApplicationStore & applications )
+    {
+      for( auto & record : ApplicationLog::recover( path ) )
+      {
+        if( record.kind == ApplicationLog::Record::Kind::Apply ) applications.insert( std::move( record.application ) );
+        else applications.updateStatus( record.application.userName, record.application.jobId, record.application.status );
+        ++replayed;
+      }
+      return true;
+    } );
+
+    _applicationLog = std::make_unique<ApplicationLog>( path, durability, flushInterval );
+    _logger << "Replayed " + std::to_string( replayed ) + " changes from application log \"" + path + '"';
+  }
+
+
+
+
+  std::unique_ptr<SearchIndex> SimpleDB::makeSearchIndex() const
+  {
+    const auto & requestedIndex = _adaptablePairs.at( "Component.SearchIndex" );
+
+    if( requestedIndex == "Trigram Index" ) return std::make_unique<TrigramIndex> ();
+    if( requestedIndex == "Token Index"   ) return std::make_unique<InvertedIndex>();
+    if( requestedIndex == "Full Scan"     ) return nullptr;
+
+    std::string message = __func__;
+    message += " unknown search index \"" + requestedIndex + "\" requested";
+
+    _logger << message;
+    throw PersistenceException( message );
+  }
+
+
+
+
+  void SimpleDB::loadUsers( std::vector<UserCredentials> users )
+  {
+    _storedUsers.update( [&]( Users & stored )
+    {
+      stored.reserve( stored.size() + users.size() );
+      for( auto & user : users ) stored.insert_or_assign( user.userName, std::move( user ) );
+      return true;
+    } );
+  }
+
+
+
+
+  void SimpleDB::loadJobs( std::vector<JobInfo> jobs )
+  {
+    // Each partition takes the next contiguous range of the jobs, and builds its table and indexes alongside the others, the
+    // autocompleter and the duplicate index
+    auto first      = jobCount();
+    auto partitions = _jobPartitions.size();
+    std::vector<std::size_t> rows;    // each partition held before
+    for( const auto & partition : _jobPartitions ) rows.push_back( partition.size() );
+    {
+      std::vector<std::jthread> builders;
+      builders.emplace_back( [&] { _autocompleter.insert( jobs ); } );
+      builders.emplace_back( [&] { _duplicates.append( jobs, first ); } );
+      for( std::size_t partition = 0; partition != partitions; ++partition ) builders.emplace_back( [&, partition]
+      {
+        auto begin = jobs.size() * partition / partitions;
+        auto end   = jobs.size() * ( partition + 1 ) / partitions;
+        _jobPartitions[partition].append( std::span( jobs ).subspan( begin, end - begin ), first + begin );
+      } );
+    }
+
+    // Copies found among the new jobs are removed if collapsing, leaving the earliest posting of each
+    std::size_t copies = 0;
+    for( std::size_t partition = 0; partition != partitions; ++partition )
+    {
+      auto & loaded = _jobPartitions[partition];
+      for( auto row = static_cast<RowId>( rows[partition] ); row != loaded.size(); ++row )
+      {
+        if( !_duplicates.original( loaded.position( row ) ) ) continue;
+
+        ++copies;
+        if( !_collapseDuplicates ) continue;
+        loaded.remove( row );
+        _autocompleter.erase( loaded.job( row ) );
+        _duplicates   .erase( loaded.position( row ) );
+      }
+    }
+    if( copies != 0 ) _logger << std::to_string( copies ) + " of " + std::to_string( jobs.size() ) + " jobs loaded nearly duplicate an earlier posting, "
+                                 + ( _collapseDuplicates ? "collapsed into it" : "flagged" );
+
+    indexJobIds();
+  }
+
+
+
+
+  void SimpleDB::loadApplications( std::vector<Application> applications )
+  {
+    _storedApplications.update( [&]( ApplicationStore & stored )
+    {
+      for( auto & application : applications ) stored.insert( std::move( application ) );
+      return true;
+    } );
   }
 
 
@@ -105,6 +601,10 @@ namespace TechnicalServices::Persistence
 
   SimpleDB::~SimpleDB() noexcept
   {
+    if( auto cache = _queryCache->statistics(); cache.hits + cache.misses != 0 )
+      _logger << "Query cache answered " + std::to_string( cache.hits ) + " of " + std::to_string( cache.hits + cache.misses ) + " searches ("
+                 + std::to_string( static_cast<int>( cache.hitRatio() * 100 ) ) + "% hit ratio), holding " + std::to_string( cache.entries )
+                 + " results in " + std::to_string( cache.bytes >> 10 ) + " KiB";
     _logger << "Simple DB shutdown successfully";
   }
 
@@ -117,36 +617,81 @@ namespace TechnicalServices::Persistence
   }
 
   
-  bool SimpleDB::makeApplication(const std::string& name, int jobId) {
-      std::vector<Application> results;
-      for (const auto& app : _storedApplications) {
-          if (app.userName == name && app.jobId == jobId) return false;
-      }
+  bool SimpleDB::makeApplication(const std::string& name, int jobId)
+  {
+    std::uint64_t logged  = 0;
+    bool          applied = _storedApplications.update( [&]( ApplicationStore & applications )
+    {
+      if( !applications.insert( { name, jobId, "applied" } ) ) return false;    // rejects duplicates
 
-      Application* newapp = new Application;
-      newapp->userName = name;
-      newapp->jobId = jobId;
-      newapp->status = "applied";
-      _storedApplications.push_back(*newapp);
+      // Logged while writers take turns so the log's order matches the versions'
+      if( _applicationLog ) logged = _applicationLog->append( ApplicationLog::Record::Kind::Apply, { name, jobId, "applied" } );
       return true;
+    } );
+    if( !applied ) return false;
+
+    // Waiting after publishing lets concurrent applicants share a sync
+    if( _applicationLog ) commitApplication( logged, "application of " + name + " for job " + std::to_string( jobId ) );
+    return true;
   }
-  
-  
+
+
+  bool SimpleDB::updateApplicationStatus( const std::string & name, int jobId, const std::string & status )
+  {
+    std::uint64_t logged  = 0;
+    bool          updated = _storedApplications.update( [&]( ApplicationStore & applications )
+    {
+      if( !applications.updateStatus( name, jobId, status ) ) return false;
+
+      if( _applicationLog ) logged = _applicationLog->append( ApplicationLog::Record::Kind::StatusChange, { name, jobId, status } );
+      return true;
+    } );
+    if( !updated ) return false;
+
+    if( _applicationLog ) commitApplication( logged, "status change of " + name + "'s application for job " + std::to_string( jobId ) + " to " + status );
+    return true;
+  }
+
+
+  // An application is published before it's durable, so readers may already have seen it by the time the log fails to take it.
+  // It stands until shutdown rather than being thrown past, the failure is reported here, and the failed log refuses every later
+  // change before it's made (see ApplicationLog::append()).
+  void SimpleDB::commitApplication( std::uint64_t logged, const std::string & change )
+  {
+    try
+    {
+      _applicationLog->commit( logged );
+    }
+    catch( const PersistenceException & error )
+    {
+      std::string message = __func__;
+      message += " " + change + " was made but may not survive a restart, the application log failed:  " + error.what();
+
+      _logger << message;
+    }
+  }
+
+
   std::vector<Application> SimpleDB::getUserApplication(const std::string& name)
   {
-      std::vector<Application> results;
-      for (const auto& app : _storedApplications) {
-          if (app.userName == name) results.push_back(app);
-      }
-      return results;
+    return _storedApplications.read()->byUser( name );
+  }
+
+
+  std::vector<Application> SimpleDB::getJobApplicants( int jobId, const std::string & status, std::size_t offset, std::size_t pageSize )
+  {
+    return _storedApplications.read()->byJob( jobId, status == "0" ? "" : status, offset, pageSize );
   }
 
 
   UserCredentials SimpleDB::findCredentialsByName( const std::string & name )
   {
-      static std::vector<UserCredentials> storedUsers = _storedUsers;
+    {
+      auto users = _storedUsers.read();    // logins only read, so any number may proceed at once
 
-    for( const auto & user : storedUsers ) if( user.userName == name ) return user;
+      auto user = users->find( name );
+      if( user != users->cend() ) return user->second;
+    }
 
     // Name not found, log the error and throw something
     std::string message = __func__;
@@ -157,23 +702,424 @@ namespace TechnicalServices::Persistence
   }
   
   
+  void SimpleDB::scatter( const std::function<void( std::size_t partition )> & work ) const
+  {
+    for( std::size_t partition = 0; partition != _jobPartitions.size(); ++partition ) work( partition );
+  }
+
+
+
+
+  std::size_t SimpleDB::jobCount() const
+  {
+    std::size_t jobs = 0;
+    for( const auto & partition : _jobPartitions ) jobs += partition.size();
+    return jobs;
+  }
+
+
+
+
+  std::optional<JobInfo> SimpleDB::jobAt( RowId position ) const
+  {
+    for( const auto & jobs : _jobPartitions )
+      if( auto row = jobs.row( position ); row && !jobs.removed( *row ) ) return jobs.job( *row );
+    return std::nullopt;
+  }
+
+
+
+
+  SimpleDB::Found SimpleDB::find( const std::vector<std::string> & args, std::size_t from, std::size_t limit ) const
+  {
+    // Job changes invalidate what they affect while holding _jobsLock exclusively, so a result cached under the shared lock is current
+    if( auto cached = _queryCache->find( args, from, limit ) ) return std::move( *cached );
+
+    auto found = gather( [&]( const JobPartition & jobs ) { return jobs.search( jobs.plan( args ), from, limit ); }, limit );
+    _queryCache->insert( args, from, limit, found );
+    return found;
+  }
+
+
+
+
+  SimpleDB::Found SimpleDB::find( const JobQuery & query, std::size_t from, std::size_t limit ) const
+  {
+    if( auto cached = _queryCache->find( query, from, limit ) ) return std::move( *cached );
+
+    auto found = gather( [&]( const JobPartition & jobs ) { return jobs.search( query, from, limit ); }, limit );
+    _queryCache->insert( query, from, limit, found );
+    return found;
+  }
+
+
+
+
+  std::vector<JobInfo> SimpleDB::materialize( const Found & found ) const
+  {
+    // Each partition rebuilds its own rows, alongside the others
+    std::vector<std::vector<std::size_t>> places( _jobPartitions.size() );
+    for( std::size_t place = 0; place != found.size(); ++place ) places[found[place].partition].push_back( place );
+
+    std::vector<JobInfo> jobs( found.size() );
+    scatter( [&]( std::size_t partition ) { for( auto place : places[partition] ) jobs[place] = _jobPartitions[partition].job( found[place].row ); } );
+    return jobs;
+  }
+
+
+
+
+  SimpleDB::Found SimpleDB::gather( const std::function<std::vector<RowId>( const JobPartition & )> & search, std::size_t limit ) const
+  {
+    std::vector<Found> found( _jobPartitions.size() );
+    scatter( [&]( std::size_t partition )
+    {
+      const auto & jobs = _jobPartitions[partition];
+      for( auto row : search( jobs ) ) found[partition].push_back( { jobs.position( row ), static_cast<std::uint32_t>( partition ), row } );
+    } );
+
+    // Each partition's matches are already in catalog order, so merging them keeps the first limit of them all.  Only those are
+    // materialized, by the caller.
+    auto byPosition = []( const auto & lhs, const auto & rhs ) { return lhs.position < rhs.position; };
+
+    Found merged = std::move( found.front() );
+    for( auto partition = found.begin() + 1; partition != found.end(); ++partition )
+    {
+      Found both;
+      both.reserve( merged.size() + partition->size() );
+      std::merge( std::make_move_iterator( merged    .begin() ), std::make_move_iterator( merged    .end() ),
+                  std::make_move_iterator( partition->begin() ), std::make_move_iterator( partition->end() ), std::back_inserter( both ), byPosition );
+      merged = std::move( both );
+    }
+    if( merged.size() > limit ) merged.erase( merged.begin() + static_cast<std::ptrdiff_t>( limit ), merged.end() );
+
+    return merged;
+  }
+
+
+
+
   std::vector<JobInfo> SimpleDB::searchByCriteria(const std::vector<std::string>& args)
   {
-      static std::vector<JobInfo> storedJobs = _storedJobs;
-      std::vector<JobInfo> searchResults;
-
-      std::string keyword = args[0] == "0" ? "" : args[0];
-      std::string location = args[1] == "0" ? "" : args[1];
-      std::string category = args[2] == "0" ? "" : args[2];
-      
-      for (const auto& job : storedJobs) {
-          if (job.name.find(keyword) != std::string::npos) {
-              if (job.location.find(location) != std::string::npos && job.category.find(category) != std::string::npos) {
-                  searchResults.push_back(job);
-              }
-          }
-      }
-      return searchResults;
+    std::shared_lock lock( _jobsLock );
+    return materialize( find( args, 0, std::numeric_limits<std::size_t>::max() ) );
+  }
+
+
+  std::vector<JobInfo> SimpleDB::searchByQuery( const std::string & query )
+  {
+    JobQuery         parsed( query, &_gazetteer );
+    std::shared_lock lock( _jobsLock );
+    return materialize( find( parsed, 0, std::numeric_limits<std::size_t>::max() ) );
+  }
+
+
+  std::string SimpleDB::explainQuery( const std::string & query )
+  {
+    JobQuery         parsed( query, &_gazetteer );
+    std::shared_lock lock( _jobsLock );
+
+    // Each partition plans against its own indexes, so their plans can differ
+    std::string explanation = "Query " + JobQuery::describe( parsed.root() ) + '\n';
+    for( std::size_t partition = 0; partition != _jobPartitions.size(); ++partition )
+    {
+      const auto & jobs = _jobPartitions[partition];
+      std::string  steps;
+      auto         found = jobs.search( parsed, 0, std::numeric_limits<std::size_t>::max(), &steps );
+
+      explanation += "Partition " + std::to_string( partition + 1 ) + " of " + std::to_string( _jobPartitions.size() ) + ", "
+                     + std::to_string( jobs.size() ) + " rows, " + std::to_string( found.size() ) + " found\n" + steps;
+    }
+    return explanation;
+  }
+
+
+  std::vector<Suggestion> SimpleDB::suggest( std::size_t criterion, const std::string & prefix, std::size_t limit )
+  {
+    std::shared_lock lock( _jobsLock );
+    return _autocompleter.suggest( static_cast<JobField>( criterion ), prefix, limit );
+  }
+
+
+  JobInfo SimpleDB::findJob( int jobId )
+  {
+    std::shared_lock lock( _jobsLock );
+
+    auto located = _jobRows.find( jobId );
+    if( located == _jobRows.cend() )
+    {
+      std::string message = __func__;
+      message += " attempt to find job " + std::to_string( jobId ) + " failed, no such job";
+
+      _logger << message;
+      throw NoSuchJob( message );
+    }
+    return _jobPartitions[located->second.partition].job( located->second.row );
+  }
+
+
+  std::vector<JobInfo> SimpleDB::findDuplicates( int jobId )
+  {
+    std::shared_lock lock( _jobsLock );
+
+    auto located = _jobRows.find( jobId );
+    if( located == _jobRows.cend() )
+    {
+      std::string message = __func__;
+      message += " attempt to find duplicates of job " + std::to_string( jobId ) + " failed, no such job";
+
+      _logger << message;
+      throw NoSuchJob( message );
+    }
+
+    auto                 position = _jobPartitions[located->second.partition].position( located->second.row );
+    std::vector<JobInfo> duplicates;
+    for( auto member : _duplicates.group( position ) )
+      if( member != position )
+        if( auto job = jobAt( member ) ) duplicates.push_back( std::move( *job ) );
+    return duplicates;
+  }
+
+
+  std::size_t SimpleDB::saveSearch( const std::string & name, const std::string & query )
+  {
+    JobQuery         parsed( query, &_gazetteer );
+    std::shared_lock lock( _jobsLock );
+
+    // The jobs posted so far are the best guide to which anchors later ones will rarely have
+    auto rarity = [&]( JobField field, const std::string & criterion )
+    {
+      JobQuery::Node node;
+      node.field = field;
+      node.value = criterion;
+
+      std::size_t jobs = 0;
+      for( const auto & partition : _jobPartitions ) jobs += partition.estimate( node );
+      return jobs;
+    };
+
+    std::lock_guard saved( _savedSearchesLock );
+    return _savedSearches.save( name, std::move( parsed ), query, rarity );
+  }
+
+
+  std::vector<SavedSearch> SimpleDB::savedSearches( const std::string & name )
+  {
+    std::lock_guard lock( _savedSearchesLock );
+    return _savedSearches.byUser( name );
+  }
+
+
+  bool SimpleDB::forgetSearch( const std::string & name, std::size_t id )
+  {
+    std::lock_guard lock( _savedSearchesLock );
+    return _savedSearches.forget( name, id );
+  }
+
+
+  std::vector<JobAlert> SimpleDB::takeAlerts( const std::string & name )
+  {
+    std::lock_guard lock( _savedSearchesLock );
+    return _savedSearches.take( name );
+  }
+
+
+  std::vector<JobInfo> SimpleDB::searchTopK( const std::vector<std::string> & args, std::size_t k )
+  {
+    // The keywords are ranked rather than matched as a substring, location and category still filter as usual
+    auto keywords = args[static_cast<std::size_t>( JobField::Name )] == "0" ? std::string() : normalize( args[static_cast<std::size_t>( JobField::Name )] );
+    auto filter   = args;
+    filter[static_cast<std::size_t>( JobField::Name )] = "0";
+
+    // Nothing to rank by, so any k matches will do
+    if( RelevanceIndex::terms( keywords ).empty() ) return searchPage( { args }, k ).jobs;
+
+    std::shared_lock lock( _jobsLock );
+
+    // Every partition scores against the whole catalog's statistics, so the best k overall are among each partition's best k
+    RelevanceIndex::Statistics catalog;
+    for( const auto & jobs : _jobPartitions ) catalog += jobs.relevanceStatistics( keywords );
+
+    return best( [&]( const JobPartition & jobs ) { return jobs.topK( keywords, k, jobs.resolve( filter ), catalog ); }, k );
+  }
+
+
+  std::vector<JobInfo> SimpleDB::recommendJobs( const std::string & name, std::size_t n )
+  {
+    // The jobs applied for are those the seeker is known to like, so they make up the profile, and aren't recommended again
+    std::vector<int> applied;
+    for( const auto & application : _storedApplications.read()->byUser( name ) ) applied.push_back( application.jobId );
+    std::sort( applied.begin(), applied.end() );
+    applied.erase( std::unique( applied.begin(), applied.end() ), applied.end() );
+    if( applied.empty() ) return {};
+
+    std::shared_lock lock( _jobsLock );
+
+    // Taken in storage order, so the profile doesn't depend on the order applied in
+    std::vector<JobRow> liked;
+    for( auto id : applied )
+      for( auto [located, last] = _jobRows.equal_range( id ); located != last; ++located ) liked.push_back( located->second );
+    std::sort( liked.begin(), liked.end(), []( const JobRow & lhs, const JobRow & rhs )
+                                           { return lhs.partition < rhs.partition || ( lhs.partition == rhs.partition && lhs.row < rhs.row ); } );
+
+    std::vector<JobInfo> likedJobs;
+    for( const auto & located : liked ) likedJobs.push_back( normalize( _jobPartitions[located.partition].job( located.row ) ) );
+    auto profile = RelevanceIndex::profile( likedJobs );
+
+    // Only the terms most telling of the profile against the whole catalog are ranked by, then scored against the catalog too
+    RelevanceIndex::Statistics catalog;
+    for( const auto & jobs : _jobPartitions ) catalog += jobs.relevanceStatistics( profile );
+    profile = RelevanceIndex::mostTelling( profile, catalog, RelevanceIndex::MostProfileTerms );
+    if( profile.empty() ) return {};
+
+    catalog = {};
+    for( const auto & jobs : _jobPartitions ) catalog += jobs.relevanceStatistics( profile );
+
+    return best( [&]( const JobPartition & jobs ) { return jobs.topK( profile, n, applied, catalog ); }, n );
+  }
+
+
+  std::vector<JobInfo> SimpleDB::best( const std::function<std::vector<RelevanceIndex::Match>( const JobPartition & )> & rank, std::size_t k ) const
+  {
+    struct Ranked
+    {
+      double            score;
+      QueryCache::Match found;
+    };
+
+    std::vector<std::vector<Ranked>> best( _jobPartitions.size() );
+    scatter( [&]( std::size_t partition )
+    {
+      const auto & jobs = _jobPartitions[partition];
+      for( const auto & match : rank( jobs ) ) best[partition].push_back( { match.score, { jobs.position( match.row ), static_cast<std::uint32_t>( partition ), match.row } } );
+    } );
+
+    std::vector<Ranked> ranked;
+    for( auto & partition : best ) std::move( partition.begin(), partition.end(), std::back_inserter( ranked ) );
+    std::sort( ranked.begin(), ranked.end(), []( const Ranked & lhs, const Ranked & rhs )
+                                              { return lhs.score > rhs.score || ( !( lhs.score < rhs.score ) && lhs.found.position < rhs.found.position ); } );
+
+    // Only the best k are materialized
+    Found found;
+    for( std::size_t place = 0; place != ranked.size() && place != k; ++place ) found.push_back( ranked[place].found );
+    return materialize( found );
+  }
+
+
+  SearchPage SimpleDB::searchPage( const SearchCursor & cursor, std::size_t pageSize )
+  {
+    SearchPage page;
+    page.next.criteria = cursor.criteria;
+    page.next.query    = cursor.query;
+    if( cursor.exhausted ) { page.next.exhausted = true; return page; }
+
+    std::optional<JobQuery> query;
+    if( !cursor.query.empty() ) query.emplace( cursor.query, &_gazetteer );
+
+    // The first match beyond the page is looked for too, so the cursor can tell whether there are more to come
+    std::shared_lock lock( _jobsLock );
+    auto             found = query ? find( *query, cursor.nextRow, pageSize + 1 ) : find( cursor.criteria, cursor.nextRow, pageSize + 1 );
+    page.next.exhausted = found.size() <= pageSize;
+    page.next.nextRow   = page.next.exhausted ? jobCount() : found[pageSize].position;
+
+    if( !page.next.exhausted ) found.pop_back();
+    page.jobs = materialize( found );
+    return page;
+  }
+
+
+  std::size_t SimpleDB::countByFacets( const std::string & location, const std::string & category )
+  {
+    std::shared_lock lock( _jobsLock );
+    std::size_t      count = 0;
+    auto             facet = []( const std::string & value ) { return value == "0" ? std::string() : normalize( value ); };
+    for( const auto & jobs : _jobPartitions ) count += jobs.countByFacets( facet( location ), facet( category ) );
+    return count;
+  }
+
+
+  bool SimpleDB::addJob( const JobInfo & job )
+  {
+    std::unique_lock lock( _jobsLock );
+    if( _jobRows.contains( job.id ) ) return false;
+    if( _collapseDuplicates && _duplicates.find( job ) ) return false;
+
+    appendJob( job );
+
+    // Searches needn't wait while saved searches are matched against the new job, but saved searches are taken in hand before
+    // the catalog is let go:  a search saved after the job was posted (saveSearch() takes the locks in the same order) isn't
+    // alerted to it, and concurrent postings alert in catalog order
+    std::lock_guard saved( _savedSearchesLock );
+    lock.unlock();
+    _savedSearches.percolate( job );
+    return true;
+  }
+
+
+  bool SimpleDB::updateJob( const JobInfo & job )
+  {
+    // The changed job is appended anew, so cursors already past its old place still come across it
+    std::unique_lock lock( _jobsLock );
+    if( !dropJob( job.id ) ) return false;
+
+    appendJob( job );
+    return true;
+  }
+
+
+  bool SimpleDB::removeJob( int jobId )
+  {
+    std::unique_lock lock( _jobsLock );
+    return dropJob( jobId );
+  }
+
+
+  void SimpleDB::appendJob( const JobInfo & job )
+  {
+    // A new job takes the next catalog position, which follows every row of every partition, so any partition may take it
+    auto   position  = jobCount();
+    auto   smallest  = std::min_element( _jobPartitions.begin(), _jobPartitions.end(),
+                                         []( const JobPartition & lhs, const JobPartition & rhs ) { return lhs.size() < rhs.size(); } );
+    auto & jobs      = *smallest;
+    auto   partition = static_cast<std::size_t>( smallest - _jobPartitions.begin() );
+
+    jobs.append( std::span( &job, 1 ), position );
+    _jobRows.emplace( job.id, JobRow{ partition, static_cast<RowId>( jobs.size() - 1 ) } );
+    _autocompleter.insert( std::span( &job, 1 ) );
+    _duplicates   .append( std::span( &job, 1 ), position );
+    _queryCache->invalidate( job, static_cast<RowId>( position ) );
+  }
+
+
+  bool SimpleDB::dropJob( int jobId )
+  {
+    auto [first, last] = _jobRows.equal_range( jobId );
+    if( first == last ) return false;
+
+    for( auto located = first; located != last; ++located )
+    {
+      auto & jobs = _jobPartitions[located->second.partition];
+      auto   row  = located->second.row;
+      auto   job  = jobs.job( row );
+      jobs.remove( row );
+      _autocompleter.erase( job );
+      _duplicates   .erase( jobs.position( row ) );
+      _queryCache->invalidate( job, jobs.position( row ) );
+    }
+    _jobRows.erase( first, last );
+    return true;
+  }
+
+
+  void SimpleDB::indexJobIds()
+  {
+    _jobRows.clear();
+    _jobRows.reserve( jobCount() );
+    for( std::size_t partition = 0; partition != _jobPartitions.size(); ++partition )
+    {
+      const auto & jobs = _jobPartitions[partition];
+      for( RowId row = 0; row != jobs.size(); ++row ) if( !jobs.removed( row ) ) _jobRows.emplace( jobs.id( row ), JobRow{ partition, row } );
+    }
   }
 
 
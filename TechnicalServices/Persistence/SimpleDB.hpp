@@ -1,11 +1,31 @@
 #pragma once
 
-#include <memory>    // unique_ptr
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <functional>   // function
+#include <map>
+#include <memory>       // unique_ptr
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>      // pair
 #include <vector>
 
 #include "TechnicalServices/Logging/LoggerHandler.hpp"
+#include "TechnicalServices/Persistence/ApplicationLog.hpp"
+#include "TechnicalServices/Persistence/ApplicationStore.hpp"
+#include "TechnicalServices/Persistence/Autocompleter.hpp"
+#include "TechnicalServices/Persistence/DuplicateIndex.hpp"
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/JobPartition.hpp"
+#include "TechnicalServices/Persistence/JobQuery.hpp"
 #include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/QueryCache.hpp"
+#include "TechnicalServices/Persistence/SavedSearches.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Versioned.hpp"
 
 
 
@@ -23,21 +43,112 @@ namespace TechnicalServices::Persistence
       std::vector<std::string> findRoles()                                       override;  // Returns list of all legal roles
       std::vector<Application>     getUserApplication(const std::string& name) override;
       bool                      makeApplication(const std::string& name, int jobId) override;
+      bool                     updateApplicationStatus( const std::string & name, int jobId, const std::string & status ) override;
+      std::vector<Application> getJobApplicants( int jobId, const std::string & status, std::size_t offset, std::size_t pageSize ) override;
       UserCredentials          findCredentialsByName( const std::string & name ) override;  // Returns credentials for specified user, throws NoSuchUser if user not found
       std::vector<JobInfo>     searchByCriteria(const std::vector<std::string>& args) override;  // Returns credentials for specified user, throws NoSuchUser if user not found
+      SearchPage               searchPage( const SearchCursor & cursor, std::size_t pageSize ) override;
+      std::vector<JobInfo>     searchTopK( const std::vector<std::string> & args, std::size_t k ) override;
+      std::vector<JobInfo>     recommendJobs( const std::string & name, std::size_t n ) override;
+      std::size_t              countByFacets( const std::string & location, const std::string & category ) override;  // Returns number of jobs with exactly this location and category, ignoring case, accents and spacing
+      std::vector<JobInfo>     searchByQuery( const std::string & query ) override;
+      std::string              explainQuery ( const std::string & query ) override;
+      std::vector<Suggestion>  suggest( std::size_t criterion, const std::string & prefix, std::size_t limit ) override;
+      JobInfo                  findJob( int jobId ) override;
+      std::vector<JobInfo>     findDuplicates( int jobId ) override;
+      std::size_t              saveSearch   ( const std::string & name, const std::string & query ) override;
+      std::vector<SavedSearch> savedSearches( const std::string & name ) override;
+      bool                     forgetSearch ( const std::string & name, std::size_t id ) override;
+      std::vector<JobAlert>    takeAlerts   ( const std::string & name ) override;
+      bool                     addJob   ( const JobInfo & job ) override;
+      bool                     updateJob( const JobInfo & job ) override;
+      bool                     removeJob( int jobId )           override;
 
 
       // Adaptation Data read only access.  Adaptation data is a Key/Value pair
       const std::string & operator[]( const std::string & key ) const override;
 
+      // Property data (Key/Value pairs) off-line modifiable by the end-user, as read from Library_System_AdaptableData.dat in the
+      // current directory, none if there's no such file.  Read ahead of construction to choose which database to construct.
+      using AdaptationData = std::map<std::string /*Key*/, std::string /*Value*/>;
+      static std::optional<AdaptationData> readAdaptationData();
+
 
       ~SimpleDB() noexcept override;
 
+    protected:
+      explicit SimpleDB( std::size_t jobPartitions );    // the job catalog split this many ways, each partition with its own indexes
+
+      // Calls work( partition ) for every job partition, returning once all have.  One after the other here, derived classes
+      // may spread them over threads.
+      virtual void scatter( const std::function<void( std::size_t partition )> & work ) const;
+
     private:
-      std::unique_ptr<TechnicalServices::Logging::LoggerHandler> _loggerPtr;
-      std::vector<UserCredentials> _storedUsers;
-      std::vector<JobInfo> _storedJobs;
-      std::vector<Application> _storedApplications;
+      const std::string *          adaptableItem     ( const std::string & key ) const;    // nullptr if absent or empty
+      std::size_t                  adaptableCount    ( const std::string & key, std::size_t otherwise ) const;    // otherwise if absent, throws PersistenceException if not a count
+      std::unique_ptr<SearchIndex> makeSearchIndex   ()                          const;    // of the kind named by Component.SearchIndex
+
+      // Start up, from the catalogs or from a snapshot image of them
+      void                         loadGazetteer     ();
+      void                         loadCatalogs      ();
+      std::uint64_t                catalogFingerprint()                          const;
+      bool                         restoreSnapshot   ( const std::string & path );          // false if missing, stale or corrupt
+      void                         saveSnapshot      ( const std::string & path ) const;
+      void                         openApplicationLog( const std::string & path );         // replays it, then logs changes to it
+      void                         commitApplication ( std::uint64_t logged, const std::string & change );    // waits for the log, reporting a failure rather than throwing
+
+      // Returns where up to limit jobs matching args at or after catalog position from are, from every partition, in catalog
+      // order, and materializes the jobs found from their partitions' columns.  The caller holds _jobsLock, shared or not.
+      using Found = QueryCache::Result;
+      Found                        find              ( const std::vector<std::string> & args, std::size_t from, std::size_t limit ) const;
+      Found                        find              ( const JobQuery & query, std::size_t from, std::size_t limit ) const;
+      std::vector<JobInfo>         materialize       ( const Found & found )      const;
+      std::size_t                  jobCount          ()                          const;    // catalog positions used, removed jobs included
+      std::optional<JobInfo>       jobAt             ( RowId position )          const;    // none if it's been removed
+
+      // Calls search( partition ) for every partition, merging the rows found into the first limit in catalog order
+      Found                        gather            ( const std::function<std::vector<RowId>( const JobPartition & )> & search, std::size_t limit ) const;
+
+      // Calls rank( partition ) for every partition, merging the rows ranked into the best k, ties in catalog order
+      std::vector<JobInfo>         best              ( const std::function<std::vector<RelevanceIndex::Match>( const JobPartition & )> & rank, std::size_t k ) const;
+
+      // Job changes, the caller holding _jobsLock exclusively
+      void                         appendJob         ( const JobInfo & job );
+      bool                         dropJob           ( int jobId );                        // false if there's no such job
+      void                         indexJobIds       ();                                   // rebuilds _jobRows from the partitions
+
+      // Bulk loading, each appends to what is already loaded and indexes the additions
+      void loadUsers       ( std::vector<UserCredentials> users        );
+      void loadJobs        ( std::vector<JobInfo>         jobs         );
+      void loadApplications( std::vector<Application>     applications );
+
+      std::unique_ptr<TechnicalServices::Logging::LoggerHandler>      _loggerPtr;
+
+      // Users and applications change while sessions read them, so each is versioned:  readers work from a snapshot without
+      // locking, writers publish a changed copy.  Jobs change rarely and their indexes are too big to copy, so they aren't:
+      // searches share _jobsLock and job changes take it exclusively, a search waiting out the change under way and a change
+      // the searches.  Only user and application reads never wait.  Jobs are split into partitions by catalog position, loaded
+      // in contiguous ranges, with jobs added since going to the smallest partition.
+      using Users = std::unordered_map<std::string /*User Name*/, UserCredentials>;
+      struct JobRow { std::size_t partition; RowId row; };                                  // where a job is stored
+      Versioned<Users>                                                _storedUsers;
+
+      mutable std::shared_mutex                                       _jobsLock;
+      Gazetteer                                                       _gazetteer;            // places job locations, per Persistence.Gazetteer
+      std::vector<JobPartition>                                       _jobPartitions;
+      std::unordered_multimap<int /*Job Id*/, JobRow>                 _jobRows;              // every job not removed, by id, so a change finds it without a scan
+      Autocompleter                                                   _autocompleter;        // the whole catalog's names, locations and categories
+      DuplicateIndex                                                  _duplicates;           // the whole catalog's near duplicate postings
+      bool                                                            _collapseDuplicates = false;    // per Persistence.NearDuplicates
+      std::unique_ptr<QueryCache>                                     _queryCache;           // recent search results, per Persistence.QueryCacheCapacity
+
+      Versioned<ApplicationStore>                                     _storedApplications;
+      std::unique_ptr<ApplicationLog>                                 _applicationLog;       // changes since start up, none means not persisted
+
+      // Saved searches are matched against each job added once it's in, so they have a lock of their own, taken after _jobsLock
+      // when both are held
+      std::mutex                                                      _savedSearchesLock;
+      SavedSearches                                                   _savedSearches;
 
       // convenience reference object enabling standard insertion syntax
       // This line must be physically after the definition of _loggerPtr
@@ -45,7 +156,6 @@ namespace TechnicalServices::Persistence
 
 
       // Property data (Key/Value pairs) off-line modifiable by the end-user
-      using AdaptationData = std::map<std::string /*Key*/, std::string /*Value*/>;
       AdaptationData _adaptablePairs;
 
   }; // class SimpleDB
@@ -0,0 +1,278 @@
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+#include <bit>           // rotl()
+#include <cstddef>       // size_t
+#include <cstdint>       // uint32_t, uint64_t
+#include <cstring>       // memcpy(), memcmp()
+#include <filesystem>    // path, rename(), remove()
+#include <memory>        // make_shared()
+#include <string>
+#include <string_view>
+
+#if __has_include( <unistd.h> )
+  #include <fcntl.h>       // open()
+  #include <unistd.h>      // fsync(), close()
+  #define SNAPSHOT_USES_POSIX
+#endif
+
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace
+{
+  constexpr char          Magic[8] = { 'e', 'M', 'a', 't', 'c', 'h', 'D', 'B' };
+  constexpr std::uint32_t Version  = 13;     // increment whenever the payload layout changes
+
+  // Header flags
+  constexpr std::uint32_t Synced   = 1;      // the image was on the disk before it was renamed into place, so it was written whole
+
+  struct Header
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t fingerprint;
+    std::uint64_t payloadSize;
+    std::uint64_t checksum;
+  };
+  static_assert( sizeof( Header ) % sizeof( std::uint64_t ) == 0, "the payload must start word aligned for arrays to be read in place" );
+
+
+  // Forces what's been written to path, a file or a directory's entries, out to the disk.  Returns false if it couldn't be.
+  bool sync( const std::filesystem::path & path )
+  {
+    #if defined( SNAPSHOT_USES_POSIX )
+      auto descriptor = ::open( path.c_str(), O_RDONLY );
+      if( descriptor < 0 ) return false;
+
+      auto synced = ::fsync( descriptor );
+      ::close( descriptor );
+      return synced == 0;
+    #else
+      return true;    // nothing portable to call, the rename is as good as it gets
+    #endif
+  }
+}    // namespace
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Snapshot Checksum
+  **   Word at a time multiply-rotate hash, fast enough to verify a large image at memory bandwidth
+  ******************************************************************************/
+  void SnapshotChecksum::mix( std::uint64_t word )
+  {
+    _hash ^= word * 0x87C37B91114253D5ULL;
+    _hash  = std::rotl( _hash, 31 ) * 0x4CF5AD432745937FULL;
+  }
+
+
+
+
+  void SnapshotChecksum::update( const char * data, std::size_t size )
+  {
+    _length += size;
+
+    // Top up a partial word left over from the previous update first
+    while( _pendingSize != 0 && size != 0 )
+    {
+      _pending[_pendingSize++] = *data++;
+      --size;
+      if( _pendingSize == sizeof( std::uint64_t ) )
+      {
+        std::uint64_t word;
+        std::memcpy( &word, _pending, sizeof word );
+        mix( word );
+        _pendingSize = 0;
+      }
+    }
+
+    for( ; size >= sizeof( std::uint64_t ); data += sizeof( std::uint64_t ), size -= sizeof( std::uint64_t ) )
+    {
+      std::uint64_t word;
+      std::memcpy( &word, data, sizeof word );
+      mix( word );
+    }
+
+    // Keep what's left for the next update.  Either the top up emptied the pending word or nothing is left, never both
+    std::memcpy( _pending + _pendingSize, data, size );
+    _pendingSize += size;
+  }
+
+
+
+
+  std::uint64_t SnapshotChecksum::value() const
+  {
+    SnapshotChecksum copy = *this;
+    std::uint64_t    tail = 0;
+    std::memcpy( &tail, _pending, _pendingSize );
+    copy.mix( tail );
+    copy.mix( _length );
+    return copy._hash;
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Snapshot Writer
+  ******************************************************************************/
+  SnapshotWriter::SnapshotWriter( const std::string & path, std::uint64_t fingerprint )
+    : _path( path ), _temporaryPath( path + ".tmp" ), _file( _temporaryPath, std::ios::binary | std::ios::trunc ), _fingerprint( fingerprint )
+  {
+    if( !_file.is_open() ) throw PersistenceHandler::PersistenceException( "Unable to create snapshot image \"" + _temporaryPath + '"' );
+
+    Header placeholder{};    // rewritten by commit() once the payload's size and checksum are known
+    _file.write( reinterpret_cast<const char *>( &placeholder ), sizeof placeholder );
+  }
+
+
+
+
+  void SnapshotWriter::raw( const void * data, std::size_t size )
+  {
+    _file.write( static_cast<const char *>( data ), static_cast<std::streamsize>( size ) );
+    _checksum.update( static_cast<const char *>( data ), size );
+    _payloadSize += size;
+  }
+
+
+
+
+  void SnapshotWriter::align( std::size_t alignment )
+  {
+    constexpr char padding[sizeof( std::uint64_t )] = {};
+    raw( padding, ( alignment - _payloadSize % alignment ) % alignment );
+  }
+
+
+
+
+  void SnapshotWriter::write( std::uint64_t value )
+  {
+    raw( &value, sizeof value );
+  }
+
+
+
+
+  void SnapshotWriter::write( const std::string & value )
+  {
+    write( std::uint64_t{ value.size() } );
+    raw( value.data(), value.size() );
+  }
+
+
+
+
+  void SnapshotWriter::commit()
+  {
+    Header header{};
+    std::memcpy( header.magic, Magic, sizeof Magic );
+    header.version     = Version;
+    header.fingerprint = _fingerprint;
+    header.payloadSize = _payloadSize;
+    header.checksum    = _checksum.value();
+    #if defined( SNAPSHOT_USES_POSIX )
+      header.flags     = Synced;    // else commit() throws before the rename
+    #endif
+
+    _file.seekp( 0 );
+    _file.write( reinterpret_cast<const char *>( &header ), sizeof header );
+    _file.close();
+
+    // The image is on the disk before it's renamed into place, or a crash could leave the new name on a truncated image
+    if( !_file || !sync( _temporaryPath ) )
+    {
+      std::filesystem::remove( _temporaryPath );
+      throw PersistenceHandler::PersistenceException( "Unable to write snapshot image \"" + _temporaryPath + '"' );
+    }
+
+    // Readers see either the old image or the complete new one, never a partially written one, and once the directory is synced
+    // so does a restart after a crash
+    std::filesystem::rename( _temporaryPath, _path );
+
+    auto directory = std::filesystem::path( _path ).parent_path();
+    if( !sync( directory.empty() ? std::filesystem::path( "." ) : directory ) )
+      throw PersistenceHandler::PersistenceException( "Unable to sync the directory of snapshot image \"" + _path + '"' );
+  }
+
+
+
+
+  /*****************************************************************************
+  ** Snapshot Reader
+  ******************************************************************************/
+  SnapshotReader::SnapshotReader( const std::string & path, std::uint64_t fingerprint ) : _file( std::make_shared<const MappedFile>( path ) )
+  {
+    auto image = _file->contents();
+
+    Header header;
+    if( image.size() < sizeof header ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image \"" + path + "\", truncated header" );
+    std::memcpy( &header, image.data(), sizeof header );
+
+    if( std::memcmp( header.magic, Magic, sizeof Magic ) != 0 ) throw PersistenceHandler::PersistenceException( '"' + path + "\" is not a snapshot image" );
+    if( header.version     != Version                         ) throw PersistenceHandler::PersistenceException( "Snapshot image \"" + path + "\" has an unsupported version" );
+    if( header.fingerprint != fingerprint                     ) throw PersistenceHandler::PersistenceException( "Snapshot image \"" + path + "\" is stale" );
+    if( header.payloadSize != image.size() - sizeof header    ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image \"" + path + "\", wrong size" );
+
+    _payload = image.substr( sizeof header );
+
+    // Hashing the payload reads every page of it, which costs most of a start at a million jobs.  An image synced before it was
+    // renamed into place can't be torn, and the loaders still check the counts, offsets and codes they read, so only an image
+    // written without syncing is verified.
+    if( ( header.flags & Synced ) == 0 )
+    {
+      SnapshotChecksum checksum;
+      checksum.update( _payload.data(), _payload.size() );
+      if( checksum.value() != header.checksum ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image \"" + path + "\", checksum mismatch" );
+    }
+  }
+
+
+
+
+  std::string_view SnapshotReader::bytes( std::size_t size )
+  {
+    if( size > _payload.size() - _position ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, payload too short" );
+
+    auto result = _payload.substr( _position, size );
+    _position += size;
+    return result;
+  }
+
+
+
+
+  void SnapshotReader::align( std::size_t alignment )
+  {
+    bytes( ( alignment - _position % alignment ) % alignment );
+  }
+
+
+
+
+  std::uint64_t SnapshotReader::readInteger()
+  {
+    std::uint64_t value;
+    std::memcpy( &value, bytes( sizeof value ).data(), sizeof value );
+    return value;
+  }
+
+
+
+
+  std::string SnapshotReader::readString()
+  {
+    auto size = readInteger();
+    if( size > _payload.size() ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, string too long" );
+    return std::string( bytes( size ) );
+  }
+}    // namespace TechnicalServices::Persistence
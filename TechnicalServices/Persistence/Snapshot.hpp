@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>        // size_t
+#include <cstdint>        // uint32_t, uint64_t
+#include <cstring>        // memcpy()
+#include <fstream>
+#include <memory>         // shared_ptr
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>    // is_trivially_copyable_v
+#include <vector>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/MappedFile.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Snapshot image
+  **   A snapshot is a binary image of SimpleDB's tables and indexes, written once the catalogs have been loaded and read back on
+  **   the next start instead of parsing the catalogs and rebuilding the indexes.  Layout, in native byte order:
+  **
+  **     Header   magic "eMatchDB", format version, flags, fingerprint of the catalogs it was built from, payload size, payload
+  **              checksum
+  **     Payload  sections written by SimpleDB and each index's save(), read back in the same order by load()
+  **
+  **   An array's elements are padded to their alignment within the payload (the header is a whole number of words), so a loader
+  **   may read them in place from the mapping through viewArray() rather than copying them out with readArray().
+  **
+  **   Readers map the image and verify the magic, version, fingerprint and size before anything is read, so a stale image
+  **   (catalogs changed since) or a truncated one is rejected as a whole rather than half loaded.  The payload's checksum is only
+  **   verified if the header's flags say the image wasn't synced to disk before it was renamed into place, as a torn write could
+  **   then have left it corrupt.  Loaders check the counts, offsets and codes they read regardless.
+  ******************************************************************************/
+  class SnapshotChecksum
+  {
+    public:
+      void          update( const char * data, std::size_t size );
+      std::uint64_t value () const;
+
+    private:
+      void mix( std::uint64_t word );
+
+      std::uint64_t _hash        = 0x9E3779B97F4A7C15ULL;
+      std::uint64_t _length      = 0;
+      char          _pending[8]  = {};
+      std::size_t   _pendingSize = 0;
+  };    // class SnapshotChecksum
+
+
+
+
+  class SnapshotWriter
+  {
+    public:
+      // Constructors
+      SnapshotWriter( const std::string & path, std::uint64_t fingerprint );    // throws PersistenceException if path can't be created
+
+
+      // Operations
+      void write( std::uint64_t value );
+      void write( const std::string & value );
+
+      template<typename T>
+      void write( const std::vector<T> & values ) { writeArray( std::span<const T>( values ) ); }    // trivially copyable elements only
+
+      template<typename T>
+      void write( const MappedArray<T> & values ) { writeArray( std::span<const T>( values ) ); }
+
+      void commit();    // completes the header and atomically replaces any previous image at path
+
+
+    private:
+      template<typename T>
+      void writeArray( std::span<const T> values );
+
+      void raw  ( const void * data, std::size_t size );
+      void align( std::size_t alignment );    // pads the payload to a multiple of alignment
+
+      std::string      _path;
+      std::string      _temporaryPath;
+      std::ofstream    _file;
+      std::uint64_t    _fingerprint;
+      std::uint64_t    _payloadSize = 0;
+      SnapshotChecksum _checksum;
+  };    // class SnapshotWriter
+
+
+
+
+  class SnapshotReader
+  {
+    public:
+      // Constructors
+      SnapshotReader( const std::string & path, std::uint64_t fingerprint );    // throws PersistenceException if missing, stale or corrupt
+
+
+      // Operations
+      std::uint64_t readInteger();
+      std::string   readString ();
+
+      template<typename T>
+      std::vector<T> readArray();    // copies the elements out of the image
+
+      template<typename T>
+      MappedArray<T> viewArray();    // reads the elements in place, keeping the image mapped while the array lives
+
+      bool exhausted() const { return _position == _payload.size(); }
+
+
+    private:
+      template<typename T>
+      std::span<const T> array();
+
+      std::string_view bytes( std::size_t size );    // throws PersistenceException if the payload is too short
+      void             align( std::size_t alignment );
+
+      std::shared_ptr<const MappedFile> _file;
+      std::string_view                  _payload;
+      std::size_t                       _position = 0;
+  };    // class SnapshotReader
+
+
+
+
+  /*****************************************************************************
+  ** Template implementations
+  ******************************************************************************/
+  template<typename T>
+  void SnapshotWriter::writeArray( std::span<const T> values )
+  {
+    static_assert( std::is_trivially_copyable_v<T> && alignof( T ) <= sizeof( std::uint64_t ) );
+    write( std::uint64_t{ values.size() } );
+    align( alignof( T ) );
+    raw( values.data(), values.size_bytes() );
+  }
+
+
+
+
+  template<typename T>
+  std::span<const T> SnapshotReader::array()
+  {
+    static_assert( std::is_trivially_copyable_v<T> && alignof( T ) <= sizeof( std::uint64_t ) );
+    auto size = readInteger();
+    if( size > _payload.size() / sizeof( T ) ) throw PersistenceHandler::PersistenceException( "Corrupt snapshot image, array too large" );
+
+    align( alignof( T ) );
+    auto source = bytes( size * sizeof( T ) );
+    return { reinterpret_cast<const T *>( source.data() ), size };    // the payload starts word aligned, and the writer aligned the elements
+  }
+
+
+
+
+  template<typename T>
+  std::vector<T> SnapshotReader::readArray()
+  {
+    auto           source = array<T>();
+    std::vector<T> values( source.size() );
+    if( !values.empty() ) std::memcpy( values.data(), source.data(), source.size_bytes() );
+    return values;
+  }
+
+
+
+
+  template<typename T>
+  MappedArray<T> SnapshotReader::viewArray()
+  {
+    auto source = array<T>();
+    if( source.empty() ) return {};
+    return { _file, source };
+  }
+}    // namespace TechnicalServices::Persistence
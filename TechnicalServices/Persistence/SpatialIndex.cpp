@@ -0,0 +1,154 @@
+#include "TechnicalServices/Persistence/SpatialIndex.hpp"
+
+#include <algorithm>    // clamp(), find(), max(), min()
+#include <cmath>        // abs(), cos(), floor()
+#include <cstddef>      // size_t
+#include <cstdint>      // int64_t, uint32_t, uint64_t
+#include <functional>   // function
+#include <numbers>      // pi
+#include <vector>
+
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  namespace
+  {
+    constexpr double radians        = std::numbers::pi / 180.0;
+    constexpr double milesPerDegree = 3958.8 * radians;    // of latitude, anywhere
+
+    // The position of degrees within [lowest, lowest + range), as a 32 bit fraction
+    std::uint32_t quantize( double degrees, double lowest, double range )
+    {
+      auto fraction = std::clamp( ( degrees - lowest ) / range, 0.0, 1.0 );
+      return static_cast<std::uint32_t>( std::min( fraction * 4294967296.0, 4294967295.0 ) );
+    }
+
+    // Moves the 32 bits of value to the even bits of the result
+    std::uint64_t spread( std::uint64_t value )
+    {
+      value = ( value | ( value << 16 ) ) & 0x0000FFFF0000FFFF;
+      value = ( value | ( value <<  8 ) ) & 0x00FF00FF00FF00FF;
+      value = ( value | ( value <<  4 ) ) & 0x0F0F0F0F0F0F0F0F;
+      value = ( value | ( value <<  2 ) ) & 0x3333333333333333;
+      value = ( value | ( value <<  1 ) ) & 0x5555555555555555;
+      return value;
+    }
+  }    // namespace
+
+
+
+
+  SpatialIndex::SpatialIndex( const Gazetteer & gazetteer ) : _gazetteer( &gazetteer )
+  {}
+
+
+
+
+  SpatialIndex::Geohash SpatialIndex::geohash( const Coordinates & coordinates )
+  {
+    return spread( quantize( coordinates.longitude, -180.0, 360.0 ) ) << 1 | spread( quantize( coordinates.latitude, -90.0, 180.0 ) );
+  }
+
+
+
+
+  void SpatialIndex::insert( RowId row, const JobInfo & job )
+  {
+    auto coordinates = _gazetteer->find( job.location ).value_or( Coordinates{} );
+
+    _coordinates.push_back( coordinates );
+    if( coordinates.known() )
+    {
+      auto & place = _places.try_emplace( geohash( coordinates ), Place{ coordinates, {} } ).first->second;
+      place.rows.push_back( row );
+    }
+  }
+
+
+
+
+  void SpatialIndex::forEachWithin( const Coordinates & centre, double miles, const std::function<void( const Place & )> & visit ) const
+  {
+    if( !centre.known() || miles < 0 ) return;
+
+    // The circle's bounding box, a touch generous so rounding never cuts off a place on its edge.  Near a pole the box takes in
+    // every longitude.
+    double latitudeSpan  = miles / milesPerDegree * 1.001 + 1e-6;
+    double south         = std::max( -90.0, centre.latitude - latitudeSpan );
+    double north         = std::min(  90.0, centre.latitude + latitudeSpan );
+    double widest        = std::max( std::abs( south ), std::abs( north ) );
+    double longitudeSpan = widest >= 89.9 ? 180.0 : std::min( 180.0, latitudeSpan / std::cos( widest * radians ) );
+
+    // The finest precision whose cells are no smaller than the box, so the box overlaps at most two cells each way
+    unsigned bits = 0;
+    while( bits < 32 && 180.0 / double( 1ULL << ( bits + 1 ) ) >= 2 * latitudeSpan && 360.0 / double( 1ULL << ( bits + 1 ) ) >= 2 * longitudeSpan ) ++bits;
+
+    const std::uint64_t cells = 1ULL << bits;
+    auto southCell = std::uint64_t{ quantize( south, -90.0, 180.0 ) } >> ( 32 - bits );
+    auto northCell = std::uint64_t{ quantize( north, -90.0, 180.0 ) } >> ( 32 - bits );
+
+    // Longitude wraps around, so the box may straddle the antimeridian
+    std::vector<std::uint64_t> longitudeCells;
+    auto westCell = static_cast<std::int64_t>( std::floor( ( centre.longitude - longitudeSpan + 180.0 ) / 360.0 * double( cells ) ) );
+    auto eastCell = static_cast<std::int64_t>( std::floor( ( centre.longitude + longitudeSpan + 180.0 ) / 360.0 * double( cells ) ) );
+    for( auto cell = westCell; cell <= eastCell; ++cell )
+    {
+      auto wrapped = static_cast<std::uint64_t>( ( cell % static_cast<std::int64_t>( cells ) + static_cast<std::int64_t>( cells ) ) % static_cast<std::int64_t>( cells ) );
+      if( std::find( longitudeCells.cbegin(), longitudeCells.cend(), wrapped ) == longitudeCells.cend() ) longitudeCells.push_back( wrapped );
+    }
+
+    // Each cell is the run of geohashes sharing its leading 2 * bits bits
+    const Geohash cellSpan = bits == 0 ? ~Geohash{ 0 } : ( Geohash{ 1 } << ( 64 - 2 * bits ) ) - 1;
+    for( auto latitudeCell = southCell; latitudeCell <= northCell; ++latitudeCell )
+      for( auto longitudeCell : longitudeCells )
+      {
+        Geohash first = spread( longitudeCell << ( 32 - bits ) ) << 1 | spread( latitudeCell << ( 32 - bits ) );
+        for( auto place = _places.lower_bound( first ); place != _places.cend() && place->first <= ( first | cellSpan ); ++place )
+          if( Gazetteer::miles( centre, place->second.coordinates ) <= miles ) visit( place->second );
+      }
+  }
+
+
+
+
+  PostingList SpatialIndex::within( const Coordinates & centre, double miles ) const
+  {
+    std::vector<PostingView> lists;
+    forEachWithin( centre, miles, [&]( const Place & place ) { lists.push_back( place.rows ); } );
+    return uniteAll( lists );
+  }
+
+
+
+
+  std::size_t SpatialIndex::cardinality( const Coordinates & centre, double miles ) const
+  {
+    std::size_t rows = 0;
+    forEachWithin( centre, miles, [&]( const Place & place ) noexcept { rows += place.rows.size(); } );
+    return rows;
+  }
+
+
+
+
+  // Only the coordinates are saved, the places are rebuilt from them
+  void SpatialIndex::save( SnapshotWriter & image ) const
+  {
+    image.write( _coordinates );
+  }
+
+
+
+
+  void SpatialIndex::load( SnapshotReader & image )
+  {
+    _coordinates = image.viewArray<Coordinates>();
+    _places.clear();
+    for( RowId row = 0; row != _coordinates.size(); ++row )
+      if( _coordinates[row].known() ) _places.try_emplace( geohash( _coordinates[row] ), Place{ _coordinates[row], {} } ).first->second.rows.push_back( row );
+  }
+}    // namespace TechnicalServices::Persistence
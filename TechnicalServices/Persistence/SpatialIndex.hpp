@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>        // size_t
+#include <cstdint>        // uint64_t
+#include <functional>     // function
+#include <map>
+#include <vector>
+
+#include "TechnicalServices/Persistence/Gazetteer.hpp"
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Spatial Index
+  **   Places each row at the coordinates the gazetteer gives its location, and finds the rows within a distance of a point.
+  **
+  **   Rows at the same coordinates are grouped into one place, and places are ordered by geohash:  their latitude and longitude
+  **   bits interleaved, so every geohash cell, at any precision, is a contiguous run of places.  A radius search picks the finest
+  **   precision whose cells are at least as big as the circle's bounding box, so at most four cells can overlap the circle, and
+  **   measures the distance to just the places in those cells.  Rows at a location the gazetteer doesn't know are never within
+  **   any distance.
+  ******************************************************************************/
+  class SpatialIndex
+  {
+    public:
+      // Constructors
+      explicit SpatialIndex( const Gazetteer & gazetteer );
+
+
+      // Operations
+      void        insert     ( RowId row, const JobInfo & job );    // rows must be inserted in ascending order
+      Coordinates coordinates( RowId row ) const { return _coordinates[row]; }
+      std::size_t size       ()            const { return _coordinates.size(); }
+
+      // Returns exactly the rows within miles of centre, or just how many there are
+      PostingList within     ( const Coordinates & centre, double miles ) const;
+      std::size_t cardinality( const Coordinates & centre, double miles ) const;
+
+      // Snapshot image support, load() replaces the index's contents with those saved
+      void save( SnapshotWriter & image ) const;
+      void load( SnapshotReader & image );
+
+    private:
+      using Geohash = std::uint64_t;    // 32 bits of longitude interleaved with 32 of latitude
+
+      struct Place
+      {
+        Coordinates coordinates;
+        PostingList rows;
+      };
+
+      static Geohash geohash( const Coordinates & coordinates );
+
+      // Calls visit( place ) for every place within miles of centre
+      void forEachWithin( const Coordinates & centre, double miles, const std::function<void( const Place & )> & visit ) const;
+
+      const Gazetteer *              _gazetteer;
+      MappedArray<Coordinates>       _coordinates;    // by row
+      std::map<Geohash, Place>       _places;         // known coordinates only
+  };    // class SpatialIndex
+}    // namespace TechnicalServices::Persistence
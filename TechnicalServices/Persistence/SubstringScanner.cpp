@@ -0,0 +1,211 @@
+#include "TechnicalServices/Persistence/SubstringScanner.hpp"
+
+#include <algorithm>    // max()
+#include <bit>          // countr_zero()
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstring>      // memcmp()
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  #include <immintrin.h>
+  #define SUBSTRING_SCANNER_USES_X86
+#endif
+
+#include "TechnicalServices/Persistence/JobTable.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace
+{
+  using TechnicalServices::Persistence::PostingList;
+  using TechnicalServices::Persistence::RowId;
+  using Offsets = std::span<const std::uint64_t>;
+
+
+  // One needle's progress through the column
+  struct Needle
+  {
+    std::string_view text;
+    RowId            row    = 0;    // row holding the last candidate position, candidates arrive in ascending order
+    std::size_t      resume = 0;    // candidates before here are in a row already found, so not worth checking
+    PostingList      rows;          // rows found to contain the needle so far
+  };
+
+
+  // Called for each position where the needle's first and last characters both match, to finish the comparison and record the
+  // row.  Rows are back to back in the column, so a match must also end within the row it starts in.
+  inline void verify( Needle & needle, std::string_view column, Offsets offsets, std::size_t position )
+  {
+    while( offsets[needle.row + 1] <= position ) ++needle.row;
+
+    if( position + needle.text.size() > offsets[needle.row + 1] )                                         return;    // would run into the next row
+    if( std::memcmp( column.data() + position + 1, needle.text.data() + 1, needle.text.size() - 1 ) != 0 ) return;
+
+    needle.rows.push_back( needle.row );
+    needle.resume = offsets[needle.row + 1];
+  }
+
+
+  // Scalar kernel, also finishes the tail the vector kernels leave short of a whole block.  Leans on the library's find(), which
+  // is usually vectorized itself, so this takes a pass per needle.
+  void scanScalar( std::string_view column, Offsets offsets, std::vector<Needle> & needles, std::size_t from )
+  {
+    for( auto & needle : needles )
+      for( auto position = column.find( needle.text, std::max( from, needle.resume ) ); position != std::string_view::npos;
+                position = column.find( needle.text, std::max( position + 1, needle.resume ) ) )
+        verify( needle, column, offsets, position );
+  }
+
+
+  #if defined( SUBSTRING_SCANNER_USES_X86 )
+    // Each block is compared against every needle before moving on, so the column is read once however many needles there are
+    __attribute__(( target( "sse2" ) ))
+    void scanSSE2( std::string_view column, Offsets offsets, std::vector<Needle> & needles, std::size_t longest )
+    {
+      constexpr std::size_t Block = sizeof( __m128i );
+
+      std::size_t position = 0;
+      for( ; position + longest - 1 + Block <= column.size(); position += Block )
+        for( auto & needle : needles )
+        {
+          if( needle.resume >= position + Block ) continue;
+
+          auto first = _mm_loadu_si128( reinterpret_cast<const __m128i *>( column.data() + position ) );
+          auto last  = _mm_loadu_si128( reinterpret_cast<const __m128i *>( column.data() + position + needle.text.size() - 1 ) );
+          auto hits  = _mm_and_si128( _mm_cmpeq_epi8( first, _mm_set1_epi8( needle.text.front() ) ),
+                                      _mm_cmpeq_epi8( last,  _mm_set1_epi8( needle.text.back()  ) ) );
+
+          auto mask  = static_cast<std::uint32_t>( _mm_movemask_epi8( hits ) );
+          if( needle.resume > position ) mask &= ~0U << ( needle.resume - position );
+
+          while( mask != 0 )
+          {
+            auto candidate = position + static_cast<std::size_t>( std::countr_zero( mask ) );
+            mask &= mask - 1;
+
+            verify( needle, column, offsets, candidate );
+            if( needle.resume >= position + Block ) break;                                          // rest of the row is found
+            if( needle.resume >  position         ) mask &= ~0U << ( needle.resume - position );
+          }
+        }
+
+      scanScalar( column, offsets, needles, position );
+    }
+
+
+    __attribute__(( target( "avx2" ) ))
+    void scanAVX2( std::string_view column, Offsets offsets, std::vector<Needle> & needles, std::size_t longest )
+    {
+      constexpr std::size_t Block = sizeof( __m256i );
+
+      std::size_t position = 0;
+      for( ; position + longest - 1 + Block <= column.size(); position += Block )
+        for( auto & needle : needles )
+        {
+          if( needle.resume >= position + Block ) continue;
+
+          auto first = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( column.data() + position ) );
+          auto last  = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( column.data() + position + needle.text.size() - 1 ) );
+          auto hits  = _mm256_and_si256( _mm256_cmpeq_epi8( first, _mm256_set1_epi8( needle.text.front() ) ),
+                                         _mm256_cmpeq_epi8( last,  _mm256_set1_epi8( needle.text.back()  ) ) );
+
+          auto mask  = static_cast<std::uint32_t>( _mm256_movemask_epi8( hits ) );
+          if( needle.resume > position ) mask &= ~0U << ( needle.resume - position );
+
+          while( mask != 0 )
+          {
+            auto candidate = position + static_cast<std::size_t>( std::countr_zero( mask ) );
+            mask &= mask - 1;
+
+            verify( needle, column, offsets, candidate );
+            if( needle.resume >= position + Block ) break;                                          // rest of the row is found
+            if( needle.resume >  position         ) mask &= ~0U << ( needle.resume - position );
+          }
+        }
+
+      scanScalar( column, offsets, needles, position );
+    }
+  #endif
+}    // namespace
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  SubstringScanner::SubstringScanner( Kernel kernel ) : _kernel( std::min( kernel, fastest() ) )
+  {}
+
+
+
+
+  SubstringScanner::Kernel SubstringScanner::fastest()
+  {
+    #if defined( SUBSTRING_SCANNER_USES_X86 )
+      static const Kernel best = __builtin_cpu_supports( "avx2" ) ? Kernel::AVX2
+                               : __builtin_cpu_supports( "sse2" ) ? Kernel::SSE2
+                               :                                    Kernel::Scalar;
+      return best;
+    #else
+      return Kernel::Scalar;
+    #endif
+  }
+
+
+
+
+  const char * SubstringScanner::name( Kernel kernel )
+  {
+    switch( kernel )
+    {
+      case Kernel::AVX2:   return "AVX2";
+      case Kernel::SSE2:   return "SSE2";
+      case Kernel::Scalar: return "scalar";
+      default:             return "unknown";
+    }
+  }
+
+
+
+
+  PostingList SubstringScanner::rowsContainingAll( const StringHeap & column, const std::vector<std::string> & needles ) const
+  {
+    // Every row contains the empty string, so only the others need looking for
+    std::vector<Needle> searching;
+    std::size_t         longest = 1;
+    for( const auto & needle : needles ) if( !needle.empty() )
+    {
+      searching.push_back( { needle, 0, 0, {} } );
+      longest = std::max( longest, needle.size() );
+    }
+
+    if( searching.empty() )
+    {
+      PostingList everyRow( column.size() );
+      for( RowId row = 0; row != everyRow.size(); ++row ) everyRow[row] = row;
+      return everyRow;
+    }
+
+
+    auto text = column.characters();
+    switch( _kernel )
+    {
+      #if defined( SUBSTRING_SCANNER_USES_X86 )
+        case Kernel::AVX2: scanAVX2( text, column.offsets(), searching, longest ); break;
+        case Kernel::SSE2: scanSSE2( text, column.offsets(), searching, longest ); break;
+      #endif
+      case Kernel::Scalar:
+      default:             scanScalar( text, column.offsets(), searching, 0 );     break;
+    }
+
+    auto rows = std::move( searching.front().rows );
+    for( auto needle = searching.begin() + 1; needle != searching.end() && !rows.empty(); ++needle ) rows = intersect( rows, needle->rows );
+    return rows;
+  }
+}    // namespace TechnicalServices::Persistence
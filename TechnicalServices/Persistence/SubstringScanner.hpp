@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TechnicalServices/Persistence/JobTable.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Substring Scanner
+  **   Brute force substring search over a whole text column, for criteria no index can narrow.  Rather than calling find() row
+  **   by row, the scanner makes one pass over the column's contiguous characters testing every needle at once:  a vector
+  **   compare of each needle's first and last characters against a block of 16 or 32 positions picks out the few positions
+  **   worth a full compare.  The widest kernel the processor supports is chosen at run time.
+  ******************************************************************************/
+  class SubstringScanner
+  {
+    public:
+      enum class Kernel { Scalar, SSE2, AVX2 };
+
+
+      // Constructors
+      explicit SubstringScanner( Kernel kernel = fastest() );    // a kernel the processor lacks falls back to the fastest it has
+
+
+      // Operations
+      static Kernel       fastest();
+      static const char * name   ( Kernel kernel );
+      Kernel              kernel () const { return _kernel; }
+
+      // Returns the rows whose text contains every one of the needles, ascending
+      PostingList rowsContainingAll( const StringHeap & column, const std::vector<std::string> & needles ) const;
+
+    private:
+      Kernel _kernel;
+  };    // class SubstringScanner
+}    // namespace TechnicalServices::Persistence
@@ -0,0 +1,92 @@
+#include "TechnicalServices/Persistence/ThreadPool.hpp"
+
+#include <cstddef>      // size_t
+#include <exception>    // current_exception(), rethrow_exception()
+#include <functional>   // function
+#include <mutex>        // unique_lock
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  ThreadPool::ThreadPool( std::size_t threads )
+  {
+    _workers.reserve( threads );
+    for( std::size_t worker = 0; worker != threads; ++worker ) _workers.emplace_back( [this]
+    {
+      std::unique_lock lock( _mutex );
+      while( true )
+      {
+        _queued.wait( lock, [this] { return _stopping || !_batches.empty(); } );
+        if( _stopping ) return;
+
+        // Tasks are claimed under the lock, so a batch is never touched once its caller has seen it finish
+        auto & batch = *_batches.front();
+        auto   index = batch.claimed++;
+        if( batch.claimed == batch.tasks ) _batches.pop_front();
+        work( batch, index, lock );
+      }
+    } );
+  }
+
+
+
+
+  void ThreadPool::run( std::size_t tasks, const std::function<void( std::size_t )> & task )
+  {
+    if( tasks == 0 ) return;
+
+    Batch            batch{ &task, tasks, 0, 0, {} };
+    std::unique_lock lock( _mutex );
+    if( tasks > 1 )
+    {
+      _batches.push_back( &batch );
+      _queued.notify_all();
+    }
+
+    // Work through the batch too, then wait for any tasks the workers still have in hand
+    while( batch.claimed != batch.tasks )
+    {
+      auto index = batch.claimed++;
+      if( batch.claimed == batch.tasks && tasks > 1 ) std::erase( _batches, &batch );
+      work( batch, index, lock );
+    }
+    _finished.wait( lock, [&] { return batch.finished == batch.tasks; } );
+
+    if( batch.failure ) std::rethrow_exception( batch.failure );
+  }
+
+
+
+
+  void ThreadPool::work( Batch & batch, std::size_t index, std::unique_lock<std::mutex> & lock )
+  {
+    lock.unlock();
+    std::exception_ptr failure;
+    try
+    {
+      ( *batch.task )( index );
+    }
+    catch( ... )
+    {
+      failure = std::current_exception();
+    }
+    lock.lock();
+
+    if( failure && !batch.failure ) batch.failure = failure;
+    if( ++batch.finished == batch.tasks ) _finished.notify_all();
+  }
+
+
+
+
+  ThreadPool::~ThreadPool() noexcept
+  {
+    {
+      std::lock_guard lock( _mutex );
+      _stopping = true;
+    }
+    _queued.notify_all();
+  }
+}    // namespace TechnicalServices::Persistence
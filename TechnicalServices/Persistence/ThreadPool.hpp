@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>               // size_t
+#include <deque>
+#include <exception>             // exception_ptr
+#include <functional>            // function
+#include <mutex>
+#include <thread>                // jthread
+#include <vector>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Thread Pool
+  **   A fixed set of worker threads for fanning one piece of work out in parallel, such as a search of every job partition.
+  **   The calling thread works alongside the pool rather than waiting idle, so concurrent callers each make progress even when
+  **   every worker is busy with someone else's work.
+  ******************************************************************************/
+  class ThreadPool
+  {
+    public:
+      // Constructors
+      explicit ThreadPool( std::size_t threads );
+      ThreadPool( const ThreadPool & ) = delete;
+      ThreadPool & operator=( const ThreadPool & ) = delete;
+
+
+      // Operations
+      // Calls task( 0 ) through task( tasks - 1 ) spread over the pool and the caller, returning once all have.  Rethrows the first
+      // exception any of them threw.
+      void run( std::size_t tasks, const std::function<void( std::size_t )> & task );
+
+
+      // Destructor
+      ~ThreadPool() noexcept;
+
+    private:
+      struct Batch
+      {
+        const std::function<void( std::size_t )> * task;
+        std::size_t                                 tasks;
+        std::size_t                                 claimed  = 0;
+        std::size_t                                 finished = 0;
+        std::exception_ptr                          failure;
+      };
+
+      void work( Batch & batch, std::size_t index, std::unique_lock<std::mutex> & lock );    // runs one task with lock released
+
+      std::mutex                  _mutex;
+      std::condition_variable     _queued;      // notified when a batch arrives or the pool is stopping
+      std::condition_variable     _finished;    // notified when a batch's last task finishes
+      std::deque<Batch *>         _batches;     // those with tasks still to claim, oldest first
+      bool                        _stopping = false;
+      std::vector<std::jthread>   _workers;     // declared last so they stop first
+  };    // class ThreadPool
+}    // namespace TechnicalServices::Persistence
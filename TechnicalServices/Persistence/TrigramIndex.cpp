@@ -0,0 +1,132 @@
+#include "TechnicalServices/Persistence/TrigramIndex.hpp"
+
+#include <algorithm>    // min(), sort(), unique()
+#include <cstddef>      // size_t
+#include <limits>       // numeric_limits
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+#include "TechnicalServices/Persistence/Snapshot.hpp"
+
+
+
+
+namespace
+{
+  // Returns the distinct trigrams of text, in no particular order
+  std::vector<std::uint32_t> trigramsOf( std::string_view text )
+  {
+    std::vector<std::uint32_t> trigrams;
+    if( text.size() < 3 ) return trigrams;
+
+    trigrams.reserve( text.size() - 2 );
+    for( std::size_t i = 0; i + 2 < text.size(); ++i )
+    {
+      trigrams.push_back(   std::uint32_t{ static_cast<unsigned char>( text[i]     ) } << 16
+                          | std::uint32_t{ static_cast<unsigned char>( text[i + 1] ) } <<  8
+                          | std::uint32_t{ static_cast<unsigned char>( text[i + 2] ) } );
+    }
+
+    std::sort( trigrams.begin(), trigrams.end() );
+    trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+    return trigrams;
+  }
+}    // namespace
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  void TrigramIndex::insert( RowId row, const JobInfo & job )
+  {
+    for( std::size_t field = 0; field != JobFieldCount; ++field )
+    {
+      // trigrams are distinct, so each row is posted to a list at most once
+      for( auto trigram : trigramsOf( fieldValue( job, static_cast<JobField>( field ) ) ) ) _postings[field][trigram].push_back( row );
+    }
+  }
+
+
+
+
+  std::optional<PostingList> TrigramIndex::candidates( JobField field, const std::string & criterion ) const
+  {
+    const auto & postings = _postings[static_cast<std::size_t>( field )];
+    const auto   trigrams = trigramsOf( criterion );
+
+    if( trigrams.empty() ) return std::nullopt;
+
+
+    // Intersect the shortest lists first so the working set shrinks as fast as possible
+    std::vector<PostingView> lists;
+    lists.reserve( trigrams.size() );
+    for( auto trigram : trigrams )
+    {
+      auto list = postings.find( trigram );
+      if( list == postings.end() ) return PostingList{};    // no row contains this trigram, so none can contain the criterion
+      lists.push_back( list->second );
+    }
+    std::sort( lists.begin(), lists.end(), []( PostingView lhs, PostingView rhs ) noexcept { return lhs.size() < rhs.size(); } );
+
+
+    PostingList result( lists.front().begin(), lists.front().end() );
+    for( std::size_t i = 1; i != lists.size() && !result.empty(); ++i ) result = intersect( result, lists[i] );
+
+    return result;
+  }
+
+
+
+
+  // A row containing the criterion contains its rarest trigram, so that trigram's list bounds the candidates
+  std::optional<std::size_t> TrigramIndex::estimate( JobField field, const std::string & criterion ) const
+  {
+    const auto & postings = _postings[static_cast<std::size_t>( field )];
+    const auto   trigrams = trigramsOf( criterion );
+
+    if( trigrams.empty() ) return std::nullopt;
+
+    std::size_t rarest = std::numeric_limits<std::size_t>::max();
+    for( auto trigram : trigrams )
+    {
+      auto list = postings.find( trigram );
+      rarest = std::min( rarest, list == postings.end() ? 0 : list->second.size() );
+    }
+    return rarest;
+  }
+
+
+
+
+  void TrigramIndex::save( SnapshotWriter & image ) const
+  {
+    for( const auto & postings : _postings )
+    {
+      image.write( std::uint64_t{ postings.size() } );
+      for( const auto & [trigram, rows] : postings ) { image.write( std::uint64_t{ trigram } ); image.write( rows ); }
+    }
+  }
+
+
+
+
+  void TrigramIndex::load( SnapshotReader & image )
+  {
+    for( auto & postings : _postings )
+    {
+      postings.clear();
+      auto trigrams = image.readInteger();
+      postings.reserve( trigrams );
+
+      for( ; trigrams != 0; --trigrams )
+      {
+        auto trigram = static_cast<Trigram>( image.readInteger() );
+        postings.emplace( trigram, image.viewArray<RowId>() );
+      }
+    }
+  }
+}    // namespace TechnicalServices::Persistence
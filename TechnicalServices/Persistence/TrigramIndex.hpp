@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>    // uint32_t
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "TechnicalServices/Persistence/MappedArray.hpp"
+#include "TechnicalServices/Persistence/PersistenceHandler.hpp"
+#include "TechnicalServices/Persistence/SearchIndex.hpp"
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Trigram Index
+  **   Maps every three character sequence of a job's name, location and category to the ascending list of rows containing it.
+  **   A row can only contain a criterion if it contains every trigram of the criterion, so intersecting the criterion's trigram
+  **   posting lists (shortest first) yields a small candidate set for arbitrary substrings, including those that start or end in
+  **   the middle of a word.  Criteria shorter than a trigram can't be narrowed.
+  ******************************************************************************/
+  class TrigramIndex : public TechnicalServices::Persistence::SearchIndex
+  {
+    public:
+      // Operations
+      void insert( RowId row, const JobInfo & job ) override;
+
+      // Returns nothing if the criterion is shorter than three characters
+      std::optional<PostingList> candidates( JobField field, const std::string & criterion ) const override;
+      std::optional<std::size_t> estimate  ( JobField field, const std::string & criterion ) const override;
+
+      void save( SnapshotWriter & image ) const override;
+      void load( SnapshotReader & image )       override;
+
+
+      // Destructor
+      ~TrigramIndex() noexcept override = default;
+
+    private:
+      using Trigram  = std::uint32_t;                                    // three bytes packed into the low 24 bits
+      using Postings = std::unordered_map<Trigram, MappedArray<RowId>>;
+
+      std::array<Postings, JobFieldCount> _postings;
+  };    // class TrigramIndex
+}    // namespace TechnicalServices::Persistence
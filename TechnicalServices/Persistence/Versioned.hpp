@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>    // min()
+#include <array>
+#include <atomic>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <limits>       // numeric_limits
+#include <memory>       // unique_ptr, make_unique()
+#include <mutex>        // mutex, lock_guard
+#include <thread>       // this_thread::yield()
+#include <utility>      // move()
+#include <vector>
+
+
+
+
+namespace TechnicalServices::Persistence
+{
+  /*****************************************************************************
+  ** Versioned
+  **   Multi-version concurrency control for a value:  a reader takes a snapshot of the current version without locking and sees
+  **   that version, unchanged, for as long as it holds the snapshot.  A writer copies the current version, changes the copy and
+  **   publishes it as the next.  Writers take turns, but readers never wait for them, nor they for readers.  Values whose copies
+  **   share structure (see CopyOnWriteVector and CopyOnWriteMap) make each write cost only what it changes.
+  **
+  **   Superseded versions are reclaimed by epoch:  a reader announces the epoch it starts reading in, each publication advances the
+  **   epoch, and a superseded version is deleted once no reader that started before it was superseded is still reading.  Each reader
+  **   writes only its own announcement slot, so readers on different cores don't contend over a shared reference count.
+  **
+  **   There are Readers (128) slots, so at most that many snapshots are held at once.  A read() finding every slot taken waits,
+  **   yielding its core after each sweep of the slots, until a snapshot is released.  Snapshots are meant to be held only for the
+  **   length of one query, so more threads than slots wait briefly rather than fail, but a thread must never take a second snapshot
+  **   while still holding one, as with every slot held that way no snapshot would ever be released.
+  ******************************************************************************/
+  template<typename T>
+  class Versioned
+  {
+    private:
+      static constexpr std::uint64_t Idle = std::numeric_limits<std::uint64_t>::max();
+
+      // One cache line per slot, so announcing doesn't disturb neighbouring readers
+      struct alignas( 64 ) Reader
+      {
+        std::atomic<std::uint64_t> epoch = Idle;
+      };
+
+    public:
+      // A consistent, read only view of one version, released when the snapshot goes out of scope
+      class Snapshot
+      {
+        public:
+          Snapshot( Snapshot && other ) noexcept : _version( other._version ), _reader( other._reader ) { other._reader = nullptr; }
+          Snapshot & operator=( Snapshot && ) = delete;
+         ~Snapshot() noexcept { if( _reader != nullptr ) _reader->epoch.store( Idle, std::memory_order_release ); }
+
+          const T & operator* () const { return *_version; }
+          const T * operator->() const { return  _version; }
+
+        private:
+          friend class Versioned;
+          Snapshot( const T * version, Reader * reader ) : _version( version ), _reader( reader ) {}
+
+          const T * _version;
+          Reader *  _reader;
+      };
+
+
+      // Constructors
+      explicit Versioned( T initial = T{} ) : _current( new T( std::move( initial ) ) ) {}
+      Versioned( const Versioned & ) = delete;
+      Versioned & operator=( const Versioned & ) = delete;
+
+
+      // Operations
+      Snapshot read() const;
+
+      // Publishes change( copy of the current version ) as the next version, unless change returns false.  Concurrent updates
+      // take turns, each seeing the one before.
+      template<typename Change>
+      bool update( Change && change );
+
+
+      // Destructor
+      ~Versioned() noexcept { delete _current.load(); }    // no reader may still hold a snapshot
+
+    private:
+      void reclaim();
+
+      // Up to this many snapshots at once, more wait for a slot to come free (see read())
+      static constexpr std::size_t Readers = 128;
+
+      inline static std::atomic<std::size_t> _threads = 0;    // numbers threads, so each starts looking for a slot at a different one
+
+      mutable std::array<Reader, Readers>                            _readers;
+      std::atomic<std::uint64_t>                                     _epoch = 0;
+      std::atomic<const T *>                                         _current;
+      std::mutex                                                     _writer;
+      std::vector<std::pair<std::uint64_t, std::unique_ptr<const T>>> _retired;    // superseded versions and the epoch they were superseded in
+  };    // class Versioned
+
+
+
+
+
+
+
+
+  /*****************************************************************************
+  ** Template implementation
+  ******************************************************************************/
+  template<typename T>
+  typename Versioned<T>::Snapshot Versioned<T>::read() const
+  {
+    thread_local const std::size_t home = _threads++;
+
+    // The epoch is announced before the version is loaded, so any writer that supersedes the version loaded sees the announcement
+    for( auto slot = home;; ++slot )
+    {
+      auto & reader = _readers[slot % Readers];
+      auto   idle   = Idle;
+      if( reader.epoch.load( std::memory_order_relaxed ) == Idle && reader.epoch.compare_exchange_strong( idle, _epoch.load() ) )
+        return Snapshot( _current.load(), &reader );
+
+      // Every slot is held, so let the holders run rather than spin against them
+      if( ( slot + 1 - home ) % Readers == 0 ) std::this_thread::yield();
+    }
+  }
+
+
+
+
+  template<typename T>
+  template<typename Change>
+  bool Versioned<T>::update( Change && change )
+  {
+    std::lock_guard lock( _writer );
+
+    auto next = std::make_unique<T>( *_current.load() );
+    if( !change( *next ) ) return false;
+
+    auto superseded = std::unique_ptr<const T>( _current.exchange( next.release() ) );
+    _retired.emplace_back( _epoch.fetch_add( 1 ), std::move( superseded ) );
+    reclaim();
+    return true;
+  }
+
+
+
+
+  template<typename T>
+  void Versioned<T>::reclaim()
+  {
+    // A reader that started in an epoch after a version was superseded can only have loaded a later version
+    auto oldest = Idle;
+    for( const auto & reader : _readers ) oldest = std::min( oldest, reader.epoch.load() );
+
+    std::erase_if( _retired, [&]( const auto & retired ) noexcept { return retired.first < oldest; } );
+  }
+}    // namespace TechnicalServices::Persistence
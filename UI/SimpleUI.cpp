@@ -253,17 +253,139 @@ namespace UI
 
         if (nextPage == "SearchResult" && selectedRole == "JobSeeker") {    // Search job
 
-            std::cout << "\n< Search Job >\n Enter criteria (to skip, enter 0): \n";
+            std::cout << "\n< Search Job >\n Enter a query, e.g. category:Barista AND salary>=20 AND NOT type:\"Part time\" (to search by criteria instead, enter 0): \n";
 
-            std::cout << " Enter keyword:  ";  std::cin >> std::ws;  std::getline(std::cin, parameters[0]);
+            std::cout << " For jobs like those applied for, enter *; for new jobs matching your saved queries, enter !; to forget a saved query, enter -\n";
 
-            std::cout << " Enter location: ";  std::cin >> std::ws;  std::getline(std::cin, parameters[1]);
+            std::string query;
 
-            std::cout << " Enter category:   ";  std::cin >> std::ws;  std::getline(std::cin, parameters[2]);
+            std::cout << " Enter query:    ";  std::cin >> std::ws;  std::getline(std::cin, query);
 
 
 
-            auto results = sessionControl->executeCommand("Search Job", parameters);
+            if (query == "*" || query == "!") {
+
+                auto results = sessionControl->executeCommand(query == "*" ? "Recommended Jobs" : "Job Alerts", {});
+
+                std::string res = std::any_cast<const std::string&>(results);
+
+                if (res.find("[") != std::string::npos) std::cout << res << '\n';   // if no jobs, do again
+
+                else nextPage = "ViewInfo";
+
+                continue;
+
+            }
+
+
+
+            if (query == "-") {
+
+                auto searches = sessionControl->executeCommand("Saved Searches", {});
+
+                std::string res = std::any_cast<const std::string&>(searches);
+
+                std::cout << res << '\n';
+
+                if (res.find("[") != std::string::npos) continue;   // none saved
+
+
+
+                std::string id;
+
+                std::cout << " Enter number of the query to forget (to keep them all, enter -): ";  std::cin >> std::ws;  std::getline(std::cin, id);
+
+                if (id != "-") std::cout << std::any_cast<const std::string&>(sessionControl->executeCommand("Forget Search", { id })) << '\n';
+
+                continue;
+
+            }
+
+
+
+            if (query != "0") {
+
+                auto results = sessionControl->executeCommand("Query Jobs", { query });
+
+                std::string res = std::any_cast<const std::string&>(results);
+
+                bool found = res.find("[") == std::string::npos;
+
+                if (!found) std::cout << res << '\n';   // if error found, do again
+
+                if (found || res.find("[Warning]") != std::string::npos) {    // a query finding nothing yet may still be worth saving
+
+                    char response;
+
+                    do {
+
+                        std::cout << " Alert you to new jobs matching this query? (Y/N): ";
+
+                        std::cin >> response;
+
+                        response = static_cast<char>(std::toupper(static_cast<unsigned char>(response)));
+
+                    } while (response != 'Y' && response != 'N');
+
+                    if (response == 'Y') std::cout << std::any_cast<const std::string&>(sessionControl->executeCommand("Save Search", { query })) << '\n';
+
+                }
+
+                if (found) nextPage = "ViewInfo";
+
+                continue;
+
+            }
+
+
+
+            // Entering the start of a word followed by ? lists the values having such a word, then asks again
+
+            auto askCriterion = [&](const std::string& prompt, const std::string& criterion) {
+
+                std::string entry;
+
+                while (true) {
+
+                    std::cout << prompt;  std::cin >> std::ws;  std::getline(std::cin, entry);
+
+                    if (entry.empty() || entry.back() != '?') return entry;
+
+                    entry.pop_back();
+
+                    auto suggestions = sessionControl->executeCommand("Suggest", { criterion, entry });
+
+                    std::cout << std::any_cast<const std::string&>(suggestions) << '\n';
+
+                }
+
+            };
+
+
+
+            std::cout << " Enter criteria (to skip, enter 0; to list values, enter the start of a word followed by ?): \n";
+
+            parameters[0] = askCriterion(" Enter keyword:  ", "keyword");
+
+            parameters[1] = askCriterion(" Enter location: ", "location");
+
+            parameters[2] = askCriterion(" Enter category:   ", "category");
+
+            std::string best;
+
+            std::cout << " Enter number of best matches (blank or 0 for all): ";  std::getline(std::cin, best);    // blank lines aren't skipped, a blank is the default
+
+            std::string miles;
+
+            std::cout << " Enter miles from location (blank or 0 for the location itself): ";  std::getline(std::cin, miles);
+
+            std::string typos;
+
+            std::cout << " Enter typos to allow per word, 1 or 2 (blank or 0 for exact): ";  std::getline(std::cin, typos);
+
+
+
+            auto results = sessionControl->executeCommand("Search Job", { parameters[0], parameters[1], parameters[2], best, miles, typos });
 
             //if (results.has_value()) _logger << "Received reply: \"" + std::any_cast<const std::string&>(results);
 
@@ -285,7 +407,7 @@ namespace UI
 
             std::cout << "\n< Job Info >\n";
 
-            std::cout << "Select job (enter 0 for options, enter -1 to go back): \n";
+            std::cout << "Select job (enter 0 for options, enter + for more results, enter -1 to go back): \n";
 
             std::cout << " Enter Number:  ";  std::cin >> std::ws;  std::getline(std::cin, parameters[0]);
 
@@ -297,6 +419,16 @@ namespace UI
 
             }
 
+            else if (parameters[0] == "+") {     // next page of results
+
+                auto results = sessionControl->executeCommand("Next Page", parameters);
+
+                std::string res = std::any_cast<const std::string&>(results);
+
+                if (res.find("[") != std::string::npos) std::cout << res << '\n';
+
+            }
+
             else if (parameters[0] == "-1") {     // go to previous page
 
                 nextPage = "SearchResult";  
@@ -535,6 +667,100 @@ namespace UI
 
 
 
+        else if (selectedCommand == "View Applicants")
+
+        {
+
+            std::cout << " Enter job id:                  ";  std::cin >> std::ws;  std::getline(std::cin, parameters[0]);
+
+            std::cout << " Enter status (0 for any):      ";  std::cin >> std::ws;  std::getline(std::cin, parameters[1]);
+
+            std::cout << " Enter page number:             ";  std::cin >> std::ws;  std::getline(std::cin, parameters[2]);
+
+
+
+            auto results = sessionControl->executeCommand(selectedCommand, parameters);
+
+        }
+
+
+
+        else if (selectedCommand == "Update Application Status")
+
+        {
+
+            std::cout << " Enter job id:                  ";  std::cin >> std::ws;  std::getline(std::cin, parameters[0]);
+
+            std::cout << " Enter applicant's user name:   ";  std::cin >> std::ws;  std::getline(std::cin, parameters[1]);
+
+            std::cout << " Enter new status:              ";  std::cin >> std::ws;  std::getline(std::cin, parameters[2]);
+
+
+
+            auto results = sessionControl->executeCommand(selectedCommand, parameters);
+
+            std::cout << std::any_cast<const std::string&>(results) << '\n';
+
+        }
+
+
+
+        else if (selectedCommand == "Find Duplicates")
+
+        {
+
+            std::string jobId;
+
+            std::cout << " Enter job id:                  ";  std::cin >> std::ws;  std::getline(std::cin, jobId);
+
+
+
+            auto results = sessionControl->executeCommand(selectedCommand, { jobId });
+
+            std::cout << std::any_cast<const std::string&>(results) << '\n';
+
+        }
+
+
+
+        else if (selectedCommand == "Explain Query")
+
+        {
+
+            std::string query;
+
+            std::cout << " Enter query:                   ";  std::cin >> std::ws;  std::getline(std::cin, query);
+
+
+
+            auto results = sessionControl->executeCommand(selectedCommand, { query });
+
+            std::cout << std::any_cast<const std::string&>(results) << '\n';
+
+        }
+
+
+
+        else if (selectedCommand == "Suggest")
+
+        {
+
+            std::string criterion, prefix;
+
+            std::cout << " Enter keyword, location or category: ";  std::cin >> std::ws;  std::getline(std::cin, criterion);
+
+            std::cout << " Enter the start of a word:           ";  std::cin >> std::ws;  std::getline(std::cin, prefix);
+
+
+
+            auto results = sessionControl->executeCommand(selectedCommand, { criterion, prefix });
+
+            std::cout << std::any_cast<const std::string&>(results) << '\n';
+
+        }
+
+
+
         else if (selectedCommand == "Another command") /* ... */ {}
 
 